@@ -205,6 +205,20 @@ private:
      */
     void setSensorNoise(const std::string& mcu_name, const std::string& sensor_id, bool is_noisy);
 
+    /**
+     * @brief Sets the log level of MCU Simulator logger(s)
+     * @param logger_name Logger name, or "all" for every logger
+     * @param level New level (DEBUG, INFO, WARNING, ERROR), empty string to only list levels
+     * @note The change takes effect immediately without restarting the simulator
+     */
+    void setMCULogLevel(const std::string& logger_name, const std::string& level);
+
+    /**
+     * @brief Dumps the MCU Simulator flight recorder to a file
+     * @param reason Optional reason used in the dump file name
+     */
+    void dumpMCUFlightRecorder(const std::string& reason);
+
     // Fan Control System RPC methods
     /**
      * @brief Gets the status of fan(s)
@@ -239,9 +253,10 @@ private:
     /**
      * @brief Simulates a bad/faulty fan condition
      * @param fan_name Name of the fan to make faulty
+     * @param failure_mode Simulated failure ("Stall", "Degraded", "NoSignal"), empty for the model default
      * @note This method simulates fan hardware faults for testing alarm systems
      */
-    void makeFanBad(const std::string& fan_name);
+    void makeFanBad(const std::string& fan_name, const std::string& failure_mode = "");
 
     /**
      * @brief Restores a fan to good working condition
@@ -250,6 +265,19 @@ private:
      */
     void makeFanGood(const std::string& fan_name);
 
+    /**
+     * @brief Gets the recent tachometer readings of a fan
+     * @param fan_name Name of the fan to query
+     * @param max_samples Maximum number of samples to show
+     */
+    void getFanRpmHistory(const std::string& fan_name, int32_t max_samples);
+
+    /**
+     * @brief Gets the noise exposure and dose of one or all fans and of all fans combined
+     * @param fan_name Name of the fan to query, empty for all fans
+     */
+    void getNoiseExposure(const std::string& fan_name);
+
     /**
      * @brief Gets noise level information for a fan
      * @param fan_name Name of the fan to query
@@ -328,6 +356,40 @@ private:
      */
     void getAlarmStatistics(const std::string& alarm_name = "", int32_t time_window_hours = 24);
 
+    /**
+     * @brief Gets alarm action executor queue metrics
+     * @note Shows queue depth, coalesced/dropped actions and timeouts
+     */
+    void getActionQueueStats();
+
+    /**
+     * @brief Prints alarm events as they happen
+     * @param count Number of events to print before returning
+     * @param alarm_name Optional alarm name filter, empty string for all alarms
+     * @note Returns early after 60 seconds without events
+     */
+    void watchAlarms(int32_t count = 10, const std::string& alarm_name = "");
+
+    /**
+     * @brief Gets the incidents grouped by the alarm correlation rules
+     * @param max_incidents Maximum number of incidents to show, 0 for all
+     */
+    void getIncidents(int32_t max_incidents = 0);
+
+    /**
+     * @brief Sets the log level of Fan Control System logger(s)
+     * @param logger_name Logger name, "LogFile" for the log file filter, or "all" for every logger
+     * @param level New level (DEBUG, INFO, WARNING, ERROR), empty string to only list levels
+     * @note The change takes effect immediately without restarting the system
+     */
+    void setFanLogLevel(const std::string& logger_name, const std::string& level);
+
+    /**
+     * @brief Dumps the Fan Control System flight recorder to a file
+     * @param reason Optional reason used in the dump file name
+     */
+    void dumpFanFlightRecorder(const std::string& reason);
+
     /**
      * @brief Converts alarm severity enum to string representation
      * @param severity The severity enum value to convert
@@ -1,21 +1,29 @@
 #pragma once
 
+#include "common/alarm_message.hpp"
 #include "common/mqtt_client.hpp"
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <memory>
-#include <nlohmann/json.hpp>
+#include <mutex>
+#include <unordered_map>
 
 namespace common {
 
 /**
- * @enum AlarmSeverity
- * @brief Defines the severity levels for alarms
+ * @struct AlarmDebounce
+ * @brief Source-side debouncing settings for alarms
+ *
+ * A raise is published when an alarm becomes active or changes severity; while
+ * it stays active with the same severity, repeated raises are only published
+ * as a refresh every `reraise_interval_sec`. After a clear, a new raise of the
+ * same alarm id is held down for `hold_down_ms` so that flapping conditions do
+ * not produce a raise/clear pair on every check.
  */
-enum class AlarmSeverity {
-    LOW,        ///< Low severity alarm - minor issues that don't require immediate attention
-    MEDIUM,     ///< Medium severity alarm - issues that should be addressed soon
-    HIGH,       ///< High severity alarm - serious issues requiring prompt attention
-    CRITICAL    ///< Critical severity alarm - system-threatening issues requiring immediate action
+struct AlarmDebounce {
+    int hold_down_ms = 5000;           ///< Minimum time between a published clear and the next raise
+    int reraise_interval_sec = 60;     ///< Refresh interval for an unchanged active alarm; 0 disables refreshes
 };
 
 /**
@@ -24,6 +32,9 @@ enum class AlarmSeverity {
  * 
  * This class handles the raising and clearing of alarms, with different severity levels.
  * Alarms are published to MQTT topics for monitoring and notification purposes.
+ * Each condition is tracked by a stable alarm id (e.g. "sensor3.erratic"), not by
+ * its free-text message, and only state transitions and periodic refreshes are
+ * published (see AlarmDebounce).
  */
 class Alarm {
 public:
@@ -33,53 +44,102 @@ public:
      * @param mqtt_client Shared pointer to MQTT client for publishing alarms
      */
     Alarm(const std::string& name, std::shared_ptr<MQTTClient> mqtt_client);
-    
+
     /**
-     * @brief Raises an alarm with the specified severity and message
+     * @brief Raises the alarm condition identified by alarm_id
+     * @param alarm_id Stable id of the condition within this alarm system
+     * @param severity The severity level of the alarm
+     * @param message Description of the alarm condition
+     * @note Safe to call on every check; unchanged conditions are not republished
+     */
+    void raise(const std::string& alarm_id, AlarmSeverity severity, const std::string& message);
+
+    /**
+     * @brief Clears the alarm condition identified by alarm_id
+     * @param alarm_id Stable id of the condition within this alarm system
+     * @param message Description of why the alarm is being cleared
+     * @note Does nothing if the condition is not active
+     */
+    void clear(const std::string& alarm_id, const std::string& message);
+
+    /**
+     * @brief Raises an alarm under the alarm system's default id
      * @param severity The severity level of the alarm
      * @param message Description of the alarm condition
      */
     void raise(AlarmSeverity severity, const std::string& message);
 
     /**
-     * @brief Clears the current alarm
+     * @brief Clears the alarm under the alarm system's default id
      * @param message Description of why the alarm is being cleared
      */
     void clear(const std::string& message);
 
     /**
-     * @brief Checks if there is an active alarm
+     * @brief Replaces the debouncing settings
+     * @param debounce New hold-down and re-raise intervals
+     */
+    void setDebounce(const AlarmDebounce& debounce);
+
+    /**
+     * @brief Checks if any alarm condition is active
      * @return true if an alarm is active, false otherwise
      */
-    bool isActive() const { return active_; }
+    bool isActive() const;
+
+    /**
+     * @brief Checks if a specific alarm condition is active
+     * @param alarm_id Stable id of the condition
+     * @return true if the condition is active, false otherwise
+     */
+    bool isActive(const std::string& alarm_id) const;
+
+    /**
+     * @brief Gets the highest severity among the active alarm conditions
+     * @return The current alarm severity level (INFO if none is active)
+     */
+    AlarmSeverity getCurrentSeverity() const;
 
     /**
-     * @brief Gets the severity of the current alarm
-     * @return The current alarm severity level
+     * @brief Gets the number of raises that were not published because nothing changed
+     * @return Suppressed raise count since construction
      */
-    AlarmSeverity getCurrentSeverity() const { return current_severity_; }
+    uint64_t getSuppressedCount() const;
 
 private:
     /**
-     * @brief Formats an alarm message for MQTT publishing
-     * @param severity The severity level of the alarm
-     * @param message The alarm message
-     * @param is_clear Whether this is a clear message (true) or raise message (false)
-     * @return Formatted JSON string containing the alarm message
+     * @struct State
+     * @brief Tracked state of one alarm condition
      */
-    std::string formatAlarmMessage(AlarmSeverity severity, const std::string& message, bool is_clear = false);
+    struct State {
+        bool active = false;                                    ///< Whether the condition is active
+        bool published = false;                                 ///< Whether the current raise was published
+        bool ever_cleared = false;                              ///< Whether a clear was ever published
+        AlarmSeverity severity = AlarmSeverity::INFO;           ///< Current severity
+        std::chrono::steady_clock::time_point last_publish;     ///< Time of the last published raise
+        std::chrono::steady_clock::time_point last_clear;       ///< Time of the last published clear
+        uint32_t suppressed = 0;                                ///< Raises suppressed since the last publish
+    };
 
     /**
-     * @brief Gets the current timestamp in ISO 8601 format
-     * @return Timestamp string
+     * @brief Encodes an alarm message for MQTT publishing
+     * @param alarm_id Stable id of the condition
+     * @param severity The severity level of the alarm
+     * @param message The alarm message
+     * @param is_clear Whether this is a clear message (true) or raise message (false)
+     * @param suppressed Number of raises suppressed since the previous publish
+     * @return Encoded AlarmMessage
      */
-    std::string getTimestamp();
+    std::string formatAlarmMessage(const std::string& alarm_id, AlarmSeverity severity, const std::string& message,
+                                   bool is_clear = false, uint32_t suppressed = 0);
     
     std::string name_;                                          ///< Name of the alarm system
     std::shared_ptr<MQTTClient> mqtt_client_;                   ///< MQTT client for publishing alarms
     std::string topic_prefix_;                                  ///< MQTT topic prefix for alarm messages
-    bool active_;                                               ///< Whether an alarm is currently active
-    AlarmSeverity current_severity_;                           ///< Severity of the current alarm
+    AlarmDebounce debounce_;                                    ///< Hold-down and re-raise intervals
+    mutable std::mutex mutex_;                                  ///< Guards the alarm states
+    std::unordered_map<std::string, State> states_;             ///< Alarm id -> tracked state
+    uint64_t suppressed_total_ = 0;                             ///< Raises suppressed since construction
 };
 
 } // namespace common 
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace common {
+
+/**
+ * @enum AlarmSeverity
+ * @brief Severity levels shared by alarm producers and the alarm manager
+ *
+ * The numeric values are part of the alarm wire format (see AlarmMessage) and
+ * select the `Alarms.SeverityActions` entry applied by the alarm manager.
+ */
+enum class AlarmSeverity : uint8_t {
+    INFO = 0,       ///< Informational condition that doesn't require action
+    WARNING = 1,    ///< Condition that should be addressed soon
+    ERROR = 2,      ///< Serious condition requiring prompt attention
+    CRITICAL = 3    ///< System-threatening condition requiring immediate action
+};
+
+/**
+ * @brief Gets the name of a severity as used in the configuration
+ * @param severity Severity level
+ * @return "INFO", "WARNING", "ERROR" or "CRITICAL"
+ */
+const char* alarmSeverityName(AlarmSeverity severity);
+
+/**
+ * @struct AlarmMessage
+ * @brief Typed alarm event published on `alarms/{source}/{raise|clear}`
+ *
+ * Encoded as a 24-byte little-endian header followed by the source, alarm id
+ * and message bytes:
+ *
+ * | Offset | Size | Field                                   |
+ * |--------|------|-----------------------------------------|
+ * | 0      | 1    | Format version (1)                      |
+ * | 1      | 1    | State (0 raised, 1 cleared)             |
+ * | 2      | 1    | Severity                                |
+ * | 3      | 1    | Reserved (0)                            |
+ * | 4      | 4    | Suppressed raises since previous publish|
+ * | 8      | 8    | Event time, nanoseconds since the epoch |
+ * | 16     | 2    | Source length                           |
+ * | 18     | 2    | Alarm id length                         |
+ * | 20     | 2    | Message length                          |
+ * | 22     | 2    | Reserved (0)                            |
+ */
+struct AlarmMessage {
+    /**
+     * @enum State
+     * @brief Alarm state carried by the message
+     */
+    enum class State : uint8_t {
+        RAISED = 0,     ///< Alarm raised or refreshed
+        CLEARED = 1     ///< Alarm cleared by its source
+    };
+
+    static const size_t kHeaderSize = 24;                 ///< Encoded header size in bytes
+    static const size_t kMaxFieldSize = 0xFFFF;           ///< Longer strings are truncated when encoding
+
+    State state = State::RAISED;                          ///< Raised or cleared
+    AlarmSeverity severity = AlarmSeverity::INFO;         ///< Severity level
+    uint32_t suppressed = 0;                              ///< Raises suppressed since the previous publish
+    int64_t epoch_ns = 0;                                 ///< Event time in nanoseconds since the epoch
+    std::string source;                                   ///< Alarm system name (e.g. "MCU001")
+    std::string alarm_id;                                 ///< Stable id of the condition within the source
+    std::string message;                                  ///< Description of the condition
+
+    /**
+     * @brief Encodes the message into its binary wire format
+     * @return Encoded bytes
+     */
+    std::string encode() const;
+
+    /**
+     * @brief Decodes a message from its binary wire format
+     * @param data Encoded bytes
+     * @param size Number of bytes
+     * @param[out] out Decoded message
+     * @return true if the bytes are a complete, valid message, false otherwise
+     */
+    static bool decode(const char* data, size_t size, AlarmMessage& out);
+};
+
+} // namespace common
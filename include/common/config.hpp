@@ -3,6 +3,8 @@
 #include <string>
 #include <yaml-cpp/yaml.h>
 #include "common/mqtt_client.hpp"
+#include "common/logger.hpp"
+#include "common/alarm.hpp"
 #include <cstdint>
 #include <unordered_map>
 
@@ -101,6 +103,22 @@ public:
      */
     const RPCServerConfig* getRPCServerConfig(const std::string& server_name) const;
 
+    /**
+     * @brief Gets the log rate limit for a component
+     * @param component Component name (e.g. "MCUSimulator", "TempMonitor")
+     * @return Rate limit from AppLogLevel.RateLimit.<component>, falling back to
+     *         AppLogLevel.RateLimit.Default; disabled if neither is configured
+     */
+    LogRateLimit getLogRateLimit(const std::string& component) const;
+
+    /**
+     * @brief Gets the alarm debouncing settings for an alarm system
+     * @param component Alarm system name (e.g. "MCU1", "TempMonitor")
+     * @return Settings from AlarmDebounce.<component>, falling back to
+     *         AlarmDebounce.Default and then to the AlarmDebounce defaults
+     */
+    AlarmDebounce getAlarmDebounce(const std::string& component) const;
+
 private:
     /**
      * @brief Private constructor to enforce singleton pattern
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "common/logger.hpp"
+#include "common/alarm.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <yaml-cpp/yaml.h>
+
+namespace common {
+
+/**
+ * @class FlightRecorder
+ * @brief Per-process in-memory ring of recent log and alarm records
+ *
+ * Loggers and alarms write a fixed-size record here before publishing to MQTT,
+ * so the last moments before a crash or broker outage survive locally. Writers
+ * claim a slot with one atomic increment and copy into preallocated storage;
+ * nothing is allocated or locked on the recording path. The ring is dumped to
+ * a text file on SIGSEGV/SIGABRT/SIGTERM, on CRITICAL alarms, or on request.
+ */
+class FlightRecorder {
+public:
+    /**
+     * @enum RecordKind
+     * @brief Type of a flight recorder record
+     */
+    enum class RecordKind : uint8_t {
+        LOG,            ///< Log message
+        ALARM_RAISED,   ///< Alarm raised
+        ALARM_CLEARED   ///< Alarm cleared
+    };
+
+    /**
+     * @brief Gets the process-wide flight recorder
+     * @return Reference to the FlightRecorder instance
+     */
+    static FlightRecorder& getInstance();
+
+    /**
+     * @brief Allocates the ring and reads settings from the FlightRecorder config section
+     * @param process_name Name used in dump file names
+     * @param config Root configuration node
+     * @note Call once at startup, before other threads start logging
+     */
+    void configure(const std::string& process_name, const YAML::Node& config);
+
+    /**
+     * @brief Records a log message
+     * @param level Log level of the message
+     * @param source Logger name
+     * @param message Log message (truncated to the record size)
+     */
+    void recordLog(LogLevel level, const std::string& source, const std::string& message);
+
+    /**
+     * @brief Checks whether log messages of a level are recorded
+     * @param level Log level
+     * @return true if the recorder is configured and the level is at or above its minimum
+     * @note Inline and lock-free, so callers can skip building records that would be dropped
+     */
+    bool recordsLog(LogLevel level) const { return static_cast<uint8_t>(level) >= min_level_; }
+
+    /**
+     * @brief Records an alarm raise or clear
+     * @param severity Alarm severity
+     * @param source Alarm source name
+     * @param message Alarm message (truncated to the record size)
+     * @param cleared true for a clear, false for a raise
+     */
+    void recordAlarm(AlarmSeverity severity, const std::string& source, const std::string& message, bool cleared);
+
+    /**
+     * @brief Writes the ring contents to a new dump file
+     * @param reason Short reason used in the file name and header (e.g. "rpc", "critical_alarm")
+     * @param force Ignore the minimum interval between dumps
+     * @param[out] path Path of the written file, if not null
+     * @param[out] records Number of records written, if not null
+     * @return true if a dump file was written, false if disabled, throttled or on I/O error
+     */
+    bool dump(const char* reason, bool force, std::string* path = nullptr, size_t* records = nullptr);
+
+    /**
+     * @brief Installs SIGSEGV and SIGABRT handlers that dump the ring and re-raise the signal
+     * @note The alternate signal stack covers only the calling thread
+     */
+    void installCrashHandlers();
+
+    /**
+     * @brief Writes the ring contents from a signal handler
+     * @param reason Short reason used in the file name and header
+     * @note Only uses async-signal-safe calls; never throttled
+     */
+    void dumpFromSignal(const char* reason);
+
+    /**
+     * @brief Gets the number of record slots
+     * @return Ring capacity, 0 if not configured
+     */
+    size_t capacity() const { return capacity_; }
+
+private:
+    static constexpr size_t kSourceSize = 32;    ///< Bytes reserved for the source name
+    static constexpr size_t kMessageSize = 200;  ///< Bytes reserved for the message
+
+    /**
+     * @struct Record
+     * @brief One fixed-size ring slot, guarded by a per-slot sequence number
+     */
+    struct Record {
+        std::atomic<uint64_t> sequence{0};  ///< 0 while empty or being written, else ticket + 1
+        int64_t epoch_ms;                   ///< Wall clock time in milliseconds since the epoch
+        RecordKind kind;                    ///< Record type
+        uint8_t level;                      ///< Log level or alarm severity
+        char source[kSourceSize];           ///< Null-terminated source name
+        char message[kMessageSize];         ///< Null-terminated message
+    };
+
+    FlightRecorder() = default;
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Claims the next slot and copies a record into it
+     */
+    void write(RecordKind kind, uint8_t level, const std::string& source, const std::string& message);
+
+    /**
+     * @brief Writes the ring to a file using only async-signal-safe calls
+     * @param reason Reason string
+     * @param[out] path_out Buffer receiving the file path
+     * @param path_len Size of path_out
+     * @return Number of records written, or -1 on failure
+     */
+    long writeDump(const char* reason, char* path_out, size_t path_len);
+
+    std::unique_ptr<Record[]> records_;             ///< Preallocated record slots
+    size_t capacity_ = 0;                           ///< Number of slots (power of two)
+    std::atomic<uint64_t> next_ticket_{0};          ///< Next ticket handed to a writer
+    uint8_t min_level_ = UINT8_MAX;                 ///< Minimum log level recorded, UINT8_MAX while not configured
+    char path_prefix_[256] = {};                    ///< "<dir>/<process>_flight_" used for dump files
+    int min_dump_interval_sec_ = 30;                ///< Minimum seconds between non-forced dumps
+    std::atomic<int64_t> last_dump_sec_{0};         ///< Time of the last dump (seconds since epoch)
+    std::atomic<bool> dumping_{false};              ///< Set while a dump is being written
+    std::atomic<uint32_t> dump_count_{0};           ///< Dumps written, used to keep file names unique
+};
+
+} // namespace common
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "common/mqtt_client.hpp"
+#include "common/timer_wheel.hpp"
 #include <string>
 #include <memory>
 #include <sstream>
+#include <atomic>
 #include <chrono>
 #include <iomanip>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace common {
 
@@ -20,12 +25,36 @@ enum class LogLevel {
     ERROR       ///< Error level - error events that might still allow the application to continue
 };
 
+/**
+ * @struct LogRateLimit
+ * @brief Token-bucket settings used to throttle repeated log messages
+ * 
+ * Each distinct message template (the message with digit runs collapsed) gets
+ * its own bucket holding up to `burst` tokens, refilled at `messages_per_second`.
+ * Messages arriving with an empty bucket are suppressed and reported in a
+ * "suppressed N similar messages" summary published every summary_interval_sec.
+ * ERROR messages are never rate limited.
+ */
+struct LogRateLimit {
+    double messages_per_second = 0.0;   ///< Refill rate per template; 0 disables rate limiting
+    double burst = 10.0;                ///< Maximum tokens (messages allowed back-to-back)
+    int summary_interval_sec = 30;      ///< Interval between suppressed-count summaries
+
+    /**
+     * @brief Checks whether rate limiting is active
+     * @return true if a positive refill rate is configured
+     */
+    bool enabled() const { return messages_per_second > 0.0; }
+};
+
 /**
  * @class Logger
  * @brief Provides logging functionality with MQTT integration
  * 
  * This class handles logging of messages at different severity levels.
  * Log messages are published to MQTT topics for monitoring and debugging purposes.
+ * Repeated messages can be throttled per message template with a token bucket
+ * (see LogRateLimit) so that fault storms cannot flood MQTT and the log manager.
  */
 class Logger {
 public:
@@ -34,8 +63,82 @@ public:
      * @param name Name of the logger (used in MQTT topics)
      * @param log_level Log level for the logger
      * @param mqtt_client Shared pointer to MQTT client for publishing logs
+     * @param rate_limit_component Key of the rate limit in AppLogLevel.RateLimit, empty for the logger name
      */
-    Logger(const std::string& name, const std::string& log_level, std::shared_ptr<MQTTClient> mqtt_client);
+    Logger(const std::string& name, const std::string& log_level, std::shared_ptr<MQTTClient> mqtt_client,
+           const std::string& rate_limit_component = "");
+
+    /**
+     * @brief Destructor that cancels the summary timer and removes the logger from the process-wide registry
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Gets the name of the logger
+     * @return Logger name
+     */
+    const std::string& getName() const { return name_; }
+
+    /**
+     * @brief Gets the current log level
+     * @return Current log level
+     */
+    LogLevel getLevel() const { return log_level_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Changes the log level at runtime
+     * @param level New log level
+     */
+    void setLevel(LogLevel level) { log_level_.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Changes the level of a named logger, or of every logger in the process
+     * @param name Logger name, or empty / "all" for every registered logger
+     * @param level New log level
+     * @return Number of loggers whose level was changed
+     */
+    static size_t setLevelByName(const std::string& name, LogLevel level);
+
+    /**
+     * @brief Lists every registered logger and its current level
+     * @return Pairs of logger name and level string, sorted by name
+     */
+    static std::vector<std::pair<std::string, std::string>> listLevels();
+
+    /**
+     * @brief Parses a log level string
+     * @param level_str Level name (DEBUG, INFO, WARNING, ERROR)
+     * @param[out] level Parsed level
+     * @return true if the string named a valid level, false otherwise
+     */
+    static bool parseLevel(const std::string& level_str, LogLevel& level);
+
+    /**
+     * @brief Converts a log level to its string name
+     * @param level The log level
+     * @return Level name (DEBUG, INFO, WARNING, ERROR)
+     */
+    static std::string levelToString(LogLevel level);
+
+    /**
+     * @brief Gets the MQTT topic on which a process asks the log file owner to lower the file level
+     * @return Topic name; the retained payload is a level name, empty for no request
+     */
+    static const char* fileLevelTopic() { return "log_control/file_level"; }
+
+    /**
+     * @brief Sets the rate limit applied to repeated messages
+     * @param rate_limit Token-bucket settings; a zero rate disables limiting
+     */
+    void setRateLimit(const LogRateLimit& rate_limit);
+
+    /**
+     * @brief Publishes summaries for all currently suppressed messages
+     */
+    void flushSuppressed();
     
     /**
      * @brief Logs a debug level message
@@ -70,6 +173,48 @@ private:
      */
     std::string formatMessage(LogLevel level, const std::string& message);
 
+    /**
+     * @brief Records, rate limits and publishes a message
+     * @param level The log level
+     * @param message The log message
+     */
+    void log(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Publishes a formatted message to the topic for its level
+     * @param level The log level
+     * @param message The log message
+     */
+    void publish(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Applies the token-bucket rate limit to a message
+     * @param level The log level
+     * @param message The log message
+     * @return true if the message should be published, false if it was suppressed
+     * @note Takes no lock while rate limiting is disabled or for ERROR messages
+     */
+    bool admit(LogLevel level, const std::string& message);
+
+    /**
+     * @struct SuppressionBucket
+     * @brief Token bucket and suppression counter for one message template
+     */
+    struct SuppressionBucket {
+        double tokens = 0.0;                                    ///< Tokens currently available
+        std::chrono::steady_clock::time_point last_refill;      ///< Time of the last refill
+        uint64_t suppressed = 0;                                ///< Messages suppressed since the last summary
+        LogLevel level = LogLevel::INFO;                        ///< Level of the suppressed messages
+        std::string sample;                                     ///< First suppressed message, used in the summary
+    };
+
+    /**
+     * @brief Moves pending suppression counts into summary messages
+     * @param[out] summaries Level and text of each summary to publish
+     * @note Must be called with rate_mutex_ held
+     */
+    void collectSummaries(std::vector<std::pair<LogLevel, std::string>>& summaries);
+
     /**
      * @brief Gets the current timestamp in ISO 8601 format
      * @return Timestamp string
@@ -79,7 +224,14 @@ private:
     std::string name_;                                          ///< Name of the logger
     std::shared_ptr<MQTTClient> mqtt_client_;                   ///< MQTT client for publishing logs
     std::string topic_prefix_;                                  ///< MQTT topic prefix for log messages
-    LogLevel log_level_;                                         ///< Log level for the logger
+    std::atomic<LogLevel> log_level_;                           ///< Log level for the logger (changeable at runtime)
+
+    // Rate limiting
+    std::atomic<bool> rate_limited_{false};                     ///< Whether rate limiting is enabled, read without rate_mutex_
+    std::mutex rate_mutex_;                                     ///< Protects the rate limit state
+    LogRateLimit rate_limit_;                                   ///< Active rate limit settings
+    std::unordered_map<uint64_t, SuppressionBucket> buckets_;   ///< Buckets keyed by message template hash
+    TimerWheel::TimerId summary_timer_ = 0;                     ///< Periodic flushSuppressed() timer, 0 if none
 };
 
 } // namespace common 
\ No newline at end of file
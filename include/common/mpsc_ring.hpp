@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace common {
+
+/**
+ * @class MPSCRing
+ * @brief Bounded lock-free multi-producer / single-consumer ring buffer
+ *
+ * All slots are allocated once at construction. Producers claim a slot with a
+ * single compare-and-swap and move their value into it, so pushing never
+ * allocates and never blocks; when the ring is full the value is rejected and
+ * counted as dropped. The single consumer drains every published slot in one
+ * pass.
+ *
+ * @tparam T Element type, must be default constructible and move assignable
+ */
+template <typename T>
+class MPSCRing {
+public:
+    /**
+     * @brief Constructs a ring with at least the requested number of slots
+     * @param capacity Minimum number of slots, rounded up to a power of two
+     */
+    explicit MPSCRing(size_t capacity)
+        : capacity_(roundUpPowerOfTwo(capacity)), mask_(capacity_ - 1),
+          slots_(new Slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCRing(const MPSCRing&) = delete;
+    MPSCRing& operator=(const MPSCRing&) = delete;
+
+    /**
+     * @brief Moves a value into the next free slot
+     * @param value Value to enqueue
+     * @return true if the value was enqueued, false if the ring was full
+     */
+    template <typename U>
+    bool tryPush(U&& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::forward<U>(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        enqueued_.fetch_add(1, std::memory_order_relaxed);
+        // The consumer may already have drained past this slot; only a consistent
+        // snapshot with dequeue <= enqueue gives a meaningful depth
+        size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+        if (dequeued > enqueued) {
+            return true;
+        }
+        size_t depth = std::min(enqueued - dequeued, capacity_);
+        size_t high = high_water_.load(std::memory_order_relaxed);
+        while (depth > high && !high_water_.compare_exchange_weak(high, depth, std::memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    /**
+     * @brief Consumes every published value currently in the ring
+     *
+     * Must only be called from the single consumer thread. The callback
+     * receives a mutable reference and may move out of it.
+     *
+     * @param consume Callable invoked as consume(T&) for each value
+     * @return Number of values consumed
+     */
+    template <typename F>
+    size_t drain(F&& consume) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;
+            }
+            consume(slot.value);
+            slot.sequence.store(pos + capacity_, std::memory_order_release);
+            ++pos;
+            ++count;
+        }
+        dequeue_pos_.store(pos, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Gets the approximate number of values waiting in the ring
+     * @return Current queue depth
+     */
+    size_t size() const {
+        size_t tail = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t head = enqueue_pos_.load(std::memory_order_relaxed);
+        return head >= tail ? head - tail : 0;
+    }
+
+    /**
+     * @brief Gets the number of slots in the ring
+     * @return Ring capacity
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Gets the total number of values accepted by the ring
+     * @return Enqueued count
+     */
+    uint64_t enqueued() const { return enqueued_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the total number of values rejected because the ring was full
+     * @return Dropped count
+     */
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets the highest queue depth observed
+     * @return High-water mark
+     */
+    size_t highWater() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    /**
+     * @struct Slot
+     * @brief Preallocated storage for one value plus its publication sequence
+     */
+    struct Slot {
+        std::atomic<size_t> sequence{0};  ///< Slot sequence used to hand off ownership
+        T value;                          ///< Stored value
+    };
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t p = 2;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t capacity_;                             ///< Number of slots (power of two)
+    const size_t mask_;                                 ///< Index mask (capacity - 1)
+    std::unique_ptr<Slot[]> slots_;                     ///< Preallocated slot array
+
+    char pad0_[kCacheLine];                             ///< Keeps producer and consumer cursors apart
+    std::atomic<size_t> enqueue_pos_{0};                ///< Next position claimed by producers
+    char pad1_[kCacheLine];
+    std::atomic<size_t> dequeue_pos_{0};                ///< Next position read by the consumer
+    char pad2_[kCacheLine];
+
+    std::atomic<uint64_t> enqueued_{0};                 ///< Total values accepted
+    std::atomic<uint64_t> dropped_{0};                  ///< Total values rejected (ring full)
+    std::atomic<size_t> high_water_{0};                 ///< Highest observed depth
+};
+
+} // namespace common
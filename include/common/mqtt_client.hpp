@@ -79,6 +79,15 @@ public:
      */
     bool publish(const std::string& topic, const std::string& payload);
 
+    /**
+     * @brief Publishes a message to an MQTT topic with an explicit retain flag
+     * @param topic The MQTT topic to publish to
+     * @param payload The message payload to publish
+     * @param retain Whether the broker keeps the message for later subscribers
+     * @return true if publishing was successful, false otherwise
+     */
+    bool publish(const std::string& topic, const std::string& payload, bool retain);
+
     /**
      * @brief Subscribes to an MQTT topic
      * @param topic The MQTT topic to subscribe to
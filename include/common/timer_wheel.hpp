@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace common {
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timer wheel running periodic and one-shot callbacks on one thread
+ *
+ * Timers live in 4 levels of 64 slots; level 0 has one slot per tick, each
+ * higher level 64 times coarser, and timers cascade down as their slot comes
+ * up. The thread sleeps until the next occupied slot instead of ticking, and
+ * periodic timers are phase-aligned to multiples of their period, so all
+ * devices polling at the same period share one wakeup. Thread count and
+ * wakeups therefore do not grow with the number of timers.
+ *
+ * Callbacks run on the wheel thread one after another and must be short.
+ * cancel() waits for a running callback of that timer to finish, so an owner
+ * that cancels its timers in stop() can safely be destroyed afterwards.
+ */
+class TimerWheel {
+public:
+    using TimerId = uint64_t;                  ///< Timer handle, 0 is never a valid timer
+    using Callback = std::function<void()>;   ///< Timer callback
+
+    /**
+     * @brief Gets the process-wide timer wheel
+     * @return Shared instance; it is never destroyed, call stop() at shutdown
+     */
+    static TimerWheel& getInstance();
+
+    /**
+     * @brief Constructs a timer wheel and starts its thread
+     * @param tick Timer resolution
+     */
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10));
+
+    /**
+     * @brief Stops the wheel and joins its thread
+     */
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Runs a callback every period
+     * @param period Interval, rounded up to whole ticks
+     * @param callback Function to run
+     * @return Timer id, 0 if the wheel is stopped
+     * @note The first run is at the next multiple of the period, at most one period from now
+     */
+    TimerId schedulePeriodic(std::chrono::milliseconds period, Callback callback);
+
+    /**
+     * @brief Runs a callback once after a delay
+     * @param delay Delay, rounded up to whole ticks
+     * @param callback Function to run
+     * @return Timer id, 0 if the wheel is stopped
+     */
+    TimerId scheduleOnce(std::chrono::milliseconds delay, Callback callback);
+
+    /**
+     * @brief Cancels a timer
+     * @param id Timer id returned by a schedule call
+     * @return true if the timer was pending
+     * @note Blocks while the timer's callback is running, unless called from that callback
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Cancels all timers and joins the wheel thread
+     * @note Later schedule calls return 0
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of pending timers
+     * @return Timer count
+     */
+    size_t timerCount() const;
+
+    /**
+     * @brief Gets the number of times the wheel thread woke up
+     * @return Wakeup count since construction
+     */
+    uint64_t wakeupCount() const { return wakeups_.load(std::memory_order_relaxed); }
+
+private:
+    static const int kLevels = 4;               ///< Wheel levels
+    static const int kSlotBits = 6;             ///< log2 of the slots per level
+    static const int kSlots = 1 << kSlotBits;   ///< Slots per level
+
+    /**
+     * @struct Timer
+     * @brief One scheduled callback
+     */
+    struct Timer {
+        uint64_t expiry = 0;                    ///< Tick the timer is due at
+        uint64_t period = 0;                    ///< Period in ticks, 0 for one-shot timers
+        std::shared_ptr<Callback> callback;     ///< Callback, shared so it can run outside the lock
+    };
+
+    /**
+     * @struct SlotEntry
+     * @brief Reference from a slot to a timer; stale once the timer is cancelled or rescheduled
+     */
+    struct SlotEntry {
+        TimerId id;                             ///< Timer id
+        uint64_t expiry;                        ///< Expiry the entry was filed under
+    };
+
+    /**
+     * @brief Adds a timer and files it into its slot
+     */
+    TimerId addTimer(uint64_t expiry, uint64_t period_ticks, Callback callback);
+
+    /**
+     * @brief Files a timer reference into the slot of its expiry
+     * @note expiry must not be before current_tick_
+     */
+    void place(TimerId id, uint64_t expiry);
+
+    /**
+     * @brief Finds the next tick after current_tick_ at which a slot needs processing
+     * @return Tick, or UINT64_MAX if no timers are filed
+     */
+    uint64_t nextEventTick() const;
+
+    /**
+     * @brief Refiles the timers of the higher-level slots that start at current_tick_
+     */
+    void cascade();
+
+    /**
+     * @brief Gets the current tick of the steady clock
+     */
+    uint64_t nowTick() const;
+
+    /**
+     * @brief Main loop of the wheel thread
+     */
+    void run();
+
+    const std::chrono::milliseconds tick_;                           ///< Timer resolution
+    const std::chrono::steady_clock::time_point origin_;             ///< Time of tick 0
+
+    mutable std::mutex mutex_;                                       ///< Guards the fields below
+    std::condition_variable wake_cv_;                                ///< Wakes the thread for earlier timers or stop
+    std::condition_variable done_cv_;                                ///< Signals the end of a callback run
+    std::array<std::array<std::vector<SlotEntry>, kSlots>, kLevels> wheel_;  ///< Slot contents per level
+    std::array<uint64_t, kLevels> occupied_{};                       ///< Bitmap of non-empty slots per level
+    std::vector<SlotEntry> overflow_;                                ///< Timers beyond the span of the top level
+    std::unordered_map<TimerId, Timer> timers_;                      ///< Pending timers
+    uint64_t current_tick_ = 0;                                      ///< Last processed tick
+    uint64_t wake_tick_ = UINT64_MAX;                                ///< Tick the thread sleeps until
+    TimerId next_id_ = 1;                                            ///< Id of the next timer
+    TimerId running_id_ = 0;                                         ///< Timer whose callback is running, 0 if none
+    bool stopped_ = false;                                           ///< Whether stop() was called
+
+    std::atomic<uint64_t> wakeups_{0};                               ///< Thread wakeups
+    std::thread thread_;                                             ///< Wheel thread
+};
+
+} // namespace common
@@ -30,5 +30,24 @@ std::string formatTimestamp(const std::chrono::system_clock::time_point& tp);
  */
 std::string getCurrentTimestamp();
 
+/**
+ * @brief Formats a timestamp with millisecond precision
+ * 
+ * Converts a system clock time point to a string in the format
+ * "YYYY-MM-DD HH:MM:SS.mmm". The date and seconds prefix is cached per
+ * thread, so only the milliseconds are formatted while the second is unchanged.
+ * 
+ * @param tp The timestamp to format
+ * @return Formatted timestamp string
+ */
+std::string formatTimestampMs(const std::chrono::system_clock::time_point& tp);
+
+/**
+ * @brief Gets the current timestamp with millisecond precision
+ * 
+ * @return Timestamp string in the format "YYYY-MM-DD HH:MM:SS.mmm"
+ */
+std::string getCurrentTimestampMs();
+
 } // namespace utils
 } // namespace common 
\ No newline at end of file
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "common/alarm_message.hpp"
+#include "common/logger.hpp"
+
+namespace fan_control_system {
+
+using AlarmSeverity = common::AlarmSeverity;
+
+/**
+ * @struct ActionExecutorSettings
+ * @brief Configuration of the alarm action executor
+ */
+struct ActionExecutorSettings {
+    int workers = 2;                                 ///< Number of worker threads
+    size_t queue_capacity = 256;                     ///< Maximum number of pending actions
+    int default_timeout_ms = 5000;                   ///< Timeout for actions without an explicit one
+    int stop_timeout_ms = 2000;                      ///< Time stop() waits for running actions
+    int max_abandoned_workers = 4;                   ///< Abandoned workers allowed before timed-out ones are kept
+    std::map<std::string, int> timeouts_ms;          ///< Per-action timeouts in milliseconds
+};
+
+/**
+ * @struct ActionExecutorStats
+ * @brief Queue and execution metrics of the alarm action executor
+ */
+struct ActionExecutorStats {
+    size_t pending = 0;            ///< Actions waiting to run
+    size_t high_water = 0;         ///< Highest number of pending actions observed
+    size_t running = 0;            ///< Actions currently running
+    size_t workers = 0;            ///< Worker threads in the pool
+    uint64_t submitted = 0;        ///< Actions submitted
+    uint64_t coalesced = 0;        ///< Submissions merged into an already pending action
+    uint64_t dropped = 0;          ///< Actions rejected or evicted because the queue was full or the action is stuck
+    uint64_t executed = 0;         ///< Actions that completed successfully
+    uint64_t failed = 0;           ///< Actions that threw an exception
+    uint64_t timed_out = 0;        ///< Actions abandoned after exceeding their timeout
+    int64_t max_wait_ms = 0;       ///< Longest time an action waited in the queue
+};
+
+/**
+ * @class ActionExecutor
+ * @brief Runs alarm actions asynchronously on a small worker pool
+ *
+ * Submitting an action only enqueues it, so alarm ingestion never waits for
+ * action callbacks. Pending actions are kept in one lane per alarm severity and
+ * workers always take from the most severe non-empty lane first. A submission
+ * for an action that is already pending for the same alarm source is coalesced
+ * into it (latest message wins, priority is raised if needed). When the queue
+ * is full, the oldest action of a less severe lane is evicted, otherwise the new
+ * action is dropped.
+ *
+ * Callbacks cannot be interrupted; a worker whose action exceeds its timeout is
+ * abandoned (detached) and replaced so that the pool keeps its capacity, and
+ * stop() waits at most stop_timeout_ms before abandoning the workers whose
+ * actions are still running. At most max_abandoned_workers are abandoned at
+ * a time; beyond that a timed-out worker is kept in the pool. While a
+ * timed-out action is still running, the same action for the same alarm
+ * source is not started again and new submissions for it are dropped. Worker threads only hold shared references to
+ * the queue state and their own state, never the executor or its logger, so
+ * an abandoned thread exits safely as soon as the callback returns, even
+ * after the executor is destroyed.
+ */
+class ActionExecutor {
+public:
+    /**
+     * @brief Action callback receiving the alarm source and message
+     */
+    using Action = std::function<void(const std::string&, const std::string&)>;
+
+    /**
+     * @brief Constructs the executor
+     * @param settings Pool size, queue capacity and timeouts
+     * @param logger Logger used for action results, must outlive the executor
+     */
+    ActionExecutor(const ActionExecutorSettings& settings, common::Logger* logger);
+
+    /**
+     * @brief Destructor that stops the workers
+     */
+    ~ActionExecutor();
+
+    ActionExecutor(const ActionExecutor&) = delete;
+    ActionExecutor& operator=(const ActionExecutor&) = delete;
+
+    /**
+     * @brief Starts the worker pool and the timeout watchdog
+     */
+    void start();
+
+    /**
+     * @brief Stops the workers; actions still pending are discarded
+     * @note Waits at most stop_timeout_ms for running actions, the workers still running one are abandoned
+     */
+    void stop();
+
+    /**
+     * @brief Enqueues an action
+     * @param action_name Name of the action (used for coalescing and timeouts)
+     * @param action Callback to run
+     * @param priority Severity of the triggering alarm
+     * @param alarm_source Source of the alarm
+     * @param message Alarm message
+     * @return true if the action was queued or coalesced, false if it was dropped
+     */
+    bool submit(const std::string& action_name, Action action, AlarmSeverity priority,
+                const std::string& alarm_source, const std::string& message);
+
+    /**
+     * @brief Gets queue and execution metrics
+     * @return Snapshot of the executor statistics
+     */
+    ActionExecutorStats get_stats() const;
+
+private:
+    static constexpr int kLaneCount = 4;   ///< One lane per AlarmSeverity value
+
+    /**
+     * @struct Task
+     * @brief One pending action
+     */
+    struct Task {
+        std::string key;                                  ///< Coalescing key (action + source)
+        std::string action_name;                          ///< Action name
+        Action action;                                    ///< Callback to run
+        std::string alarm_source;                         ///< Alarm source
+        std::string message;                              ///< Latest alarm message
+        int lane = 0;                                     ///< Lane the task currently belongs to
+        std::chrono::steady_clock::time_point enqueued;   ///< Time of the first submission
+    };
+
+    /**
+     * @struct Worker
+     * @brief State shared between a worker thread and the watchdog
+     */
+    struct Worker {
+        std::thread thread;                               ///< Worker thread
+        std::mutex mutex;                                 ///< Guards the fields below
+        bool busy = false;                                ///< Whether an action is running
+        bool abandoned = false;                           ///< Set by the watchdog on timeout
+        bool timed_out = false;                           ///< Set by the watchdog once the action exceeds its timeout
+        std::string key;                                  ///< Coalescing key of the running action
+        std::string action_name;                          ///< Running action
+        std::string alarm_source;                         ///< Source of the running action
+        std::chrono::steady_clock::time_point started;    ///< Start of the running action
+        std::chrono::milliseconds timeout{0};             ///< Timeout of the running action
+    };
+
+    /**
+     * @struct Core
+     * @brief Queue, workers and counters shared between the executor and its worker threads
+     */
+    struct Core {
+        ActionExecutorSettings settings;                            ///< Executor configuration
+        common::Logger* logger = nullptr;                           ///< Logger for action results
+
+        std::mutex mutex;                                           ///< Guards the fields below
+        std::condition_variable work_cv;                            ///< Signals workers about new tasks
+        std::condition_variable watchdog_cv;                        ///< Wakes the watchdog on stop
+        std::condition_variable idle_cv;                            ///< Signals stop() that a worker finished its action
+        bool running = false;                                       ///< Whether the pool is running
+
+        std::deque<std::shared_ptr<Task>> lanes[kLaneCount];        ///< Pending tasks per severity
+        std::unordered_map<std::string, std::shared_ptr<Task>> pending; ///< Coalescing key -> pending task
+        std::vector<std::shared_ptr<Worker>> workers;               ///< Live (not abandoned) workers
+        std::unordered_map<std::string, int> stuck;                 ///< Keys of timed-out actions still running -> count
+        size_t abandoned = 0;                                       ///< Abandoned workers still inside their action
+
+        ActionExecutorStats stats;                                  ///< Counters (pending/running/workers filled on read)
+    };
+
+    /**
+     * @brief Starts one worker thread; requires core->mutex
+     */
+    static void spawn_worker_locked(const std::shared_ptr<Core>& core);
+
+    /**
+     * @brief Worker thread loop
+     */
+    static void worker_loop(std::shared_ptr<Core> core, std::shared_ptr<Worker> worker);
+
+    /**
+     * @brief Watchdog loop that abandons and replaces timed-out workers
+     */
+    void watchdog_loop();
+
+    /**
+     * @brief Removes the next task from the most severe non-empty lane; requires core->mutex
+     */
+    static std::shared_ptr<Task> pop_locked(Core& core);
+
+    /**
+     * @brief Evicts the oldest task of a lane below the given one; requires core_->mutex
+     * @return true if a task was evicted
+     */
+    bool evict_below_locked(int lane);
+
+    /**
+     * @brief Gets the timeout configured for an action
+     */
+    static std::chrono::milliseconds timeout_for(const Core& core, const std::string& action_name);
+
+    std::shared_ptr<Core> core_;                                ///< State shared with the worker threads
+    std::thread watchdog_;                                      ///< Timeout watchdog thread, always joined
+};
+
+} // namespace fan_control_system
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include "fan_control_system/actuator_queue.hpp"
+
+namespace fan_control_system {
+
+/**
+ * @struct ActuationShaperSettings
+ * @brief Configuration of the actuation shaper (`Actuator.Shaper`)
+ */
+struct ActuationShaperSettings {
+    bool enabled = false;                           ///< Whether control loop speeds are shaped
+    double slew_rate_percent_per_s = 0.0;           ///< Maximum ramp rate, 0 (not configured) for no limit
+    int hysteresis_up_percent = 0;                  ///< Smallest increase that starts a move
+    int hysteresis_down_percent = 0;                ///< Smallest decrease that starts a move
+    std::chrono::milliseconds min_dwell{0};         ///< Time a fan holds a settled speed before it may slow down
+    std::chrono::milliseconds ramp_interval{250};   ///< Time between two ramp steps
+
+    /**
+     * @brief Reads the settings from the Actuator.Shaper configuration section
+     * @param config Shaper configuration node, may be undefined
+     * @return Settings, disabled if the section is missing
+     * @throw std::runtime_error if a configured value is out of range
+     */
+    static ActuationShaperSettings fromConfig(const YAML::Node& config);
+};
+
+/**
+ * @struct ActuationShaperStats
+ * @brief Counters of the actuation shaper, summed over all fans
+ */
+struct ActuationShaperStats {
+    uint64_t requests = 0;              ///< Control loop speed requests, per fan
+    uint64_t writes = 0;                ///< Commands emitted, one per fan and ramp step
+    uint64_t avoided_unchanged = 0;     ///< Requests for the speed the fan already has
+    uint64_t avoided_hysteresis = 0;    ///< Requests inside the hysteresis band
+    uint64_t deferred_dwell = 0;        ///< Decreases held back by the dwell time
+    uint64_t slew_limited = 0;          ///< Steps shortened by the slew rate limit
+};
+
+/**
+ * @class ActuationShaper
+ * @brief Turns control loop speed targets into few, bounded fan speed steps
+ *
+ * A fan at rest only starts moving when its target leaves the hysteresis band
+ * around its current speed (separate bands up and down), and only slows down
+ * once it has held its speed for the dwell time. A move then ramps towards the
+ * target at the slew rate, one step per ramp interval. Increases are never
+ * held by the dwell time, so reaching a higher target takes at most
+ * (target - current) / slew rate seconds plus one ramp interval.
+ *
+ * The shaper keeps no lock; the owner serializes all calls.
+ */
+class ActuationShaper {
+public:
+    /**
+     * @brief Constructs the shaper
+     * @param fan_count Number of fans, addressed by index
+     * @param settings Shaper configuration
+     */
+    ActuationShaper(size_t fan_count, const ActuationShaperSettings& settings);
+
+    /**
+     * @brief Gets the configuration
+     * @return Shaper settings
+     */
+    const ActuationShaperSettings& settings() const { return settings_; }
+
+    /**
+     * @brief Sets the target of a fan from the control loop
+     * @param fan Fan index
+     * @param duty_cycle Target duty cycle
+     * @param now Current time
+     */
+    void set_target(size_t fan, int duty_cycle, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Records a speed written outside the shaper (manual or emergency) and drops the target
+     * @param fan Fan index
+     * @param duty_cycle Duty cycle the fan was set to
+     * @param now Time of the change
+     */
+    void sync(size_t fan, int duty_cycle, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Computes the next step of every fan that needs one
+     * @param now Current time
+     * @param commands AUTO commands for the fans to write, appended
+     */
+    void step(std::chrono::steady_clock::time_point now, std::vector<ActuatorCommand>& commands);
+
+    /**
+     * @brief Gets the duty cycle a fan was last stepped or synced to
+     * @param fan Fan index
+     * @return Duty cycle, -1 if unknown or the index is invalid
+     */
+    int output(size_t fan) const { return fan < fans_.size() ? fans_[fan].output : -1; }
+
+    /**
+     * @brief Gets whether any fan still has a target it has not reached
+     * @return true if step() may emit more commands
+     */
+    bool pending() const;
+
+    /**
+     * @brief Gets the counters
+     * @return Counters summed over all fans
+     */
+    const ActuationShaperStats& stats() const { return stats_; }
+
+private:
+    /**
+     * @struct FanShaping
+     * @brief Shaping state of one fan
+     */
+    struct FanShaping {
+        int output = -1;                                    ///< Last duty cycle emitted or synced, -1 if unknown
+        int target = -1;                                    ///< Control loop target, -1 if none
+        bool moving = false;                                ///< Whether a ramp towards target is under way
+        bool counted = false;                               ///< Whether the target was already counted as deferred
+        std::chrono::steady_clock::time_point settled;      ///< Time the fan reached its current speed
+        std::chrono::steady_clock::time_point last_step;    ///< Time of the last ramp step
+    };
+
+    ActuationShaperSettings settings_;      ///< Shaper configuration
+    std::vector<FanShaping> fans_;          ///< State per fan
+    ActuationShaperStats stats_;            ///< Counters
+};
+
+} // namespace fan_control_system
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fan_control_system {
+
+/**
+ * @enum CommandSource
+ * @brief Origin of a fan speed command, in increasing priority
+ */
+enum class CommandSource : uint8_t {
+    AUTO = 0,        ///< Temperature control loop
+    MANUAL = 1,      ///< Manual override (RPC / CLI)
+    EMERGENCY = 2    ///< Emergency cooling alarm action
+};
+
+/**
+ * @brief Gets the name of a command source for logs
+ * @param source Command source
+ * @return "AUTO", "MANUAL" or "EMERGENCY"
+ */
+const char* commandSourceName(CommandSource source);
+
+/**
+ * @struct ActuatorCommand
+ * @brief Speed command for one fan
+ */
+struct ActuatorCommand {
+    size_t fan = 0;                             ///< Index of the fan in the queue
+    CommandSource source = CommandSource::AUTO; ///< Origin and priority of the command
+    int duty_cycle = 0;                         ///< Duty cycle to apply (0-100)
+    int pwm_count = -1;                         ///< Raw PWM count to apply, -1 to derive it from the duty cycle
+    bool written = false;                       ///< Set by the applier once the register was written
+};
+
+/**
+ * @struct ActuatorFanStats
+ * @brief Command and register write counters of one fan
+ */
+struct ActuatorFanStats {
+    uint64_t submitted = 0;         ///< Commands submitted
+    uint64_t coalesced = 0;         ///< Commands superseded before reaching the register
+    uint64_t register_writes = 0;   ///< Register writes performed
+    uint64_t failed_writes = 0;     ///< Register writes that failed
+};
+
+/**
+ * @class ActuatorQueue
+ * @brief Single-writer queue for fan speed commands with latest-wins coalescing
+ *
+ * Every fan has one pending command slot. A new command replaces the pending
+ * one unless that has a higher priority (EMERGENCY > MANUAL > AUTO), so any
+ * number of commands between two ticks costs at most one register write per
+ * fan. The writer thread takes all pending commands once per tick and hands
+ * them to the applier as one batch, and sleeps while no command is pending.
+ *
+ * EMERGENCY commands and flush() do not wait for the tick: the calling thread
+ * takes over the writer role and writes the pending batch itself, saving the
+ * thread handoff on the emergency cooling path. Batches are always written
+ * one at a time in submission order, never concurrently.
+ */
+class ActuatorQueue {
+public:
+    /**
+     * @brief Writes a batch of commands; sets each command's written flag
+     */
+    using Applier = std::function<void(std::vector<ActuatorCommand>&)>;
+
+    /**
+     * @brief Constructs the queue
+     * @param fan_count Number of fans, commands address fans by index below it
+     * @param tick Minimum interval between two batches of regular commands
+     * @param applier Function writing a batch, called by one thread at a time
+     */
+    ActuatorQueue(size_t fan_count, std::chrono::milliseconds tick, Applier applier);
+
+    /**
+     * @brief Stops the writer thread
+     */
+    ~ActuatorQueue();
+
+    ActuatorQueue(const ActuatorQueue&) = delete;
+    ActuatorQueue& operator=(const ActuatorQueue&) = delete;
+
+    /**
+     * @brief Starts the writer thread
+     */
+    void start();
+
+    /**
+     * @brief Stops the writer thread; pending commands are discarded
+     * @note Returns only after a batch being written by flush() has been applied
+     */
+    void stop();
+
+    /**
+     * @brief Submits commands for one or more fans
+     * @param commands Commands, at most one per fan is kept
+     * @param report Keep the outcome of each command for wait_applied(); the ticket must then be waited for
+     * @return Ticket to pass to wait_applied(), 0 if a fan index is invalid
+     * @note With an EMERGENCY command the pending batch is written before this returns
+     */
+    uint64_t submit(const std::vector<ActuatorCommand>& commands, bool report = false);
+
+    /**
+     * @brief Waits until the commands of a submission have been written or superseded
+     * @param ticket Ticket returned by submit()
+     * @param timeout Maximum time to wait
+     * @param outcome Receives the submitted commands with their written flags, if the
+     *        submission was made with report; superseded commands are not written
+     * @return true if the submission was processed, false on timeout or stop
+     */
+    bool wait_applied(uint64_t ticket, std::chrono::milliseconds timeout,
+                      std::vector<ActuatorCommand>* outcome = nullptr);
+
+    /**
+     * @brief Writes all pending commands on the calling thread without waiting for the tick
+     * @return true if everything submitted so far was processed, false if the queue is stopped
+     */
+    bool flush();
+
+    /**
+     * @brief Gets the counters of one fan
+     * @param fan Fan index
+     * @return Counters, all zero for an invalid index
+     */
+    ActuatorFanStats get_stats(size_t fan) const;
+
+    /**
+     * @brief Gets the number of batches written
+     * @return Batch count since construction
+     */
+    uint64_t get_batch_count() const;
+
+private:
+    /**
+     * @struct Slot
+     * @brief Pending command of one fan
+     */
+    struct Slot {
+        bool pending = false;           ///< Whether a command is waiting to be written
+        ActuatorCommand command;        ///< Latest command of the highest pending priority
+        uint64_t ticket = 0;            ///< Submission the command belongs to
+    };
+
+    /**
+     * @brief Writer thread loop
+     */
+    void run();
+
+    /**
+     * @brief Takes all pending commands and writes them as one batch on the calling thread
+     * @return false if the queue is stopped
+     */
+    bool write_pending();
+
+    const std::chrono::milliseconds tick_;                  ///< Minimum interval between regular batches
+    Applier applier_;                                       ///< Writes a batch
+
+    std::mutex writer_mutex_;                               ///< Held while a batch is taken and written
+    mutable std::mutex mutex_;                              ///< Guards the fields below
+    std::condition_variable work_cv_;                       ///< Wakes the writer
+    std::condition_variable applied_cv_;                    ///< Signals processed submissions
+    std::vector<Slot> slots_;                               ///< Pending command per fan
+    std::vector<ActuatorFanStats> stats_;                   ///< Counters per fan
+    std::unordered_map<uint64_t, std::vector<ActuatorCommand>> reports_; ///< Outcomes of reported submissions by ticket
+    size_t pending_count_ = 0;                              ///< Slots holding a command
+    bool running_ = false;                                  ///< Whether the writer runs
+    uint64_t next_ticket_ = 1;                              ///< Ticket of the next submission
+    uint64_t applied_ticket_ = 0;                           ///< Highest processed ticket
+    uint64_t batches_ = 0;                                  ///< Batches written
+    std::chrono::steady_clock::time_point last_batch_;      ///< Start of the last batch
+    std::thread thread_;                                    ///< Writer thread
+};
+
+} // namespace fan_control_system
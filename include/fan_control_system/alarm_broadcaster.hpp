@@ -0,0 +1,169 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "fan_control_system/alarm_manager.hpp"
+
+namespace fan_control_system {
+
+/**
+ * @struct AlarmEvent
+ * @brief One alarm state change delivered to watchers
+ */
+struct AlarmEvent {
+    /**
+     * @enum Type
+     * @brief Kind of state change
+     */
+    enum class Type {
+        RAISED,            ///< New alarm entry
+        UPDATED,           ///< Existing entry raised again
+        CLEARED,           ///< Alarm cleared by its source
+        HISTORY_CLEARED    ///< History entries removed
+    };
+
+    Type type = Type::RAISED;                    ///< Kind of state change
+    uint64_t sequence = 0;                       ///< Broadcaster-wide event number
+    std::string source;                          ///< Alarm source, empty for all (HISTORY_CLEARED)
+    std::string alarm_id;                        ///< Alarm id within the source (CLEARED)
+    std::string message;                         ///< Alarm message
+    AlarmSeverity severity = AlarmSeverity::INFO; ///< Alarm severity
+    std::string timestamp;                       ///< Time of the change
+    int occurrence_count = 0;                    ///< Occurrences so far (RAISED, UPDATED)
+    int cleared_entries = 0;                     ///< Entries removed (HISTORY_CLEARED)
+};
+
+/**
+ * @class AlarmSubscription
+ * @brief Bounded event buffer of one watcher
+ *
+ * The broadcaster pushes without ever blocking; when the buffer is full the
+ * oldest event is dropped and counted, so a slow consumer only loses its own
+ * events and never delays alarm processing or other watchers.
+ */
+class AlarmSubscription {
+public:
+    /**
+     * @brief Constructs a subscription
+     * @param capacity Maximum number of buffered events
+     * @param source Source filter, empty for all sources
+     * @param min_severity Lowest severity delivered
+     */
+    AlarmSubscription(size_t capacity, const std::string& source, AlarmSeverity min_severity);
+
+    /**
+     * @brief Waits for the next event
+     * @param[out] event Next event
+     * @param timeout Maximum time to wait
+     * @return true if an event was returned, false on timeout or when closed and drained
+     */
+    bool next(AlarmEvent& event, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Gets the number of events dropped because the buffer was full
+     * @return Dropped event count
+     */
+    uint64_t dropped() const;
+
+    /**
+     * @brief Checks whether the subscription was closed by the broadcaster
+     * @return true if closed
+     */
+    bool closed() const;
+
+private:
+    friend class AlarmBroadcaster;
+
+    /**
+     * @brief Checks whether an event passes the filter
+     */
+    bool matches(const AlarmEvent& event) const;
+
+    /**
+     * @brief Buffers an event, dropping the oldest if full
+     */
+    void push(const std::shared_ptr<const AlarmEvent>& event);
+
+    /**
+     * @brief Wakes the consumer and makes next() return false once drained
+     */
+    void close();
+
+    const size_t capacity_;                                  ///< Maximum buffered events
+    const std::string source_;                               ///< Source filter, empty for all
+    const AlarmSeverity min_severity_;                       ///< Lowest severity delivered
+
+    mutable std::mutex mutex_;                               ///< Guards the fields below
+    std::condition_variable cv_;                             ///< Signals new events or close
+    std::deque<std::shared_ptr<const AlarmEvent>> events_;   ///< Buffered events, oldest first
+    uint64_t dropped_ = 0;                                   ///< Events dropped on overflow
+    bool closed_ = false;                                    ///< Whether the subscription is closed
+};
+
+/**
+ * @class AlarmBroadcaster
+ * @brief Fans alarm events out to any number of watchers
+ *
+ * Each event is allocated once and shared by all subscription buffers. The
+ * subscriber list is copy-on-write, so publishing only takes the list lock long
+ * enough to copy one pointer.
+ */
+class AlarmBroadcaster {
+public:
+    /**
+     * @brief Constructs the broadcaster
+     * @param buffer_size Events buffered per subscriber
+     * @param max_subscribers Maximum number of concurrent subscribers
+     */
+    AlarmBroadcaster(size_t buffer_size, size_t max_subscribers);
+
+    /**
+     * @brief Adds a subscriber
+     * @param source Source filter, empty for all sources
+     * @param min_severity Lowest severity delivered
+     * @return Subscription, or nullptr if the subscriber limit is reached
+     */
+    std::shared_ptr<AlarmSubscription> subscribe(const std::string& source, AlarmSeverity min_severity);
+
+    /**
+     * @brief Removes and closes a subscriber
+     * @param subscription Subscription returned by subscribe()
+     */
+    void unsubscribe(const std::shared_ptr<AlarmSubscription>& subscription);
+
+    /**
+     * @brief Delivers an event to every matching subscriber
+     * @param event Event to deliver; its sequence number is assigned here
+     * @note Callers serialize publish() so that buffers receive events in sequence order
+     */
+    void publish(AlarmEvent event);
+
+    /**
+     * @brief Closes and removes all subscribers
+     */
+    void close_all();
+
+    /**
+     * @brief Gets the number of subscribers
+     * @return Subscriber count
+     */
+    size_t subscriber_count() const;
+
+private:
+    using SubscriberList = std::vector<std::shared_ptr<AlarmSubscription>>;
+
+    const size_t buffer_size_;                               ///< Events buffered per subscriber
+    const size_t max_subscribers_;                           ///< Maximum concurrent subscribers
+
+    mutable std::mutex mutex_;                               ///< Guards subscribers_ and sequence_
+    std::shared_ptr<const SubscriberList> subscribers_;      ///< Copy-on-write subscriber list
+    uint64_t sequence_ = 0;                                  ///< Last assigned event number
+};
+
+} // namespace fan_control_system
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/alarm_message.hpp"
+
+namespace fan_control_system {
+
+using AlarmSeverity = common::AlarmSeverity;
+
+/**
+ * @struct CorrelationRule
+ * @brief Groups alarms from related sources into one incident
+ *
+ * Source patterns match a source exactly or, with a trailing '*', by prefix.
+ */
+struct CorrelationRule {
+    std::string name;                   ///< Rule name reported with its incidents
+    std::vector<std::string> sources;   ///< Source patterns covered by the rule
+    std::string group_by;               ///< Key token prefix (e.g. "MCU"); empty for one group per rule
+    std::string parent;                 ///< Pattern of the root-cause source, empty if none
+};
+
+/**
+ * @struct AlarmCorrelationSettings
+ * @brief Configuration of the alarm correlation stage
+ */
+struct AlarmCorrelationSettings {
+    bool enabled = false;               ///< Whether alarms are correlated at all
+    int window_ms = 30000;              ///< An incident absorbs related alarms until it was quiet this long
+    size_t max_incidents = 100;         ///< Incidents kept for queries, oldest dropped first
+    std::vector<CorrelationRule> rules; ///< Rules in priority order
+};
+
+/**
+ * @struct AlarmIncident
+ * @brief Related alarms grouped under one root cause
+ */
+struct AlarmIncident {
+    uint64_t id = 0;                              ///< Incident number, increasing
+    std::string rule;                             ///< Rule that grouped the alarms
+    std::string key;                              ///< Group key (e.g. "MCU001"), empty for rules without one
+    std::string root_source;                      ///< Source considered the root cause
+    std::string root_message;                     ///< Message of the root-cause alarm
+    AlarmSeverity severity = AlarmSeverity::INFO; ///< Highest severity seen
+    int64_t first_time_ms = 0;                    ///< First alarm in milliseconds since the epoch
+    int64_t latest_time_ms = 0;                   ///< Latest alarm in milliseconds since the epoch
+    int alarm_count = 0;                          ///< Alarms grouped so far
+    int suppressed_actions = 0;                   ///< Alarms whose actions were not run again
+    std::map<std::string, int> members;           ///< Alarm count per source
+    bool open = false;                            ///< Whether the incident still absorbs alarms
+};
+
+/**
+ * @struct CorrelationResult
+ * @brief Outcome of correlating one alarm
+ */
+struct CorrelationResult {
+    uint64_t incident_id = 0;           ///< Incident the alarm belongs to, 0 if no rule covers it
+    bool new_incident = false;          ///< The alarm opened the incident
+    bool escalated = false;             ///< The alarm raised the incident's highest severity
+
+    /**
+     * @brief Checks whether the alarm's actions should run and its history be recorded
+     * @return true for uncorrelated alarms, new incidents and escalations
+     */
+    bool is_significant() const { return incident_id == 0 || new_incident || escalated; }
+};
+
+/**
+ * @class AlarmCorrelator
+ * @brief Groups cascading alarms into incidents
+ *
+ * An alarm is covered by the first rule whose source patterns match it and,
+ * for rules with a group_by prefix, whose key can be found: the first token
+ * "<prefix><digits>" in the source, alarm id or message. Covered alarms with
+ * the same rule and key join the open incident of that group; an incident
+ * closes once no alarm joined it for window_ms. An alarm from the rule's
+ * parent source becomes the incident's root cause.
+ */
+class AlarmCorrelator {
+public:
+    /**
+     * @brief Constructs the correlator
+     * @param settings Window, retention and rules
+     */
+    explicit AlarmCorrelator(const AlarmCorrelationSettings& settings);
+
+    /**
+     * @brief Assigns an alarm to an incident
+     * @param source Alarm source
+     * @param alarm_id Alarm id within the source, empty if unknown
+     * @param message Alarm message
+     * @param severity Alarm severity
+     * @param now_ms Current time in milliseconds since the epoch
+     * @return Incident and whether the alarm is significant for it
+     */
+    CorrelationResult correlate(const std::string& source, const std::string& alarm_id,
+                                const std::string& message, AlarmSeverity severity, int64_t now_ms);
+
+    /**
+     * @brief Gets the retained incidents
+     * @param now_ms Current time in milliseconds since the epoch, used for the open flag
+     * @param max_incidents Maximum number returned, 0 for all
+     * @return Incidents, newest first
+     */
+    std::vector<AlarmIncident> get_incidents(int64_t now_ms, size_t max_incidents = 0) const;
+
+private:
+    /**
+     * @brief Checks a source against a pattern (exact, or prefix with trailing '*')
+     */
+    static bool matches(const std::string& pattern, const std::string& source);
+
+    /**
+     * @brief Finds the first "<prefix><digits>" token in a text
+     * @return Token, empty if none
+     */
+    static std::string find_key(const std::string& prefix, const std::string& text);
+
+    /**
+     * @brief Gets a retained incident by id
+     * @return Incident, nullptr if it was dropped
+     */
+    AlarmIncident* find_incident(uint64_t id);
+
+    const AlarmCorrelationSettings settings_;                ///< Window, retention and rules
+
+    mutable std::mutex mutex_;                               ///< Guards the fields below
+    std::deque<AlarmIncident> incidents_;                    ///< Retained incidents, ids ascending
+    std::unordered_map<std::string, uint64_t> open_groups_;  ///< "rule/key" -> latest incident of the group
+    uint64_t next_id_ = 1;                                   ///< Id of the next incident
+};
+
+} // namespace fan_control_system
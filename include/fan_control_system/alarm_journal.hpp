@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace fan_control_system {
+
+struct AlarmEntry;
+class AlarmStore;
+
+/**
+ * @struct AlarmJournalSettings
+ * @brief Configuration of the persistent alarm journal
+ */
+struct AlarmJournalSettings {
+    bool enabled = false;                                    ///< Whether alarm history is persisted
+    std::string directory = "/var/lib/fan_control_system";  ///< Directory holding the snapshot and journal
+    int group_commit_ms = 50;                                ///< Maximum delay before appended records are synced
+    size_t snapshot_every_records = 5000;                    ///< Journal records between compacting snapshots
+};
+
+/**
+ * @struct AlarmJournalRecovery
+ * @brief Measurements of one startup recovery
+ */
+struct AlarmJournalRecovery {
+    bool snapshot_loaded = false;      ///< Whether a valid snapshot was loaded
+    size_t snapshot_bytes = 0;         ///< Size of the snapshot file
+    size_t journal_bytes = 0;          ///< Size of the journal file
+    size_t records_replayed = 0;       ///< Journal records applied on top of the snapshot
+    size_t records_skipped = 0;        ///< Journal records already contained in the snapshot
+    bool tail_truncated = false;       ///< Whether a torn or corrupt journal tail was cut off
+    int64_t duration_us = 0;           ///< Wall time of the recovery
+};
+
+/**
+ * @class AlarmJournal
+ * @brief Append-only binary journal plus compact snapshots of the alarm store
+ *
+ * Every store mutation (upsert or clear) is encoded as a checksummed, sequence
+ * numbered record into an in-memory buffer; a writer thread appends the
+ * buffered records and syncs them once per group-commit interval, so the
+ * ingest thread never waits for disk I/O. Every `snapshot_every_records`
+ * records (and on clean shutdown) the writer saves a snapshot of the whole
+ * store and rewrites the journal to just the records newer than it, which
+ * bounds both disk usage and recovery time.
+ *
+ * Recovery reads the snapshot and the journal with one sequential read each,
+ * loads the snapshot and replays the newer journal records. A torn or corrupt
+ * tail (e.g. after a power loss) is cut off at the last valid record.
+ */
+class AlarmJournal {
+public:
+    /**
+     * @brief Produces a store image and the last journal sequence it contains
+     *
+     * Called from the writer thread; must hold the lock that serializes store
+     * mutations and journal appends while capturing both.
+     */
+    using SnapshotSource = std::function<void(std::string& image, uint64_t& sequence)>;
+
+    /**
+     * @brief Constructs the journal
+     * @param settings Directory, group-commit interval and snapshot cadence
+     */
+    explicit AlarmJournal(const AlarmJournalSettings& settings);
+
+    /**
+     * @brief Destructor that stops the writer thread
+     */
+    ~AlarmJournal();
+
+    AlarmJournal(const AlarmJournal&) = delete;
+    AlarmJournal& operator=(const AlarmJournal&) = delete;
+
+    /**
+     * @brief Rebuilds a store from the latest snapshot and the journal tail
+     * @param store Store to load into
+     * @param[out] recovery Recovery measurements
+     * @return true on success (including when no files exist yet), false on I/O failure
+     * @note Call once before start()
+     */
+    bool recover(AlarmStore& store, AlarmJournalRecovery& recovery);
+
+    /**
+     * @brief Opens the journal for appending and starts the writer thread
+     * @param snapshot_source Callback producing store snapshots
+     * @return true if the journal file could be opened
+     */
+    bool start(SnapshotSource snapshot_source);
+
+    /**
+     * @brief Flushes buffered records, writes a final snapshot and stops the writer
+     */
+    void stop();
+
+    /**
+     * @brief Appends an upsert record
+     * @param entry Entry passed to AlarmStore::add_or_update
+     * @note Must be called under the same lock as the store mutation
+     */
+    void append_upsert(const AlarmEntry& entry);
+
+    /**
+     * @brief Appends a clear record
+     * @param source Source passed to AlarmStore::clear, empty for all
+     * @note Must be called under the same lock as the store mutation
+     */
+    void append_clear(const std::string& source);
+
+    /**
+     * @brief Gets the sequence number of the last appended record
+     * @return Last sequence number, 0 if none
+     */
+    uint64_t last_sequence() const { return last_sequence_.load(); }
+
+private:
+    /**
+     * @enum RecordType
+     * @brief Journal record types
+     */
+    enum class RecordType : uint8_t {
+        UPSERT = 1,   ///< AlarmStore::add_or_update(entry)
+        CLEAR = 2     ///< AlarmStore::clear(source)
+    };
+
+    /**
+     * @brief Encodes a record into the pending buffer
+     */
+    void append(RecordType type, const std::string& payload);
+
+    /**
+     * @brief Writer thread loop
+     */
+    void writer_loop();
+
+    /**
+     * @brief Writes the pending buffer to the journal and syncs it
+     * @param[out] written Receives the bytes that were written
+     * @return true on success
+     */
+    bool flush(std::string* written = nullptr);
+
+    /**
+     * @brief Saves a snapshot and rewrites the journal to the records newer than it
+     * @return true on success
+     */
+    bool snapshot();
+
+    /**
+     * @brief Opens (or reopens) the journal file for appending
+     */
+    bool open_journal();
+
+    AlarmJournalSettings settings_;                 ///< Journal configuration
+    std::string snapshot_path_;                     ///< Path of the snapshot file
+    std::string journal_path_;                      ///< Path of the journal file
+    int journal_fd_ = -1;                           ///< Journal file descriptor (append mode)
+
+    std::mutex buffer_mutex_;                       ///< Guards pending_ and pending_records_
+    std::condition_variable buffer_cv_;             ///< Wakes the writer
+    std::string pending_;                           ///< Encoded records not yet written
+    size_t pending_records_ = 0;                    ///< Number of records in pending_
+    std::atomic<uint64_t> last_sequence_{0};        ///< Sequence of the last appended record
+
+    SnapshotSource snapshot_source_;                ///< Store snapshot callback
+    size_t records_since_snapshot_ = 0;             ///< Records in the journal file (writer thread only)
+    bool running_ = false;                          ///< Whether the writer runs (guarded by buffer_mutex_)
+    std::thread writer_;                            ///< Writer thread
+};
+
+} // namespace fan_control_system
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -8,25 +9,26 @@
 #include <mutex>
 #include <vector>
 #include <functional>
-#include <deque>
 #include <chrono>
 #include <yaml-cpp/yaml.h>
 #include "common/mqtt_client.hpp"
 #include "common/logger.hpp"
 #include "common/config.hpp"
+#include "common/alarm_message.hpp"
+#include "fan_control_system/action_executor.hpp"
+#include "fan_control_system/alarm_journal.hpp"
+#include "fan_control_system/alarm_correlator.hpp"
 
 namespace fan_control_system {
 
+class AlarmStore;
+class AlarmBroadcaster;
+class AlarmSubscription;
+
 /**
- * @enum AlarmSeverity
- * @brief Defines the severity levels for system alarms
+ * @brief Alarm severity, the same model the producers publish (see common::AlarmMessage)
  */
-enum class AlarmSeverity {
-    INFO,       ///< Informational messages that don't require action
-    WARNING,    ///< Warning conditions that may need attention
-    ERROR,      ///< Error conditions that require attention
-    CRITICAL    ///< Critical conditions that require immediate action
-};
+using AlarmSeverity = common::AlarmSeverity;
 
 /**
  * @struct AlarmAction
@@ -43,7 +45,12 @@ struct AlarmAction {
  */
 struct AlarmConfig {
     int alarm_history_size;                                  ///< Maximum number of alarms to keep in history
+    size_t watch_buffer_size = 256;                          ///< Events buffered per alarm watcher
+    size_t max_watchers = 8;                                 ///< Maximum concurrent alarm watchers
     std::map<std::string, std::vector<std::string>> severity_actions;  ///< Actions for each severity level
+    ActionExecutorSettings action_executor;                  ///< Worker pool, queue and timeout settings
+    AlarmJournalSettings journal;                            ///< Persistent alarm history settings
+    AlarmCorrelationSettings correlation;                    ///< Incident grouping rules
 };
 
 /**
@@ -60,6 +67,8 @@ struct AlarmEntry {
     bool acknowledged;                   ///< Whether alarm has been acknowledged
     std::vector<std::string> actions_taken; ///< Actions that were executed
     int occurrence_count;                ///< Number of times this alarm has been raised
+    int64_t first_time_ms;               ///< First occurrence in milliseconds since the epoch
+    int64_t latest_time_ms;              ///< Latest occurrence in milliseconds since the epoch
 };
 
 /**
@@ -127,6 +136,19 @@ public:
     void register_action(const std::string& action_name, 
                         std::function<void(const std::string&, const std::string&)> callback);
 
+    /**
+     * @brief Registers a latency-critical alarm action
+     *
+     * Fast actions run inline on the thread that delivers the alarm, before the
+     * alarm is stored, logged or any regular action is queued. They must be
+     * short and must not block (e.g. writing fan PWM registers).
+     *
+     * @param action_name Name of the action as used in SeverityActions
+     * @param callback Function to be called when the action is triggered
+     */
+    void register_fast_action(const std::string& action_name,
+                             std::function<void(const std::string&, const std::string&)> callback);
+
     /**
      * @brief Gets the configuration for the alarm system
      * @return Reference to the alarm configuration
@@ -157,13 +179,48 @@ public:
 
     /**
      * @brief Gets alarm statistics for CLI
+     *
+     * Reads the rolling counters maintained on every insert; a 1 hour window has
+     * minute resolution, longer windows (up to 7 days) hour resolution.
+     *
      * @param alarm_name Optional alarm name filter
      * @param time_window_hours Time window for statistics
      * @return Vector of alarm statistics
      */
     std::vector<AlarmStatistics> get_alarm_statistics(const std::string& alarm_name = "", int time_window_hours = 24) const;
 
+    /**
+     * @brief Gets action executor queue metrics for CLI
+     * @return Queue depth, worker and execution counters
+     */
+    ActionExecutorStats get_action_executor_stats() const;
+
+    /**
+     * @brief Subscribes to alarm raise, update and clear events
+     * @param alarm_name Optional alarm source filter
+     * @param min_severity Lowest severity delivered
+     * @return Subscription, or nullptr if the watcher limit is reached
+     * @note Call unwatch_alarms() when done
+     */
+    std::shared_ptr<AlarmSubscription> watch_alarms(const std::string& alarm_name, AlarmSeverity min_severity);
+
+    /**
+     * @brief Ends an alarm event subscription
+     * @param subscription Subscription returned by watch_alarms()
+     */
+    void unwatch_alarms(const std::shared_ptr<AlarmSubscription>& subscription);
+
+    /**
+     * @brief Gets the incidents grouped by the correlation rules for CLI
+     * @param max_incidents Maximum number of incidents to return, 0 for all
+     * @return Incidents, newest first; empty if correlation is disabled
+     */
+    std::vector<AlarmIncident> get_incidents(size_t max_incidents = 0) const;
+
 private:
+    // Drives process_mqtt_alarm_message() directly in the alarm storm benchmark
+    friend struct AlarmStormBenchmarkAccess;
+
     /**
      * @brief Initializes MQTT connection and components
      * @return true if initialization was successful, false otherwise
@@ -176,16 +233,24 @@ private:
      */
     bool load_alarm_configs();
 
+    /**
+     * @brief Restores the alarm history from the journal and starts journaling
+     * @return true if recovery succeeded, false otherwise
+     */
+    bool recover_alarm_history();
+
     /**
      * @brief Processes an alarm by executing its configured actions
      * @param alarm_source Source of the alarm
      * @param severity Severity of the alarm
      * @param message Description of the alarm condition
+     * @param alarm_id Alarm id within the source, empty if unknown
      */
-    void process_alarm(const std::string& alarm_source, AlarmSeverity severity, const std::string& message);
+    void process_alarm(const std::string& alarm_source, AlarmSeverity severity, const std::string& message,
+                       const std::string& alarm_id = "");
 
     /**
-     * @brief Executes actions for a specific severity level
+     * @brief Queues the actions configured for a severity level on the action executor
      * @param severity Severity level
      * @param alarm_source Source of the alarm
      * @param message Alarm message
@@ -193,15 +258,18 @@ private:
     void execute_severity_actions(AlarmSeverity severity, const std::string& alarm_source, const std::string& message);
 
     /**
-     * @brief Adds an alarm entry to the runtime database
-     * @param entry Alarm entry to add
+     * @brief Runs the fast actions configured for a severity level on the calling thread
+     * @param severity Severity level
+     * @param alarm_source Source of the alarm
+     * @param message Alarm message
      */
-    void add_alarm_entry(const AlarmEntry& entry);
+    void execute_fast_actions(AlarmSeverity severity, const std::string& alarm_source, const std::string& message);
 
     /**
-     * @brief Main thread function for alarm processing
+     * @brief Adds an alarm entry to the runtime database
+     * @param entry Alarm entry to add
      */
-    void main_thread_function();
+    void add_alarm_entry(const AlarmEntry& entry);
 
     /**
      * @brief MQTT message callback for receiving alarm-related messages
@@ -212,11 +280,13 @@ private:
     static void mqtt_message_callback(struct mosquitto* mosq, void* obj, const struct mosquitto_message* msg);
 
     /**
-     * @brief Processes incoming MQTT alarm messages
+     * @brief Processes an alarm message as received from MQTT
      * @param topic MQTT topic
-     * @param payload Message payload
+     * @param payload Encoded common::AlarmMessage
+     * @param size Payload size in bytes
+     * @note Called on the MQTT callback thread
      */
-    void process_mqtt_alarm_message(const std::string& topic, const std::string& payload);
+    void process_mqtt_alarm_message(const std::string& topic, const char* payload, size_t size);
 
     /**
      * @brief Converts severity enum to string
@@ -243,17 +313,21 @@ private:
     AlarmConfig alarm_config_;                              ///< Alarm configuration
     mutable std::mutex config_mutex_;                      ///< Mutex for thread-safe config access
     std::map<std::string, std::function<void(const std::string&, const std::string&)>> action_callbacks_; ///< Registered action callbacks
+    std::map<std::string, std::function<void(const std::string&, const std::string&)>> fast_action_callbacks_; ///< Actions run inline on alarm delivery
+    std::unique_ptr<ActionExecutor> action_executor_;      ///< Runs alarm actions off the ingest path
+    std::unique_ptr<AlarmCorrelator> alarm_correlator_;    ///< Groups cascading alarms, nullptr if disabled
 
     // Runtime alarm database
-    std::deque<AlarmEntry> alarm_history_;                ///< Runtime alarm history database
+    std::unique_ptr<AlarmStore> alarm_store_;             ///< Hash-indexed runtime alarm history database
+    std::unique_ptr<AlarmJournal> alarm_journal_;          ///< Persists store mutations across restarts
+    std::unique_ptr<AlarmBroadcaster> alarm_broadcaster_;  ///< Fans history changes out to watchers
     mutable std::mutex history_mutex_;                     ///< Mutex for thread-safe history access
     int max_history_entries_;                              ///< Maximum number of history entries
 
     // Common components
     std::unique_ptr<common::Logger> logger_;               ///< Logger for alarm manager
     
-    // Thread control
-    std::thread main_thread_;                             ///< Main alarm processing thread
+    // State
     std::atomic<bool> running_{false};                    ///< Flag indicating if manager is running
 
     // Name
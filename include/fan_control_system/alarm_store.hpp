@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "fan_control_system/alarm_manager.hpp"
+
+namespace fan_control_system {
+
+/**
+ * @class AlarmStore
+ * @brief Bounded, hash-indexed runtime alarm database
+ *
+ * Entries live in a fixed array of slots that never moves, linked in insertion
+ * order so that the oldest entry can be evicted in O(1) when the store is full.
+ * Source names are interned to small integer ids. A primary hash index keyed by
+ * (source id, severity) finds the entry to deduplicate against in O(1), and a
+ * secondary index by source id lists the k entries of one source for lookup
+ * and clear in O(k).
+ *
+ * Per-source rolling statistics are updated on every insert or update:
+ * occurrence counts per severity in minute buckets (last hour) and hour buckets
+ * (last 7 days), plus first/last occurrence times. Statistics queries therefore
+ * cost a fixed amount of work per source, independent of history size. Hour
+ * buckets are only allocated once a source has been seen for an hour; until
+ * then the minute buckets answer every window. A source's statistics and id
+ * are released together with its last entry, so their memory is bounded by
+ * the capacity. A query is split into snapshot_statistics(), which only copies
+ * the buckets inside the window, and summarize_statistics(), which sums,
+ * formats and sorts them without touching the store.
+ *
+ * The store is not thread-safe; AlarmManager guards it with its history mutex.
+ */
+class AlarmStore {
+public:
+    static constexpr int kSeverityCount = 4;        ///< Number of AlarmSeverity values
+
+    /**
+     * @struct Bucket
+     * @brief Occurrence counters per severity for one minute or hour
+     *
+     * Buckets form rings indexed by period modulo the ring size; a bucket is
+     * reset lazily when it is reused for a newer period.
+     */
+    struct Bucket {
+        int64_t period = -1;                            ///< Minute/hour counted, -1 if unused
+        uint32_t counts[kSeverityCount] = {0, 0, 0, 0}; ///< Occurrences per severity
+    };
+
+    /**
+     * @struct SourceSnapshot
+     * @brief Statistics of one source as copied out of the store
+     */
+    struct SourceSnapshot {
+        std::string name;               ///< Source name
+        int64_t first_ms = 0;           ///< First occurrence (ms since epoch)
+        int64_t last_ms = 0;            ///< Last occurrence (ms since epoch)
+        int32_t active_count = 0;       ///< Active entries of the source
+        int32_t acknowledged_count = 0; ///< Acknowledged entries of the source
+        bool hourly = false;            ///< Whether the buckets are hours rather than minutes
+        size_t first_bucket = 0;        ///< Index of the source's first bucket in StatisticsSnapshot::buckets
+        size_t bucket_count = 0;        ///< Number of buckets of the source
+    };
+
+    /**
+     * @struct StatisticsSnapshot
+     * @brief Raw counters of a statistics query, aggregated by summarize_statistics()
+     */
+    struct StatisticsSnapshot {
+        int window_hours = 1;               ///< Time window in hours, clamped to 1..168
+        int64_t now_ms = 0;                 ///< End of the window (ms since epoch)
+        std::vector<SourceSnapshot> sources;    ///< Sources that may have occurrences inside the window
+        std::vector<Bucket> buckets;        ///< Buckets of all sources, back to back
+    };
+
+    /**
+     * @brief Constructs an empty store
+     * @param capacity Maximum number of entries kept (oldest are evicted first)
+     */
+    explicit AlarmStore(size_t capacity);
+
+    /**
+     * @brief Inserts an entry or updates the existing one with the same source and severity
+     * @param entry Entry to add; its name is the alarm source
+     * @param[out] inserted Set to true if a new entry was created, false if one was updated
+     * @return Reference to the stored entry, valid until the next modification
+     */
+    const AlarmEntry& add_or_update(const AlarmEntry& entry, bool& inserted);
+
+    /**
+     * @brief Looks up the entry for a source and severity
+     * @param source Alarm source name
+     * @param severity Alarm severity
+     * @return Pointer to the entry, or nullptr if none exists
+     */
+    const AlarmEntry* find(const std::string& source, AlarmSeverity severity) const;
+
+    /**
+     * @brief Gets entries in insertion order (oldest first)
+     * @param source Optional source filter, empty for all entries
+     * @param max_entries Maximum number of entries to return, <= 0 for all
+     * @return Copies of the matching entries
+     */
+    std::vector<AlarmEntry> get_entries(const std::string& source = "", int max_entries = -1) const;
+
+    /**
+     * @brief Removes entries
+     * @param source Source whose entries are removed, empty to remove all entries
+     * @return Number of entries removed
+     */
+    int clear(const std::string& source = "");
+
+    /**
+     * @brief Gets rolling statistics per source
+     * @param source Optional source filter, empty for all sources
+     * @param window_hours Time window in hours (1 uses minute buckets, up to 168 uses hour buckets)
+     * @param now_ms Current time in milliseconds since the epoch
+     * @return Statistics for every source with occurrences inside the window
+     */
+    std::vector<AlarmStatistics> get_statistics(const std::string& source, int window_hours, int64_t now_ms) const;
+
+    /**
+     * @brief Copies the counters a statistics query needs, without aggregating them
+     * @param source Optional source filter, empty for all sources
+     * @param window_hours Time window in hours (1 uses minute buckets, up to 168 uses hour buckets)
+     * @param now_ms Current time in milliseconds since the epoch
+     * @param[out] snapshot Receives the counters
+     */
+    void snapshot_statistics(const std::string& source, int window_hours, int64_t now_ms,
+                             StatisticsSnapshot& snapshot) const;
+
+    /**
+     * @brief Aggregates a snapshot into statistics; needs no access to the store
+     * @param snapshot Counters from snapshot_statistics()
+     * @return Statistics for every source with occurrences inside the window, sorted by name
+     */
+    static std::vector<AlarmStatistics> summarize_statistics(const StatisticsSnapshot& snapshot);
+
+    /**
+     * @brief Calls a function for every entry in insertion order
+     * @param visitor Function receiving each entry
+     */
+    void for_each(const std::function<void(const AlarmEntry&)>& visitor) const;
+
+    /**
+     * @brief Appends a compact binary image of all entries and rolling statistics
+     * @param[out] out Buffer the image is appended to
+     */
+    void serialize(std::string& out) const;
+
+    /**
+     * @brief Replaces the store contents with a binary image produced by serialize()
+     * @param data Image to load
+     * @return true on success; on failure the store is left unchanged
+     * @note Entries beyond the capacity are evicted oldest first
+     */
+    bool deserialize(const std::string& data);
+
+    /**
+     * @brief Appends the binary encoding of one entry
+     * @param entry Entry to encode
+     * @param[out] out Buffer the encoding is appended to
+     */
+    static void encode_entry(const AlarmEntry& entry, std::string& out);
+
+    /**
+     * @brief Decodes one entry and advances the read position
+     * @param[in,out] data Read position
+     * @param end End of the readable data
+     * @param[out] entry Decoded entry
+     * @return true on success, false if the data is truncated or malformed
+     */
+    static bool decode_entry(const char*& data, const char* end, AlarmEntry& entry);
+
+    /**
+     * @brief Gets the number of stored entries
+     * @return Entry count
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * @brief Gets the maximum number of entries
+     * @return Store capacity
+     */
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    static constexpr int32_t kNoSlot = -1;
+    static constexpr int kMinuteBuckets = 60;       ///< Minute buckets covering the last hour
+    static constexpr int kHourBuckets = 168;        ///< Hour buckets covering the last 7 days
+
+    using HourBuckets = std::array<Bucket, kHourBuckets>;
+
+    /**
+     * @struct SourceStats
+     * @brief Rolling statistics for one alarm source
+     */
+    struct SourceStats {
+        Bucket minutes[kMinuteBuckets];         ///< Minute buckets of the last hour
+        std::unique_ptr<HourBuckets> hours;     ///< Hour buckets of the last 7 days, null until an hour old
+        int64_t first_ms = 0;                   ///< First occurrence (ms since epoch), 0 if none
+        int64_t last_ms = 0;                    ///< Last occurrence (ms since epoch), 0 if none
+
+        /**
+         * @brief Counts one occurrence, allocating the hour buckets once the source is an hour old
+         */
+        void add(int64_t time_ms, int severity);
+    };
+
+    /**
+     * @brief Counts occurrences in the bucket of their period
+     */
+    static void count(Bucket* ring, int size, int64_t period, const uint32_t (&counts)[kSeverityCount]);
+
+    /**
+     * @struct Slot
+     * @brief Stable storage for one entry plus its insertion-order links
+     */
+    struct Slot {
+        AlarmEntry entry;             ///< Stored alarm entry
+        uint32_t source_id = 0;       ///< Interned source id
+        int32_t prev = kNoSlot;       ///< Previous (older) slot in insertion order
+        int32_t next = kNoSlot;       ///< Next (newer) slot in insertion order
+        bool used = false;            ///< Whether the slot holds an entry
+    };
+
+    /**
+     * @brief Builds the primary index key
+     */
+    static uint64_t make_key(uint32_t source_id, AlarmSeverity severity) {
+        return (static_cast<uint64_t>(source_id) << 8) | static_cast<uint64_t>(severity);
+    }
+
+    /**
+     * @brief Appends a new entry in insertion order, evicting the oldest if full
+     * @return Slot holding the entry
+     */
+    Slot& insert_new(const AlarmEntry& entry);
+
+    /**
+     * @brief Returns the id of a source, interning it if it is new
+     */
+    uint32_t intern(const std::string& source);
+
+    /**
+     * @brief Releases the statistics and id of a source without entries
+     */
+    void forget(uint32_t source_id);
+
+    /**
+     * @brief Looks up the id of a source without interning it
+     * @return true if the source is known
+     */
+    bool lookup(const std::string& source, uint32_t& source_id) const;
+
+    /**
+     * @brief Unlinks a slot from all indexes and returns it to the free list
+     */
+    void release(int32_t slot_index);
+
+    std::vector<Slot> slots_;                                   ///< Stable slot array
+    std::vector<int32_t> free_slots_;                           ///< Unused slot indices
+    int32_t oldest_ = kNoSlot;                                  ///< Head of the insertion-order list
+    int32_t newest_ = kNoSlot;                                  ///< Tail of the insertion-order list
+    size_t size_ = 0;                                           ///< Number of used slots
+
+    std::unordered_map<std::string, uint32_t> source_ids_;      ///< Interned source name -> id
+    std::unordered_map<uint64_t, int32_t> index_;               ///< (source id, severity) -> slot
+    std::unordered_map<uint32_t, std::vector<int32_t>> by_source_; ///< Source id -> slots of that source
+    std::vector<std::string> source_names_;                     ///< Source id -> name, empty if released
+    std::vector<std::unique_ptr<SourceStats>> stats_;           ///< Source id -> rolling statistics, null if released
+    std::vector<uint32_t> free_source_ids_;                     ///< Released source ids
+};
+
+} // namespace fan_control_system
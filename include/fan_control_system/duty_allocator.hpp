@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fan_control_system {
+
+/**
+ * @enum FanAllocationMode
+ * @brief How the control loop's duty cycle is spread over the fans
+ */
+enum class FanAllocationMode : uint8_t {
+    EQUAL = 0,              ///< Every fan runs at the computed duty cycle
+    NOISE_OPTIMIZED = 1     ///< Same total duty cycle, split for the lowest combined noise
+};
+
+/**
+ * @brief Gets the name of an allocation mode for config, logs and RPC
+ * @param mode Allocation mode
+ * @return "Equal" or "NoiseOptimized"
+ */
+const char* fanAllocationModeName(FanAllocationMode mode);
+
+/**
+ * @brief Parses an allocation mode name as returned by fanAllocationModeName()
+ * @param name Mode name
+ * @param mode Parsed mode
+ * @return true if the name is known, false otherwise
+ */
+bool parseFanAllocationMode(const std::string& name, FanAllocationMode& mode);
+
+/**
+ * @brief Sums noise levels in the power domain
+ * @param levels_db Noise levels in dB
+ * @return Combined noise level in dB, 0 if there are no levels
+ */
+double sumNoiseDb(const std::vector<int>& levels_db);
+
+/**
+ * @struct FanNoiseTable
+ * @brief What the allocator knows about one fan
+ */
+struct FanNoiseTable {
+    std::array<int, 101> noise_db{};    ///< Noise level in dB per duty cycle percent
+    int min_duty_cycle = 0;             ///< Lowest duty cycle of the fan model
+    int max_duty_cycle = 100;           ///< Highest duty cycle of the fan model
+    int weight = 1;                     ///< Airflow per duty cycle percent, relative to the other fans
+};
+
+/**
+ * @class DutyAllocator
+ * @brief Precomputed noise-optimal split of a cooling effort over the fans
+ *
+ * The cooling effort of a control tick is the duty cycle the control loop
+ * computed for all fans. Fans move different amounts of air, so each fan's
+ * duty cycle counts with its weight (e.g. MaxRPM x fans of its model) and
+ * the effort asks for a weighted total of sum(weight) x duty cycle. For every
+ * effort from 0 to 100% the constructor solves, by dynamic programming over
+ * the fans' noise tables, which per-fan duty cycles reach at least that
+ * total with the lowest combined noise power (sum of 10^(dB/10)), every fan
+ * staying within its model's duty cycle range and at or above the minimum
+ * duty cycle. Efforts at or below the highest of these lower bounds keep all
+ * fans equal. allocate() is then a table lookup, cheap enough for every
+ * control tick. Running all fans equal is always a candidate, so a plan is
+ * never louder than the equal split.
+ */
+class DutyAllocator {
+public:
+    /**
+     * @brief Solves the allocation for every effort
+     * @param fans Noise table and duty cycle range per fan
+     * @param min_duty_cycle Lowest duty cycle any fan is given when not all are equal
+     */
+    DutyAllocator(const std::vector<FanNoiseTable>& fans, int min_duty_cycle);
+
+    /**
+     * @brief Gets the per-fan duty cycles for a cooling effort
+     * @param effort Duty cycle computed by the control loop, clamped to 0-100
+     * @return Duty cycle per fan, in the order of the fans given to the constructor
+     */
+    const std::vector<uint8_t>& allocate(int effort) const { return plans_[clamp(effort)]; }
+
+    /**
+     * @brief Gets the combined noise of the plan for an effort
+     * @param effort Duty cycle computed by the control loop, clamped to 0-100
+     * @return Noise level in dB
+     */
+    double planNoiseDb(int effort) const { return plan_noise_db_[clamp(effort)]; }
+
+    /**
+     * @brief Gets the combined noise of running all fans equal at an effort
+     * @param effort Duty cycle computed by the control loop, clamped to 0-100
+     * @return Noise level in dB
+     */
+    double equalNoiseDb(int effort) const { return equal_noise_db_[clamp(effort)]; }
+
+private:
+    static constexpr int kMaxWeight = 16;           ///< Largest fan weight used by the dynamic programme
+
+    /**
+     * @brief Clamps an effort to 0-100
+     */
+    static int clamp(int effort) { return effort < 0 ? 0 : effort > 100 ? 100 : effort; }
+
+    /**
+     * @brief Greatest common divisor, gcd(0, b) = b
+     */
+    static int gcd(int a, int b) { return b == 0 ? a : gcd(b, a % b); }
+
+    std::vector<std::vector<uint8_t>> plans_;       ///< Duty cycle per fan, per effort
+    std::array<double, 101> plan_noise_db_;         ///< Combined noise of each plan
+    std::array<double, 101> equal_noise_db_;        ///< Combined noise of the equal split per effort
+};
+
+} // namespace fan_control_system
@@ -2,14 +2,49 @@
 
 #include <string>
 #include <memory>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <vector>
 #include <chrono>
 #include <yaml-cpp/yaml.h>
 #include "common/mqtt_client.hpp"
 #include "common/logger.hpp"
 #include "common/alarm.hpp"
+#include "common/timer_wheel.hpp"
+#include "fan_control_system/register_bank.hpp"
+#include "fan_control_system/tachometer.hpp"
 
 namespace fan_control_system {
 
+/**
+ * @enum FanHealth
+ * @brief Health of a fan as reported in its status
+ */
+enum class FanHealth : uint8_t {
+    GOOD = 0,   ///< Fan accepts speed changes
+    BAD = 1     ///< Fan failed, register writes are rejected
+};
+
+/**
+ * @brief Gets the status name of a fan health as published and returned over RPC
+ * @param health Fan health
+ * @return "Good" or "Bad"
+ */
+const char* fanHealthName(FanHealth health);
+
+/**
+ * @struct FanState
+ * @brief Consistent snapshot of a fan's actuation state
+ */
+struct FanState {
+    uint32_t pwm_count = 0;                 ///< PWM count last written or read back
+    uint8_t duty_cycle = 0;                 ///< Duty cycle percentage (0-100)
+    uint8_t noise_level = 0;                ///< Noise level in dB at the duty cycle
+    FanHealth health = FanHealth::GOOD;     ///< Fan health
+};
+
 /**
  * @class Fan
  * @brief Represents a single fan instance with I2C interface and status monitoring
@@ -17,6 +52,12 @@ namespace fan_control_system {
  * This class manages a single fan instance, providing control over its speed through
  * PWM signals and monitoring its status. It supports I2C communication for speed
  * control and status reporting, with MQTT integration for remote monitoring and control.
+ *
+ * The PWM count, duty cycle, noise level and health are packed into one
+ * 64-bit atomic word. Writers (control loop, RPC handlers, status monitoring)
+ * replace it with a single compare-and-swap, and readers such as GetFanStatus
+ * take a consistent snapshot with one load, so status polling can neither
+ * tear the state nor hold up actuation.
  */
 class Fan {
 public:
@@ -76,30 +117,42 @@ public:
      */
     const std::string& getInterface() const { return interface_; }
 
+    /**
+     * @brief Gets a consistent snapshot of the fan's state
+     * @return PWM count, duty cycle, noise level and health as of one update
+     * @note Wait-free: a single atomic load, never blocks or delays writers
+     */
+    FanState getState() const { return unpackState(state_.load(std::memory_order_acquire)); }
+
+    /**
+     * @brief Gets the health of the fan
+     * @return Current fan health
+     */
+    FanHealth getHealth() const { return getState().health; }
+
     /**
      * @brief Gets the current status of the fan
-     * @return String describing the fan's current status
-     * @note Status can be "GOOD", "BAD", or "NOISY"
+     * @return "Good" or "Bad"
      */
-    const std::string& getStatus() const { return status_; }
+    std::string getStatus() const { return fanHealthName(getHealth()); }
 
     /**
      * @brief Gets the current duty cycle of the fan
      * @return Current duty cycle (0-100)
      */
-    int getDutyCycle() const { return current_duty_cycle_; }
+    int getDutyCycle() const { return getState().duty_cycle; }
 
     /**
      * @brief Gets the current PWM count of the fan
      * @return Current PWM count
      */
-    int getPWMCount() const { return current_pwm_count_; }
+    int getPWMCount() const { return static_cast<int>(getState().pwm_count); }
 
     /**
      * @brief Gets the current noise level of the fan
-     * @return Current noise level (0-100)
+     * @return Current noise level in dB
      */
-    int getNoiseLevel() const { return noise_level_; }
+    int getNoiseLevel() const { return getState().noise_level; }
 
     /**
      * @brief Gets the I2C address of the fan
@@ -139,21 +192,131 @@ public:
     int getDutyCycleMax() const { return duty_cycle_max_; }
 
     /**
-     * @brief Sets the duty cycle of the fan
+     * @brief Routes the fan's register accesses through a register bank
+     * @param bank Opened register bank
+     * @param offset Byte offset of the fan's PWM register in a memory-mapped bank
+     * @return true if the register can be accessed, false otherwise
+     * @note Without a bank, register accesses are only simulated
+     */
+    bool attachRegisterBank(std::shared_ptr<RegisterBank> bank, uint32_t offset);
+
+    /**
+     * @brief Gets the register bank the fan writes through
+     * @return Register bank, nullptr if register accesses are simulated
+     */
+    const std::shared_ptr<RegisterBank>& getRegisterBank() const { return register_bank_; }
+
+    /**
+     * @brief Gets the location of the fan's PWM register
+     * @return Register address
+     */
+    const RegisterAddress& getRegisterAddress() const { return register_address_; }
+
+    /**
+     * @brief Gives the fan a simulated tachometer
+     * @param model Rotor dynamics of the fan model
+     * @param settings Sampling and fault detection settings
+     * @note Must be called before start()
+     */
+    void attachTachometer(const TachModel& model, const TachSettings& settings);
+
+    /**
+     * @brief Gets the fan's tachometer
+     * @return Tachometer, nullptr if the fan has none
+     */
+    const Tachometer* getTachometer() const { return tach_.get(); }
+
+    /**
+     * @brief Samples the tachometer at the current duty cycle
+     * @param now Current steady clock time
+     * @param timestamp_ms Wall clock time of the sample
+     * @return true if the sample confirmed a fault; the fan is then marked bad
+     */
+    bool sampleTachometer(std::chrono::steady_clock::time_point now, int64_t timestamp_ms);
+
+    /**
+     * @brief Gets the speed measured by the tachometer
+     * @return Speed in RPM, -1 if the fan has no tachometer
+     */
+    int getRpm() const { return tach_ ? tach_->getRpm() : -1; }
+
+    /**
+     * @brief Updates the cached duty cycle, PWM count and noise level after a register write
+     * @param duty_cycle Duty cycle written (0-100)
+     * @param pwm_count PWM count written
+     * @note Used after the owner wrote the register as part of a batch; does not publish
+     */
+    void recordPwmCount(int duty_cycle, int pwm_count);
+
+    /**
+     * @brief Reports the outcome of a register write made on the fan's behalf
+     * @param written Whether the PWM count reached the register
+     * @note Raises the "i2c_write" alarm on failure and clears it on success
+     */
+    void reportPwmWrite(bool written);
+
+    /**
+     * @brief Converts a duty cycle to this fan's PWM count
+     * @param duty_cycle Duty cycle percentage, clamped to 0-100
+     * @return PWM count from the precomputed table
+     */
+    int dutyCycleToPwm(int duty_cycle) const {
+        return pwm_by_duty_[duty_cycle < 0 ? 0 : duty_cycle > 100 ? 100 : duty_cycle];
+    }
+
+    /**
+     * @brief Converts a PWM count to this fan's duty cycle
+     * @param pwm_count PWM count, clamped to the fan's PWM range
+     * @return Duty cycle percentage from the precomputed table
+     */
+    int pwmToDutyCycle(int pwm_count) const {
+        int index = pwm_count < pwm_min_ ? 0 : pwm_count > pwm_max_ ? pwm_max_ - pwm_min_ : pwm_count - pwm_min_;
+        return duty_by_pwm_[index];
+    }
+
+    /**
+     * @brief Gets this fan's noise level at a duty cycle
+     * @param duty_cycle Duty cycle percentage, clamped to 0-100
+     * @return Noise level in dB from the precomputed table
+     */
+    int noiseLevelAt(int duty_cycle) const {
+        return noise_by_duty_[duty_cycle < 0 ? 0 : duty_cycle > 100 ? 100 : duty_cycle];
+    }
+
+    /**
+     * @brief Writes a duty cycle to a fan without a register bank
      * @param duty_cycle New duty cycle value (0-100)
      * @param pwm_count New pwm count value based on fan model
      * @return true if the operation was successful, false otherwise
-     * @note The duty cycle is converted to PWM counts based on the fan model
+     * @note Only writes the register and updates the cached state; the caller
+     *       reports the outcome with reportPwmWrite() and publishes the status
+     *       with publishStatus() once all fans are written
+     */
+    bool setPwmCountUrgent(int duty_cycle, int pwm_count);
+
+    /**
+     * @brief Publishes fan status via MQTT
+     * @note This includes current speed, status, and any alarms
      */
-    bool setPwmCount(int duty_cycle, int pwm_count);
+    void publishStatus();
 
     /**
      * @brief Makes the fan report bad status (for testing)
      * @return true if the operation was successful, false otherwise
-     * @note This is used for testing alarm conditions
+     * @note This is used for testing alarm conditions; the tachometer simulates
+     *       the fan model's failure mode, and the fan turns bad when it is detected
      */
     bool makeBad();
 
+    /**
+     * @brief Makes the fan report bad status with a given simulated failure (for testing)
+     * @param fault Failure the tachometer simulates
+     * @return true if the operation was successful, false otherwise
+     * @note With a tachometer only the failure is injected; the fan turns bad
+     *       once the tachometer samples detect it
+     */
+    bool makeBad(TachFault fault);
+
     /**
      * @brief Makes the fan report good status (for testing)
      * @return true if the operation was successful, false otherwise
@@ -163,34 +326,62 @@ public:
 
 private:
     /**
-     * @brief Reads the current pwm count from the I2C register
+     * @brief Reads the current pwm count from the fan's register
      * @return Current pwm count value
      * @note This reads directly from the fan controller's PWM register
      */
-    int readPwmCount();
+    uint32_t readPwmCount();
 
     /**
-     * @brief Writes the pwm count to the I2C register
+     * @brief Writes the pwm count to the fan's register
      * @param pwm_count PWM count value to write
      * @return true if the operation was successful, false otherwise
      * @note This writes directly to the fan controller's PWM register
      */
-    bool writePwmCount(int pwm_count);
+    bool writePwmCount(uint32_t pwm_count);
 
     /**
-     * @brief Publishes fan status via MQTT
-     * @note This includes current speed, status, and any alarms
+     * @brief Precomputes the duty cycle, PWM and noise conversion tables from the model data
      */
-    void publishStatus();
+    void buildLookupTables();
+
+    /**
+     * @brief Packs a state snapshot into the 64-bit word stored in state_
+     */
+    static uint64_t packState(const FanState& state);
+
+    /**
+     * @brief Unpacks the 64-bit word stored in state_
+     */
+    static FanState unpackState(uint64_t packed);
+
+    /**
+     * @brief Applies a change to the fan state and publishes the result atomically
+     * @param update Function modifying a FanState; may run more than once if writers race
+     * @return State after the update
+     */
+    template <typename Update>
+    FanState updateState(Update update) {
+        uint64_t expected = state_.load(std::memory_order_relaxed);
+        FanState state;
+        do {
+            state = unpackState(expected);
+            update(state);
+        } while (!state_.compare_exchange_weak(expected, packState(state),
+                                               std::memory_order_release, std::memory_order_relaxed));
+        return state;
+    }
 
     std::string name_;                                          ///< Name of the fan
     std::string model_name_;                                    ///< Model name of the fan
     uint8_t i2c_address_;                                       ///< I2C address of the fan controller
     uint8_t pwm_reg_;                                          ///< PWM register address
-    std::string status_;                                        ///< Current status of the fan
-    int current_pwm_count_;                                    ///< Current pwm count based on the duty cycle
-    int current_duty_cycle_;                                    ///< Current duty cycle based on the pwm count
+    std::atomic<uint64_t> state_;                               ///< Packed FanState, see packState()
     bool running_;                                              ///< Flag indicating if the fan is running
+    common::TimerWheel::TimerId monitor_timer_;                 ///< Status monitoring timer, 0 when stopped
+    std::shared_ptr<RegisterBank> register_bank_;               ///< Register access backend, nullptr to simulate
+    RegisterAddress register_address_;                          ///< Location of the PWM register
+    std::unique_ptr<Tachometer> tach_;                          ///< Simulated tachometer, nullptr if none
     std::chrono::system_clock::time_point last_update_time_;    ///< Timestamp of last status update
 
     // MQTT and logging components
@@ -203,8 +394,10 @@ private:
     int pwm_max_;                                                ///< PWM maximum value
     int duty_cycle_min_;                                         ///< Duty cycle minimum value
     int duty_cycle_max_;                                         ///< Duty cycle maximum value
-    int noise_level_;                                            ///< Noise level
     std::map<int, int> noise_profile_;                            ///< Noise profile
+    std::array<int, 101> pwm_by_duty_;                             ///< PWM count per duty cycle percent
+    std::array<int, 101> noise_by_duty_;                           ///< Noise level in dB per duty cycle percent
+    std::vector<uint8_t> duty_by_pwm_;                             ///< Duty cycle per PWM count, indexed from pwm_min_
     std::string interface_;                                        ///< Interface of the fan
 };
 
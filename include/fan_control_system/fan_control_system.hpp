@@ -74,6 +74,12 @@ public:
      */
     std::shared_ptr<fan_control_system::AlarmManager> get_alarm_manager() const { return alarm_manager_; }
 
+    /**
+     * @brief Gets the log manager component
+     * @return Pointer to the log manager component, or nullptr if not initialized
+     */
+    fan_control_system::LogManager* get_log_manager() const { return log_manager_.get(); }
+
 private:
     /**
      * @brief Initializes all system components
@@ -99,6 +99,28 @@ public:
                                 const FanNoiseRequest* request,
                                 FanNoiseResponse* response) override;
 
+    /**
+     * @brief Gets the recent tachometer readings of a fan
+     * @param context gRPC server context
+     * @param request Request containing the fan name and the number of samples
+     * @param response Response containing the samples, oldest first, and the fault state
+     * @return gRPC status indicating success or failure
+     */
+    grpc::Status GetFanRpmHistory(grpc::ServerContext* context,
+                                const FanRpmHistoryRequest* request,
+                                FanRpmHistoryResponse* response) override;
+
+    /**
+     * @brief Gets the noise exposure of one or all fans and of all fans combined
+     * @param context gRPC server context
+     * @param request Request containing the fan name, empty for all fans
+     * @param response Response containing the dose settings and the exposures
+     * @return gRPC status indicating success or failure
+     */
+    grpc::Status GetNoiseExposure(grpc::ServerContext* context,
+                                const NoiseExposureRequest* request,
+                                NoiseExposureResponse* response) override;
+
     // Temperature Monitor operations
     /**
      * @brief Gets temperature history from a sensor
@@ -221,6 +243,64 @@ public:
                                   const AlarmStatisticsRequest* request,
                                   AlarmStatisticsResponse* response) override;
 
+    /**
+     * @brief Gets alarm action executor queue metrics
+     * @param context gRPC server context
+     * @param request Empty request
+     * @param response Response containing queue depth, worker and execution counters
+     * @return gRPC status indicating success or failure
+     */
+    grpc::Status GetActionQueueStats(grpc::ServerContext* context,
+                                   const ActionQueueStatsRequest* request,
+                                   ActionQueueStatsResponse* response) override;
+
+    /**
+     * @brief Streams alarm raise, update and clear events as they happen
+     * @param context gRPC server context
+     * @param request Request containing the optional alarm name and minimum severity
+     * @param writer Stream the events are written to
+     * @return gRPC status, RESOURCE_EXHAUSTED if too many watchers are connected
+     * @note Runs until the client cancels or the alarm manager stops
+     */
+    grpc::Status WatchAlarms(grpc::ServerContext* context,
+                           const WatchAlarmsRequest* request,
+                           grpc::ServerWriter<ProtoAlarmEvent>* writer) override;
+
+    /**
+     * @brief Gets the incidents grouped by the alarm correlation rules
+     * @param context gRPC server context
+     * @param request Request containing the maximum number of incidents
+     * @param response Response containing the incidents, newest first
+     * @return gRPC status indicating success or failure
+     */
+    grpc::Status GetIncidents(grpc::ServerContext* context,
+                            const IncidentsRequest* request,
+                            IncidentsResponse* response) override;
+
+    // Logging operations
+    /**
+     * @brief Changes the log level of a named logger or of all loggers
+     * @param context gRPC server context
+     * @param request Request containing the logger name and new level
+     * @param response Response containing the resulting level of every logger
+     * @return gRPC status indicating success or failure
+     * @note The name "LogFile" targets the log manager's file filter only
+     */
+    grpc::Status SetLogLevel(grpc::ServerContext* context,
+                           const SetLogLevelRequest* request,
+                           SetLogLevelResponse* response) override;
+
+    /**
+     * @brief Dumps the in-memory flight recorder to a file
+     * @param context gRPC server context
+     * @param request Request containing an optional dump reason
+     * @param response Response containing the dump file path and record count
+     * @return gRPC status indicating success or failure
+     */
+    grpc::Status DumpFlightRecorder(grpc::ServerContext* context,
+                                  const DumpFlightRecorderRequest* request,
+                                  DumpFlightRecorderResponse* response) override;
+
 private:
     FanControlSystem& system_;  ///< Reference to the fan control system instance
 };
@@ -1,17 +1,22 @@
 #pragma once
 
 #include <memory>
-#include <thread>
 #include <atomic>
 #include <string>
 #include <map>
+#include <vector>
 #include <mutex>
 #include <yaml-cpp/yaml.h>
 #include <mosquitto.h>
 #include "common/mqtt_client.hpp"
 #include "common/logger.hpp"
 #include "fan_control_system/fan.hpp"
+#include "fan_control_system/actuator_queue.hpp"
+#include "fan_control_system/actuation_shaper.hpp"
+#include "fan_control_system/duty_allocator.hpp"
+#include "fan_control_system/noise_dosimeter.hpp"
 #include "common/alarm.hpp"
+#include "common/timer_wheel.hpp"
 
 namespace fan_control_system {
 
@@ -29,6 +34,7 @@ struct FanModel {
     std::string interface;     ///< Interface type (e.g., "I2C")
     uint8_t pwm_reg;          ///< PWM register address
     std::map<int, int> noise_profile; ///< Mapping of duty cycle to noise level in dB
+    TachModel tach;            ///< Rotor dynamics for the simulated tachometer
 };
 
 /**
@@ -64,6 +70,18 @@ enum class NoiseLevel {
  * This class manages a collection of fan instances, each with its own model configuration
  * and noise profile. It handles fan speed control, status monitoring, and noise level
  * management through MQTT communication.
+ *
+ * Speed changes from all sources are submitted to an ActuatorQueue and
+ * written to the registers by its single writer thread, at most once per fan
+ * and tick (`Actuator.TickMs`). With `Actuator.Shaper` enabled, speeds from
+ * the control loop first pass an ActuationShaper that applies hysteresis, a
+ * minimum dwell time and slew limiting; manual and emergency speeds bypass it.
+ * With `FanAllocation.Mode: NoiseOptimized`, a control loop speed is first
+ * split into per-fan speeds by a DutyAllocator.
+ *
+ * Every written speed change is reported to a NoiseDosimeter, which keeps
+ * the noise exposure per fan and combined; the "too_loud" alarm is armed and
+ * cleared on the same changes instead of by polling.
  */
 class FanSimulator {
 public:
@@ -94,9 +112,13 @@ public:
     /**
      * @brief Sets the fan speed for all controllers
      * @param duty_cycle New duty cycle value (0-100)
-     * @return true if the operation was successful, false otherwise
+     * @param source Origin of the command, decides which pending command wins
+     * @return true if the command was queued, false if the duty cycle is invalid
+     * @note The registers are written on the next actuator tick; AUTO speeds may be
+     *       split over the fans, see get_allocation_mode(), and shaped into
+     *       several steps or dropped, see is_actuation_shaped()
      */
-    bool set_fan_speed(int duty_cycle);
+    bool set_fan_speed(int duty_cycle, CommandSource source = CommandSource::AUTO);
 
     /**
      * @brief Gets the current fan speed for a specific controller
@@ -115,9 +137,11 @@ public:
     /**
      * @brief Makes a fan report bad status (for testing)
      * @param name Name of the fan to make bad
+     * @param failure_mode Failure the tachometer simulates ("Stall", "Degraded", "NoSignal"),
+     *        empty for the fan model's failure mode
      * @return true if the operation was successful, false otherwise
      */
-    bool make_fan_bad(const std::string& name);
+    bool make_fan_bad(const std::string& name, const std::string& failure_mode = "");
 
     /**
      * @brief Makes a fan report good status (for testing)
@@ -133,21 +157,113 @@ public:
     const std::map<std::string, std::shared_ptr<Fan>>& get_fans() const { return fans_; }
 
     /**
-     * @brief Sets the fan speed for a specific fan
+     * @brief Sets the fan speed for every fan as a manual override and waits for the writes
+     * @param duty_cycle Duty cycle percentage (0-100)
+     * @param written Receives for every fan name whether its register was written
+     * @return false if the duty cycle is invalid or the writes were not processed in time
+     * @note Bad fans are not written
+     */
+    bool set_all_fan_speeds(int duty_cycle, std::map<std::string, bool>& written);
+
+    /**
+     * @brief Sets the fan speed for a specific fan as a manual override
      * @param fan_name Name of the fan to set the speed for
      * @param duty_cycle Duty cycle percentage (0-100)
-     * @return true if the operation was successful, false otherwise
+     * @return true if the register was written, false if the fan is unknown or bad, the duty cycle
+     *         invalid or the write failed or was superseded
+     * @note Waits for the next actuator tick
      */
     bool set_fan_speed(const std::string& fan_name, int duty_cycle);
 
     /**
-     * @brief Sets the fan PWM for a specific fan
+     * @brief Sets the fan PWM for a specific fan as a manual override
      * @param fan_name Name of the fan to set the PWM for
      * @param pwm_count PWM count value
-     * @return true if the operation was successful, false otherwise
+     * @return true if the register was written, false if the fan is unknown or bad, the count
+     *         invalid or the write failed or was superseded
+     * @note Waits for the next actuator tick
      */
     bool set_fan_pwm(const std::string& fan_name, int pwm_count);
 
+    /**
+     * @brief Writes all queued speed commands now instead of on the next actuator tick
+     * @return true if every command submitted so far has been processed
+     */
+    bool flush_actuation();
+
+    /**
+     * @brief Gets the command and register write counters of a fan
+     * @param fan_name Name of the fan
+     * @return Counters, all zero if the fan is unknown
+     */
+    ActuatorFanStats get_actuator_stats(const std::string& fan_name) const;
+
+    /**
+     * @brief Gets whether control loop speeds pass the actuation shaper
+     * @return true if Actuator.Shaper is enabled
+     */
+    bool is_actuation_shaped() const { return shaper_->settings().enabled; }
+
+    /**
+     * @brief Gets the speed the actuation shaper has the fans at
+     * @return Mean duty cycle last stepped or synced over the fans, -1 if none is known
+     * @note May differ from the last requested speed while ramping or after the shaper dropped it
+     */
+    int get_shaped_speed() const;
+
+    /**
+     * @brief Gets the counters of the actuation shaper
+     * @return Counters summed over all fans
+     */
+    ActuationShaperStats get_shaper_stats() const;
+
+    /**
+     * @brief Gets how control loop speeds are spread over the fans
+     * @return EQUAL unless FanAllocation.Mode is NoiseOptimized
+     */
+    FanAllocationMode get_allocation_mode() const { return allocation_mode_; }
+
+    /**
+     * @brief Gets the combined noise of all fans at their current speeds
+     * @return Noise level in dB, fan levels summed in the power domain
+     */
+    double get_total_noise_db() const;
+
+    /**
+     * @brief Gets the noise exposure of a fan
+     * @param fan_name Name of the fan
+     * @param exposure Current level and rolling windows
+     * @return true if the fan exists, false otherwise
+     */
+    bool get_noise_exposure(const std::string& fan_name, NoiseExposure& exposure) const;
+
+    /**
+     * @brief Gets the noise exposure of all fans combined
+     * @return Current level and rolling windows
+     */
+    NoiseExposure get_combined_noise_exposure() const;
+
+    /**
+     * @brief Gets the noise dose settings
+     * @return Dose criterion and shift length
+     */
+    const NoiseExposureSettings& get_noise_exposure_settings() const { return dosimeter_->settings(); }
+
+    /**
+     * @brief Gets the tachometer settings
+     * @return Sampling and fault detection settings
+     */
+    const TachSettings& get_tach_settings() const { return tach_settings_; }
+
+    /**
+     * @brief Gets the most recent tachometer samples of a fan
+     * @param fan_name Name of the fan
+     * @param max_samples Maximum number of samples, 0 for all kept
+     * @param samples Samples, oldest first
+     * @return true if the fan exists and has a tachometer, false otherwise
+     */
+    bool get_rpm_history(const std::string& fan_name, size_t max_samples, std::vector<TachSample>& samples) const;
+
     /**
      * @brief Gets the noise level for a specific fan
      * @param fan_name Name of the fan to get the noise level for
@@ -161,7 +277,53 @@ public:
      * @return Noise category
      */
     std::string get_fan_noise_category(const std::string& fan_name) const;
+
+    /**
+     * @brief Drives every fan to its maximum duty cycle immediately (MaxFanSpeed action)
+     * @param reason Reason logged with the change (e.g. the alarm source)
+     * @return true if all fans were written successfully, false otherwise
+     * @note Holds the speed as a floor for EmergencyCooling.HoldMs
+     */
+    bool max_fan_speed(const std::string& reason);
+
+    /**
+     * @brief Raises every fan by EmergencyCooling.IncreaseStepPercent immediately (IncreaseFanSpeed action)
+     * @param reason Reason logged with the change (e.g. the alarm source)
+     * @return true if all fans were written successfully, false otherwise
+     * @note Holds the new speed as a floor for EmergencyCooling.HoldMs
+     */
+    bool increase_fan_speed(const std::string& reason);
+
+    /**
+     * @brief Removes the emergency speed floor so regular control can lower the speed again
+     */
+    void clear_speed_floor();
+
+    /**
+     * @brief Gets the emergency speed floor
+     * @return Active floor duty cycle, 0 if none
+     */
+    int get_speed_floor() const;
+
+    /**
+     * @brief Gets the skew of the last batched speed change
+     * @return Time from the first to the last register write in nanoseconds
+     */
+    int64_t get_last_write_skew_ns() const { return last_write_skew_ns_.load(); }
 private:
+    /**
+     * @struct FanWrite
+     * @brief Speed to apply to one fan as part of a batch
+     */
+    struct FanWrite {
+        size_t slot;                ///< Index of the fan in fan_slots_
+        Fan* fan;                   ///< Fan to write
+        int duty_cycle;             ///< Duty cycle to apply
+        int pwm_count;              ///< PWM count for the duty cycle
+        bool attempted = false;     ///< Set if the register write was tried, i.e. the fan is not bad
+        bool written = false;       ///< Set once the register was written
+    };
+
     /**
      * @brief Initializes MQTT connection and components
      * @return true if initialization was successful, false otherwise
@@ -187,38 +349,85 @@ private:
     bool create_fans();
 
     /**
-     * @brief Converts duty cycle to PWM counts for a specific model
-     * @param model Name of the fan model
-     * @param duty_cycle Duty cycle value (0-100)
-     * @return Corresponding PWM count value
+     * @brief Raises the emergency speed floor and writes it to every slower fan
+     * @param duty_cycle New floor duty cycle
+     * @param reason Reason logged with the change
+     * @return true if all fans were written successfully, false otherwise
      */
-    int duty_cycle_to_pwm(const std::string& model, int duty_cycle) const;
+    bool apply_speed_floor(int duty_cycle, const std::string& reason);
 
     /**
-     * @brief Converts PWM counts to duty cycle for a specific model
-     * @param model Name of the fan model
-     * @param pwm PWM count value
-     * @return Corresponding duty cycle value (0-100)
+     * @brief Writes a batch of queued commands; called by the actuator queue
+     * @param commands Commands taken from the queue; their written flags are updated
      */
-    int pwm_to_duty_cycle(const std::string& model, int pwm) const;
+    void apply_commands(std::vector<ActuatorCommand>& commands);
 
     /**
-     * @brief Gets noise level from duty cycle based on noise profile
-     * @param model Name of the fan model
-     * @param duty_cycle Current duty cycle value
-     * @return Noise level in decibels
+     * @brief Queues a duty cycle for every fan
+     * @param duty_cycle Duty cycle to apply
+     * @param source Origin of the command
+     * @return Queue ticket, 0 if nothing was queued
+     */
+    uint64_t submit_all(int duty_cycle, CommandSource source);
+
+    /**
+     * @brief Queues commands past the shaper and records their speeds in it
+     * @param commands Commands to queue
+     * @param report Keep the outcome of each command for ActuatorQueue::wait_applied()
+     * @return Queue ticket, 0 if a fan index is invalid
+     */
+    uint64_t submit_unshaped(const std::vector<ActuatorCommand>& commands, bool report = false);
+
+    /**
+     * @brief Queues manual commands past the shaper and waits until they are processed
+     * @param commands Commands to queue; their written flags are updated
+     * @return true if the commands were processed in time, false otherwise
+     */
+    bool submit_and_wait(std::vector<ActuatorCommand>& commands);
+
+    /**
+     * @brief Spreads a cooling effort over the healthy fans in the noise-optimized mode
+     * @param effort Duty cycle computed by the control loop
+     * @param plan Receives the duty cycle per fan slot
+     * @return true if a plan was made, false in the EQUAL mode
+     */
+    bool allocate_speeds(int effort, std::vector<uint8_t>& plan);
+
+    /**
+     * @brief Solves the allocation plans over the healthy fans; needs allocator_mutex_
+     */
+    void build_allocator();
+
+    /**
+     * @brief Queues the next ramp steps of the shaper; runs every ramp interval
+     */
+    void step_shaper();
+
+    /**
+     * @brief Writes a set of fan speeds, one register batch per bus
+     * @param writes Fan speeds to apply; their written flags are updated
+     * @return Time from the first to the last register write in nanoseconds
+     * @note Only called from apply_commands(), never concurrently
+     */
+    int64_t write_fans(std::vector<FanWrite>& writes);
+
+    /**
+     * @brief Publishes the outcome of a batched speed change as one status message
+     * @param writes Fan speeds that were applied
+     * @param skew_ns Time from the first to the last register write in nanoseconds
      */
-    int get_noise_level(const std::string& model, int duty_cycle) const;
+    void publish_fans_status(const std::vector<FanWrite>& writes, int64_t skew_ns);
 
     /**
-     * @brief Checks for noise conditions and raises alarms if necessary
+     * @brief Accounts written speed changes for noise exposure and the "too_loud" alarm
+     * @param writes Fan speeds that were applied; only written ones are accounted
      */
-    void check_noise_condition();
+    void account_noise(const std::vector<FanWrite>& writes);
 
     /**
-     * @brief Main thread function for fan monitoring
+     * @brief Samples every fan's tachometer; runs every Tachometer.SampleIntervalMs
      */
-    void main_thread_function();
+    void sample_tachometers();
 
     // Configuration
     YAML::Node config_;                                    ///< Loaded configuration data
@@ -226,6 +435,9 @@ private:
     // Fan models and controllers
     std::map<std::string, FanModel> fan_models_;          ///< Map of fan model configurations
     std::map<std::string, std::shared_ptr<Fan>> fans_;    ///< Map of fan instances
+    std::vector<Fan*> fan_slots_;                          ///< Fans by actuator queue index
+    std::map<std::string, size_t> fan_index_;             ///< Actuator queue index by fan name
+    std::shared_ptr<RegisterBank> register_bank_;          ///< Fan register backend, nullptr to simulate
     
     // Current fan speeds
     std::map<std::string, int> current_speeds_;           ///< Current speed for each fan
@@ -236,9 +448,8 @@ private:
     std::shared_ptr<common::MQTTClient> mqtt_client_;      ///< MQTT client for communication
     std::unique_ptr<common::Logger> logger_;               ///< Logger for fan simulator
 
-    // Thread control
+    // Timer control
     std::atomic<bool> running_;                           ///< Flag indicating if simulator is running
-    std::thread main_thread_;                             ///< Main monitoring thread
     
     // Log Level
     std::string log_level_;                               ///< Log level for the simulator
@@ -252,9 +463,36 @@ private:
     // Alarm system
     std::unique_ptr<common::Alarm> alarm_;                ///< Alarm system for noise conditions
 
-    // Noise monitoring
-    std::chrono::system_clock::time_point last_loud_noise_start_time_;  ///< Start time of current loud noise period
+    // Emergency cooling (alarm actions)
+    std::chrono::milliseconds emergency_hold_{30000};    ///< How long an emergency speed is held as a floor
+    int emergency_step_ = 20;                             ///< Duty cycle step of IncreaseFanSpeed
+    std::atomic<int> speed_floor_{0};                     ///< Emergency floor duty cycle, 0 if none
+    std::atomic<int64_t> speed_floor_until_ms_{0};        ///< Steady-clock expiry of the floor in milliseconds
+
+    // Batched actuation
+    std::unique_ptr<ActuatorQueue> actuator_;             ///< Single writer of all fan registers
+    std::chrono::milliseconds actuator_tick_{20};         ///< Minimum interval between register batches
+    std::atomic<int64_t> last_write_skew_ns_{0};          ///< First-to-last register write time of the last batch
+    std::unique_ptr<ActuationShaper> shaper_;             ///< Shapes control loop speeds
+    mutable std::mutex shaper_mutex_;                     ///< Guards shaper_ and orders its submissions
+    common::TimerWheel::TimerId ramp_timer_;              ///< Shaper ramp timer, 0 when stopped
+
+    // Control loop speed allocation
+    FanAllocationMode allocation_mode_ = FanAllocationMode::EQUAL;  ///< How AUTO speeds are spread over the fans
+    int allocation_min_duty_ = 0;                         ///< Lowest per-fan duty cycle of a noise-optimized split
+    std::mutex allocator_mutex_;                          ///< Guards the allocator fields below
+    std::unique_ptr<DutyAllocator> allocator_;            ///< Plans over the healthy fans, nullptr in EQUAL mode
+    std::vector<size_t> allocator_fans_;                  ///< Fan slot of each fan in the allocator's plans
+    std::vector<bool> allocator_bad_;                     ///< Fan health the plans were solved for, per slot
+
+    // Tachometer feedback
+    TachSettings tach_settings_;                          ///< Sampling and fault detection settings
+    common::TimerWheel::TimerId tach_timer_;              ///< Tachometer sampling timer, 0 when stopped
+
+    // Noise monitoring, updated by the fan register writer
+    std::unique_ptr<NoiseDosimeter> dosimeter_;           ///< Noise exposure per fan and combined
     bool is_it_loud_;                                     ///< Flag indicating if noise is currently loud
+    std::atomic<common::TimerWheel::TimerId> loud_timer_; ///< Raises "too_loud" once loud long enough, 0 if not armed or fired
 };
 
 } // namespace fan_control_system 
\ No newline at end of file
@@ -6,7 +6,6 @@
 #include <string>
 #include <fstream>
 #include <mutex>
-#include <queue>
 #include <chrono>
 #include <yaml-cpp/yaml.h>
 #include <mosquitto.h>
@@ -14,6 +13,7 @@
 #include <condition_variable>
 #include "common/mqtt_client.hpp"
 #include "common/logger.hpp"
+#include "common/mpsc_ring.hpp"
 
 using json = nlohmann::json;
 
@@ -31,13 +31,26 @@ struct LogEntry {
     nlohmann::json metadata;  ///< Additional metadata in JSON format
 };
 
+/**
+ * @struct LogQueueStats
+ * @brief Snapshot of the log queue counters
+ */
+struct LogQueueStats {
+    size_t capacity;      ///< Number of preallocated queue slots
+    size_t depth;         ///< Entries currently waiting to be written
+    size_t high_water;    ///< Highest queue depth observed
+    uint64_t enqueued;    ///< Total entries accepted into the queue
+    uint64_t dropped;     ///< Total entries dropped because the queue was full
+};
+
 /**
  * @class LogManager
  * @brief Manages system-wide logging with file rotation and MQTT publishing
  * 
  * This class handles logging of system events with support for different log levels,
  * file-based storage with rotation, and MQTT publishing for real-time monitoring.
- * It maintains a queue of log entries and processes them asynchronously.
+ * Incoming entries are placed in a bounded lock-free ring so that a logging burst
+ * never blocks the MQTT callback thread; the writer thread drains the ring in batches.
  */
 class LogManager {
 public:
@@ -68,8 +81,34 @@ public:
     /**
      * @brief Adds a new log entry to the queue
      * @param entry The log entry to add
+     * @return true if the entry was queued, false if the queue was full and it was dropped
+     */
+    bool add_log(const LogEntry& entry);
+
+    /**
+     * @brief Moves a new log entry into the queue
+     * @param entry The log entry to add
+     * @return true if the entry was queued, false if the queue was full and it was dropped
+     */
+    bool add_log(LogEntry&& entry);
+
+    /**
+     * @brief Gets the current log queue counters
+     * @return Snapshot of queue depth, high-water mark and drop counters
+     */
+    LogQueueStats get_queue_stats() const;
+
+    /**
+     * @brief Sets the minimum level written to the log file
+     * @param level New file log level
+     */
+    void set_file_log_level(common::LogLevel level);
+
+    /**
+     * @brief Gets the minimum level written to the log file
+     * @return Current file log level
      */
-    void add_log(const LogEntry& entry);
+    common::LogLevel get_file_log_level() const;
 
 private:
     /**
@@ -96,6 +135,17 @@ private:
      */
     void write_log_entry(const LogEntry& entry);
 
+    /**
+     * @brief Wakes the writer thread if it is waiting for entries
+     */
+    void notify_consumer();
+
+    /**
+     * @brief Writes every queued entry and flushes the log file once
+     * @return Number of entries written
+     */
+    size_t drain_queue();
+
     /**
      * @brief MQTT message callback for receiving log-related messages
      * @param mosq Pointer to the mosquitto instance
@@ -104,6 +154,12 @@ private:
      */
     static void mqtt_message_callback(struct mosquitto* mosq, void* obj, const struct mosquitto_message* msg);
 
+    /**
+     * @brief Lowers the file level when another process asks for it
+     * @param level_name Requested level name from common::Logger::fileLevelTopic(), empty for no request
+     */
+    void apply_file_level_request(const std::string& level_name);
+
     /**
      * @brief Main thread function for log processing
      */
@@ -122,12 +178,14 @@ private:
     size_t max_log_files_;                                ///< Maximum number of log files to keep
     std::ofstream log_file_;                              ///< Current log file stream
     size_t current_log_size_;                             ///< Current size of the log file
-    common::LogLevel log_level_;                          ///< Current log level
+    std::atomic<common::LogLevel> log_level_{common::LogLevel::INFO}; ///< Minimum level written to the log file
     
     // Log queue
-    std::queue<LogEntry> log_queue_;                      ///< Queue of pending log entries
-    mutable std::mutex queue_mutex_;                      ///< Mutex for thread-safe queue access
-    std::condition_variable queue_cv_;                    ///< Condition variable for queue processing
+    std::unique_ptr<common::MPSCRing<LogEntry>> log_queue_; ///< Bounded lock-free queue of pending log entries
+    std::mutex wait_mutex_;                               ///< Mutex used only while the writer sleeps
+    std::condition_variable queue_cv_;                    ///< Wakes the writer when entries arrive
+    std::atomic<bool> consumer_waiting_{false};           ///< Set while the writer is blocked on queue_cv_
+    uint64_t reported_drops_;                             ///< Drop count already reported to the logger
 
     // MQTT settings and components
     common::MQTTClient::Settings mqtt_settings_;           ///< MQTT communication settings
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace fan_control_system {
+
+/**
+ * @struct NoiseExposureSettings
+ * @brief Dose criterion and shift length (`NoiseExposure`)
+ */
+struct NoiseExposureSettings {
+    double criterion_level_db = 85.0;                   ///< Level allowed for criterion_duration a day
+    std::chrono::minutes criterion_duration{480};       ///< Daily duration of the criterion level
+    std::chrono::minutes shift{480};                    ///< Length of the shift window
+
+    /**
+     * @brief Reads the settings from the NoiseExposure configuration section
+     * @param config NoiseExposure configuration node, may be undefined
+     * @return Settings, defaults for missing keys
+     */
+    static NoiseExposureSettings fromConfig(const YAML::Node& config);
+};
+
+/**
+ * @struct NoiseExposureWindow
+ * @brief Exposure over one rolling window
+ */
+struct NoiseExposureWindow {
+    double leq_db = 0.0;            ///< Equivalent continuous level over the covered time
+    double dose_percent = 0.0;      ///< Share of the daily allowance used within the window
+    double covered_s = 0.0;         ///< Time the window covers, shorter while accounting is young
+};
+
+/**
+ * @struct NoiseExposure
+ * @brief Current level and rolling exposure of one fan or all fans combined
+ */
+struct NoiseExposure {
+    double level_db = 0.0;          ///< Current level
+    uint64_t changes = 0;           ///< Level changes accounted
+    NoiseExposureWindow minute;     ///< Last minute
+    NoiseExposureWindow hour;       ///< Last hour
+    NoiseExposureWindow shift;      ///< Last shift
+};
+
+/**
+ * @class NoiseDosimeter
+ * @brief Event-driven noise dose accounting per fan and for all fans combined
+ *
+ * Levels are only reported when they change. Every channel integrates its
+ * sound energy (10^(dB/10) x seconds) and, when a change arrives, fills in
+ * the energy at each 1 s and 1 min boundary passed since the last one; the
+ * level was constant in between, so this is exact. A rolling window is then
+ * the energy difference between now and the oldest boundary inside it,
+ * giving its Leq and dose without any sampling. A window covers its length
+ * less under one boundary step: 1 s for the minute, 1 min for hour and shift.
+ * The combined channel carries the sum of the fan powers.
+ *
+ * Dose uses the equal-energy rule (3 dB exchange rate): 100% is
+ * criterion_level_db for criterion_duration. All methods are thread-safe.
+ */
+class NoiseDosimeter {
+public:
+    /**
+     * @brief Constructs the dosimeter with all fans silent
+     * @param fan_count Number of fans, addressed by index
+     * @param settings Dose criterion and shift length
+     */
+    NoiseDosimeter(size_t fan_count, const NoiseExposureSettings& settings);
+
+    /**
+     * @brief Starts the accounting from the fans' current levels, dropping earlier exposure
+     * @param levels_db Level per fan
+     * @param now Current time
+     */
+    void start(const std::vector<int>& levels_db, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Records the new level of a fan
+     * @param fan Fan index
+     * @param level_db Level from now on
+     * @param now Time of the change
+     */
+    void record(size_t fan, int level_db, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Gets the exposure of one fan
+     * @param fan Fan index
+     * @param now Current time
+     * @return Current level and windows, all zero for an invalid index
+     */
+    NoiseExposure fanExposure(size_t fan, std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Gets the exposure of all fans combined
+     * @param now Current time
+     * @return Current level and windows
+     */
+    NoiseExposure combinedExposure(std::chrono::steady_clock::time_point now);
+
+    /**
+     * @brief Gets the settings
+     * @return Dose criterion and shift length
+     */
+    const NoiseExposureSettings& settings() const { return settings_; }
+
+private:
+    /**
+     * @struct Boundaries
+     * @brief Energy at the most recent boundaries of one resolution
+     */
+    struct Boundaries {
+        std::vector<double> energy;     ///< Energy at boundary k in slot k % size
+        int64_t last = -1;              ///< Newest boundary filled in, -1 if none
+    };
+
+    /**
+     * @struct Channel
+     * @brief Accounting state of one fan or the combination
+     */
+    struct Channel {
+        double power = 0.0;             ///< Current 10^(dB/10)
+        double energy = 0.0;            ///< Energy up to updated
+        std::chrono::steady_clock::time_point updated;  ///< Time energy refers to
+        uint64_t changes = 0;           ///< Level changes accounted
+        Boundaries seconds;             ///< 1 s boundaries of the last minute
+        Boundaries minutes;             ///< 1 min boundaries of the last hour or shift
+    };
+
+    /**
+     * @brief Brings a channel's energy and boundaries up to now
+     */
+    void advance(Channel& channel, std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Fills in the boundaries of one resolution passed up to now
+     */
+    void fill(const Channel& channel, Boundaries& boundaries, std::chrono::seconds resolution,
+              std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Computes a window ending now from the boundaries of one resolution
+     */
+    NoiseExposureWindow window(const Channel& channel, const Boundaries& boundaries,
+                               std::chrono::seconds resolution, int64_t length,
+                               std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * @brief Brings a channel up to now and computes all its windows
+     */
+    NoiseExposure exposure(Channel& channel, std::chrono::steady_clock::time_point now);
+
+    const NoiseExposureSettings settings_;  ///< Dose criterion and shift length
+    const double dose_energy_;              ///< Energy of a 100% dose
+
+    std::mutex mutex_;                      ///< Guards the fields below
+    std::chrono::steady_clock::time_point origin_;  ///< Start of the accounting, boundary 0
+    std::vector<Channel> fans_;             ///< Channel per fan
+    Channel combined_;                      ///< Channel of all fans combined
+};
+
+} // namespace fan_control_system
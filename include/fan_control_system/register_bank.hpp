@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace fan_control_system {
+
+/**
+ * @struct RegisterAddress
+ * @brief Location of a fan's 32-bit PWM register
+ *
+ * Each backend uses the part of the address that applies to it: the memory
+ * mapped bank uses the byte offset, the I2C bank the device address and
+ * register number.
+ */
+struct RegisterAddress {
+    uint8_t i2c_address = 0;    ///< I2C address of the fan controller
+    uint8_t reg = 0;            ///< Register number on the controller
+    uint32_t offset = 0;        ///< Byte offset in a memory-mapped bank, 4-byte aligned
+};
+
+/**
+ * @struct RegisterWrite
+ * @brief One register write of a batch
+ */
+struct RegisterWrite {
+    RegisterAddress address;    ///< Register location
+    uint32_t value = 0;         ///< Value to write
+    bool written = false;       ///< Set by the bank once the value was written
+};
+
+/**
+ * @class RegisterBank
+ * @brief Hardware abstraction for reading and writing fan controller registers
+ */
+class RegisterBank {
+public:
+    virtual ~RegisterBank() = default;
+
+    /**
+     * @brief Opens the underlying device or file
+     * @return true if the registers can be accessed, false otherwise
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief Writes a 32-bit register
+     * @param address Register location
+     * @param value Value to write
+     * @return true if the value was written, false otherwise
+     */
+    virtual bool write32(const RegisterAddress& address, uint32_t value) = 0;
+
+    /**
+     * @brief Reads a 32-bit register
+     * @param address Register location
+     * @param value Value read
+     * @return true if the value was read, false otherwise
+     */
+    virtual bool read32(const RegisterAddress& address, uint32_t& value) = 0;
+
+    /**
+     * @brief Writes several registers as one transaction where the backend supports it
+     * @param writes Writes to apply; their written flags are updated
+     * @return Number of registers written
+     * @note The default implementation writes the registers one after another
+     */
+    virtual size_t write_batch(std::vector<RegisterWrite>& writes);
+
+    /**
+     * @brief Gets a description of the backend for logs
+     * @return Backend name and device
+     */
+    virtual std::string describe() const = 0;
+
+    /**
+     * @brief Creates the backend selected in the RegisterBank configuration section
+     * @param config RegisterBank configuration node
+     * @return Backend, not yet opened; nullptr if the backend name is unknown
+     */
+    static std::shared_ptr<RegisterBank> create(const YAML::Node& config);
+};
+
+/**
+ * @class MemoryRegisterBank
+ * @brief Register bank simulated in process memory
+ *
+ * The registers start at zero on every run, like the fans' own state, and
+ * are only visible to this process. Writes are single aligned 32-bit stores.
+ */
+class MemoryRegisterBank : public RegisterBank {
+public:
+    /**
+     * @brief Constructs the bank
+     * @param size_bytes Size of the bank in bytes
+     */
+    explicit MemoryRegisterBank(size_t size_bytes);
+
+    bool open() override;
+    bool write32(const RegisterAddress& address, uint32_t value) override;
+    bool read32(const RegisterAddress& address, uint32_t& value) override;
+    std::string describe() const override;
+
+private:
+    /**
+     * @brief Gets the register at a byte offset
+     * @return Register, nullptr if the offset is unaligned or outside the bank
+     */
+    uint32_t* register_at(uint32_t offset);
+
+    size_t size_bytes_;                 ///< Size of the bank in bytes
+    std::vector<uint32_t> registers_;   ///< Register storage, empty until opened
+};
+
+/**
+ * @class MmapRegisterBank
+ * @brief Register bank simulated by a shared memory-mapped file
+ *
+ * The file (for example in /dev/shm) is created if needed and sized to the
+ * bank. Writes are single aligned 32-bit stores into the mapping, so
+ * actuation costs no system call and other processes mapping the same file
+ * see each register change as it happens. The file keeps the last values
+ * across restarts.
+ */
+class MmapRegisterBank : public RegisterBank {
+public:
+    /**
+     * @brief Constructs the bank
+     * @param path File backing the registers
+     * @param size_bytes Size of the bank in bytes
+     */
+    MmapRegisterBank(const std::string& path, size_t size_bytes);
+
+    /**
+     * @brief Unmaps the file
+     */
+    ~MmapRegisterBank() override;
+
+    bool open() override;
+    bool write32(const RegisterAddress& address, uint32_t value) override;
+    bool read32(const RegisterAddress& address, uint32_t& value) override;
+    std::string describe() const override;
+
+private:
+    /**
+     * @brief Gets the register at a byte offset
+     * @return Register, nullptr if the offset is unaligned or outside the bank
+     */
+    uint32_t* register_at(uint32_t offset) const;
+
+    std::string path_;                  ///< File backing the registers
+    size_t size_bytes_;                 ///< Size of the bank in bytes
+    uint32_t* base_ = nullptr;          ///< Start of the mapping, nullptr until opened
+};
+
+/**
+ * @class I2CRegisterBank
+ * @brief Register bank on a Linux i2c-dev bus
+ *
+ * A write sends the register number followed by the value in little-endian
+ * byte order to the fan controller's address; a read writes the register
+ * number and reads 4 bytes back. A batch goes out as one combined transfer
+ * with the writes grouped by controller address.
+ */
+class I2CRegisterBank : public RegisterBank {
+public:
+    /**
+     * @brief Constructs the bank
+     * @param device I2C bus device, e.g. /dev/i2c-1
+     */
+    explicit I2CRegisterBank(const std::string& device);
+
+    /**
+     * @brief Closes the bus device
+     */
+    ~I2CRegisterBank() override;
+
+    bool open() override;
+    bool write32(const RegisterAddress& address, uint32_t value) override;
+    bool read32(const RegisterAddress& address, uint32_t& value) override;
+    size_t write_batch(std::vector<RegisterWrite>& writes) override;
+    std::string describe() const override;
+
+private:
+    /**
+     * @brief Addresses the controller for the following transfer
+     * @note Must be called with mutex_ held
+     */
+    bool select_device(uint8_t i2c_address);
+
+    std::string device_;                ///< I2C bus device
+    int fd_ = -1;                       ///< Bus file descriptor, -1 until opened
+    int selected_address_ = -1;         ///< Controller addressed last, -1 if none
+    std::mutex mutex_;                  ///< Serializes transfers on the bus
+};
+
+} // namespace fan_control_system
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace fan_control_system {
+
+/**
+ * @enum TachFault
+ * @brief Simulated fan failure seen by the tachometer
+ */
+enum class TachFault : uint8_t {
+    NONE = 0,       ///< Rotor follows the commanded speed
+    STALL = 1,      ///< Rotor locked, the tachometer reads 0 RPM
+    DEGRADED = 2,   ///< Worn bearing, the rotor only reaches part of the commanded speed
+    NO_SIGNAL = 3   ///< Broken tachometer line, the rotor turns but reads 0 RPM
+};
+
+/**
+ * @brief Gets the name of a tachometer fault for logs, config and RPC
+ * @param fault Tachometer fault
+ * @return "None", "Stall", "Degraded" or "NoSignal"
+ */
+const char* tachFaultName(TachFault fault);
+
+/**
+ * @brief Parses a tachometer fault name as returned by tachFaultName()
+ * @param name Fault name
+ * @param fault Parsed fault
+ * @return true if the name is known, false otherwise
+ */
+bool parseTachFault(const std::string& name, TachFault& fault);
+
+/**
+ * @struct TachModel
+ * @brief Rotor dynamics of a fan model (`FanModels.<model>.Tach`)
+ */
+struct TachModel {
+    int max_rpm = 3000;                                 ///< Speed at 100% duty cycle
+    int stall_duty_percent = 0;                         ///< Duty cycle below which the rotor stands still
+    std::chrono::milliseconds spin_up_time{1000};       ///< Time constant of speeding up
+    std::chrono::milliseconds spin_down_time{3000};     ///< Time constant of slowing down
+    double degraded_ratio = 0.5;                        ///< Share of the commanded speed reached when DEGRADED
+    TachFault failure_mode = TachFault::STALL;          ///< Fault injected by Fan::makeBad()
+
+    /**
+     * @brief Reads the model from a fan model's Tach configuration section
+     * @param config Tach configuration node, may be undefined
+     * @return Model, defaults for missing keys
+     */
+    static TachModel fromConfig(const YAML::Node& config);
+};
+
+/**
+ * @struct TachSettings
+ * @brief Sampling and fault detection settings (`Tachometer`)
+ */
+struct TachSettings {
+    bool enabled = false;                               ///< Whether the tachometers are sampled
+    std::chrono::milliseconds sample_interval{50};      ///< Time between two samples
+    size_t history_size = 1200;                         ///< Samples kept per fan
+    int fault_tolerance_percent = 20;                   ///< Allowed shortfall against the expected speed
+    int fault_min_rpm = 300;                            ///< Expected speed below which no fault is detected
+    int fault_confirm_samples = 3;                      ///< Consecutive short samples that confirm a fault
+
+    /**
+     * @brief Reads the settings from the Tachometer configuration section
+     * @param config Tachometer configuration node, may be undefined
+     * @return Settings, disabled if the section is missing
+     */
+    static TachSettings fromConfig(const YAML::Node& config);
+};
+
+/**
+ * @struct TachSample
+ * @brief One tachometer reading
+ */
+struct TachSample {
+    int64_t timestamp_ms = 0;       ///< Wall clock time in milliseconds since the epoch
+    uint32_t rpm = 0;               ///< Measured speed
+    uint32_t expected_rpm = 0;      ///< Speed a healthy fan would have at this point
+    uint8_t duty_cycle = 0;         ///< Commanded duty cycle
+};
+
+/**
+ * @class Tachometer
+ * @brief Simulated tachometer of one fan with a fixed-size sample history
+ *
+ * The rotor speed follows the commanded speed as a first-order system, with
+ * separate time constants for speeding up and slowing down. A second,
+ * fault-free copy of the model gives the speed a healthy fan would have, so
+ * spin-up and spin-down are never mistaken for a failure. A fault is
+ * confirmed when the measured speed stays below the expected speed by more
+ * than the tolerance for fault_confirm_samples samples in a row: a stall or a
+ * lost signal within fault_confirm_samples x sample_interval, a degraded fan
+ * once it has slowed down past the tolerance.
+ *
+ * Samples go into a ring of history_size entries allocated up front.
+ * sample() is called by one thread; the other methods may be called from any
+ * thread.
+ */
+class Tachometer {
+public:
+    /**
+     * @brief Constructs the tachometer with the rotor at rest
+     * @param model Rotor dynamics of the fan model
+     * @param settings Sampling and fault detection settings
+     */
+    Tachometer(const TachModel& model, const TachSettings& settings);
+
+    /**
+     * @brief Advances the rotor model to now and records a sample
+     * @param duty_cycle Commanded duty cycle
+     * @param now Current steady clock time
+     * @param timestamp_ms Wall clock time of the sample
+     * @return true if this sample confirmed a fault
+     */
+    bool sample(int duty_cycle, std::chrono::steady_clock::time_point now, int64_t timestamp_ms);
+
+    /**
+     * @brief Injects a simulated failure
+     * @param fault Failure to simulate
+     */
+    void injectFault(TachFault fault);
+
+    /**
+     * @brief Removes a simulated failure and resets the fault detection
+     */
+    void clearFault();
+
+    /**
+     * @brief Gets the injected failure
+     * @return Simulated failure, NONE if the fan is healthy
+     */
+    TachFault getFault() const;
+
+    /**
+     * @brief Gets whether the samples confirmed a fault
+     * @return true from the confirming sample until clearFault()
+     */
+    bool isFaultDetected() const;
+
+    /**
+     * @brief Gets the time from the injected failure to its detection
+     * @return Detection latency in milliseconds, -1 if no injected failure was detected
+     */
+    int64_t getDetectionLatencyMs() const;
+
+    /**
+     * @brief Gets the last measured speed
+     * @return Speed in RPM
+     */
+    int getRpm() const;
+
+    /**
+     * @brief Gets the most recent samples
+     * @param max_samples Maximum number of samples, 0 for all kept
+     * @return Samples, oldest first
+     */
+    std::vector<TachSample> getHistory(size_t max_samples) const;
+
+    /**
+     * @brief Gets the model
+     * @return Rotor dynamics of the fan model
+     */
+    const TachModel& getModel() const { return model_; }
+
+private:
+    /**
+     * @brief Gets the steady speed of a healthy rotor at a duty cycle
+     */
+    double targetRpm(int duty_cycle) const;
+
+    /**
+     * @brief Moves a speed towards a target over a time step with the first-order dynamics
+     */
+    double approach(double rpm, double target, double dt_s) const;
+
+    const TachModel model_;                                 ///< Rotor dynamics
+    const TachSettings settings_;                           ///< Sampling and detection settings
+
+    mutable std::mutex mutex_;                              ///< Guards the fields below
+    double rotor_rpm_ = 0.0;                                ///< Simulated rotor speed
+    double expected_rpm_ = 0.0;                             ///< Speed of the fault-free model
+    TachFault fault_ = TachFault::NONE;                     ///< Injected failure
+    std::chrono::steady_clock::time_point fault_time_;      ///< Time the failure was injected
+    bool detected_ = false;                                 ///< Whether a fault was confirmed
+    int64_t detection_latency_ms_ = -1;                     ///< Injection to detection time
+    int short_samples_ = 0;                                 ///< Consecutive samples below the tolerance
+    bool sampled_ = false;                                  ///< Whether last_sample_ is valid
+    std::chrono::steady_clock::time_point last_sample_;     ///< Time of the previous sample
+    std::vector<TachSample> ring_;                          ///< Sample history, history_size entries
+    size_t next_ = 0;                                       ///< Ring slot of the next sample
+    size_t count_ = 0;                                      ///< Valid samples in the ring
+};
+
+} // namespace fan_control_system
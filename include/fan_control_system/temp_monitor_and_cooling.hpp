@@ -14,6 +14,7 @@
 #include "common/mqtt_client.hpp"
 #include "common/logger.hpp"
 #include "common/alarm.hpp"
+#include "common/timer_wheel.hpp"
 
 namespace fan_control_system {
 
@@ -195,11 +196,6 @@ private:
      */
     void update_fan_speed();
 
-    /**
-     * @brief Main thread function for temperature monitoring
-     */
-    void main_thread_function();
-
     // Configuration
     YAML::Node config_;                                    ///< Loaded configuration data
     
@@ -222,8 +218,8 @@ private:
     // Common Alarm
     std::unique_ptr<common::Alarm> alarm_;               ///< Alarm for temperature monitor
     
-    // Thread control
-    std::thread main_thread_;                             ///< Main monitoring thread
+    // Timer control
+    common::TimerWheel::TimerId update_timer_{0};         ///< Fan speed update timer, 0 when stopped
     std::atomic<bool> running_{false};                    ///< Flag indicating if monitor is running
 
     // Temperature thresholds
@@ -242,6 +238,8 @@ private:
     std::string name_;                                    ///< Name of the temperature monitor
 
     CoolingStatus cooling_status_;
+    bool emergency_floor_active_ = false;                 ///< Whether an alarm action held the fans at the last tick
+    int requested_fan_speed_ = 0;                         ///< Speed last requested from the fan simulator
 };
 
 } // namespace fan_control_system 
\ No newline at end of file
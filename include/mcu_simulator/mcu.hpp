@@ -8,6 +8,7 @@
 #include <mosquitto.h>
 #include <yaml-cpp/yaml.h>
 #include "common/config.hpp"
+#include "common/timer_wheel.hpp"
 
 namespace common {
     class MQTTClient;
@@ -207,6 +208,7 @@ private:
     std::string name_;                                          ///< Name of the MCU
     std::vector<std::unique_ptr<TemperatureSensor>> sensors_;   ///< Vector of temperature sensors
     bool running_;                                              ///< Flag indicating if the MCU is running
+    common::TimerWheel::TimerId publish_timer_;                 ///< Read and publish timer, 0 when stopped
     std::chrono::system_clock::time_point last_read_time_;      ///< Timestamp of last temperature reading
     std::shared_ptr<common::MQTTClient> mqtt_client_;           ///< MQTT client for communication
     std::unique_ptr<common::Logger> logger_;                    ///< Logger for MCU-level logging
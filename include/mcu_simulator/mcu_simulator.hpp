@@ -69,6 +69,15 @@ public:
      */
     const std::vector<std::unique_ptr<MCU>>& getAllMCUs() const { return mcus_; }
 
+    /**
+     * @brief Asks the owner of the log file to write messages down to a level
+     * @param level Lowest level the loggers of this process were set to
+     * @return true if the request was published, false otherwise
+     * @note The log file is written by the fan control system, which only lowers its
+     *       file level on such a request
+     */
+    bool requestFileLogLevel(common::LogLevel level);
+
 private:
     /**
      * @brief Loads configuration from the YAML file
@@ -99,6 +99,30 @@ public:
                                const SensorNoiseRequest* request,
                                FaultResponse* response) override;
 
+    /**
+     * @brief Changes the log level of a named logger or of all loggers
+     * @param context gRPC server context
+     * @param request Request containing the logger name and new level
+     * @param response Response containing the resulting level of every logger
+     * @return gRPC status indicating success or failure
+     * @note The change applies immediately to every logger with a matching name
+     */
+    grpc::Status SetLogLevel(grpc::ServerContext* context,
+                           const SetLogLevelRequest* request,
+                           SetLogLevelResponse* response) override;
+
+    /**
+     * @brief Dumps the in-memory flight recorder to a file
+     * @param context gRPC server context
+     * @param request Request containing an optional dump reason
+     * @param response Response containing the dump file path and record count
+     * @return gRPC status indicating success or failure
+     * @note RPC dumps are never throttled
+     */
+    grpc::Status DumpFlightRecorder(grpc::ServerContext* context,
+                                  const DumpFlightRecorderRequest* request,
+                                  DumpFlightRecorderResponse* response) override;
+
 private:
     MCUSimulator& simulator_;  ///< Reference to the MCU simulator instance
 };
@@ -0,0 +1,169 @@
+#include "common/alarm_message.hpp"
+#include "common/config.hpp"
+#include "common/mqtt_client.hpp"
+#include "fan_control_system/alarm_manager.hpp"
+#include "fan_control_system/fan_simulator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using fan_control_system::AlarmManager;
+using fan_control_system::AlarmSeverity;
+using fan_control_system::CommandSource;
+using fan_control_system::FanSimulator;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Prints min/median/p99/max of a latency sample in microseconds
+ * @param name Label printed with the result
+ * @param samples Latencies in nanoseconds
+ * @param unit What one sample stands for
+ */
+void report(const std::string& name, std::vector<int64_t> samples, const std::string& unit = "alarms") {
+    if (samples.empty()) {
+        std::cout << std::left << std::setw(24) << name << "no samples" << std::endl;
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    auto us = [](int64_t ns) { return ns / 1000.0; };
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+              << "min " << std::setw(9) << us(samples.front()) << " us"
+              << "  p50 " << std::setw(9) << us(samples[samples.size() / 2]) << " us"
+              << "  p99 " << std::setw(9) << us(samples[samples.size() * 99 / 100]) << " us"
+              << "  max " << std::setw(9) << us(samples.back()) << " us"
+              << "  (" << samples.size() << " " << unit << ")" << std::endl;
+}
+
+/**
+ * @brief Measures alarm-to-PWM latency of the MaxFanSpeed action on one delivery path
+ *
+ * Each iteration lowers the fans, raises a CRITICAL alarm and waits until the
+ * action has written the maximum speed to every fan. The action hands the
+ * speed to the actuator thread as an emergency command and returns once it
+ * has been written, after the status report that follows the register
+ * writes, so the time is an upper bound of the alarm-to-PWM latency.
+ *
+ * @param fast Register MaxFanSpeed as a fast (inline) action instead of a queued one
+ * @param via_mqtt Deliver the alarm through the MQTT broker instead of raise_alarm()
+ * @param iterations Number of alarms
+ * @return Latencies in nanoseconds
+ */
+std::vector<int64_t> measure(const YAML::Node& config, const common::MQTTClient::Settings& mqtt_settings,
+                             std::shared_ptr<FanSimulator> fans, bool fast, bool via_mqtt, size_t iterations) {
+    std::atomic<int64_t> written_ns{0};
+    auto action = [fans, &written_ns](const std::string& alarm_source, const std::string&) {
+        fans->max_fan_speed(alarm_source);
+        written_ns = Clock::now().time_since_epoch().count();
+    };
+
+    AlarmManager alarms(config, mqtt_settings);
+    if (fast) {
+        alarms.register_fast_action("MaxFanSpeed", action);
+    } else {
+        alarms.register_action("MaxFanSpeed", action);
+    }
+    if (!alarms.start()) {
+        std::cerr << "Failed to start alarm manager" << std::endl;
+        return {};
+    }
+
+    common::MQTTClient publisher("AlarmCoolingBenchmark", mqtt_settings);
+    if (via_mqtt && (!publisher.initialize() || !publisher.connect())) {
+        std::cerr << "Failed to connect to MQTT broker" << std::endl;
+        return {};
+    }
+    common::AlarmMessage alarm_message;
+    alarm_message.severity = AlarmSeverity::CRITICAL;
+    alarm_message.source = "Bench";
+    alarm_message.alarm_id = "overtemp";
+    alarm_message.message = "benchmark";
+    std::string payload = alarm_message.encode();
+
+    std::vector<int64_t> samples;
+    for (size_t i = 0; i < iterations; ++i) {
+        fans->clear_speed_floor();
+        fans->set_fan_speed(20, CommandSource::MANUAL);
+        fans->flush_actuation();
+        written_ns = 0;
+
+        int64_t start_ns = Clock::now().time_since_epoch().count();
+        if (via_mqtt) {
+            publisher.publish("alarms/Bench", payload);
+        } else {
+            alarms.raise_alarm("Bench", AlarmSeverity::CRITICAL, "benchmark");
+        }
+
+        auto deadline = Clock::now() + std::chrono::seconds(2);
+        while (written_ns.load() == 0 && Clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        if (written_ns.load() != 0) {
+            samples.push_back(written_ns.load() - start_ns);
+        }
+    }
+
+    alarms.stop();
+    fans->clear_speed_floor();
+    return samples;
+}
+
+} // namespace
+
+/**
+ * @brief Compares alarm-to-PWM latency of the fast action path against the action queue
+ *
+ * Usage: alarm_cooling_benchmark [config_file] [iterations] [mqtt]
+ *
+ * With "mqtt" the alarms are published to the broker like an MCU would, so the
+ * broker round trip is included; otherwise they are raised in-process. Also
+ * reports the skew between the first and last fan register write of a
+ * batched set_fan_speed().
+ */
+int main(int argc, char* argv[]) {
+    std::string config_file = argc > 1 ? argv[1] : "config/config.yaml";
+    size_t iterations = argc > 2 ? std::stoul(argv[2]) : 1000;
+    bool via_mqtt = argc > 3 && std::string(argv[3]) == "mqtt";
+
+    auto& config = common::Config::getInstance();
+    if (!config.load(config_file)) {
+        std::cerr << "Failed to load configuration file: " << config_file << std::endl;
+        return 1;
+    }
+    YAML::Node yaml = config.getConfig();
+    // Keep the benchmark free of disk I/O and log noise
+    yaml["Alarms"]["Journal"]["Enabled"] = false;
+    yaml["AppLogLevel"]["FanControlSystem"]["AlarmManager"] = "ERROR";
+    yaml["AppLogLevel"]["FanControlSystem"]["FanSimulator"] = "ERROR";
+
+    auto fans = std::make_shared<FanSimulator>(yaml, config.getMQTTSettings());
+    if (!fans->start()) {
+        std::cerr << "Failed to start fan simulator" << std::endl;
+        return 1;
+    }
+
+    std::cout << iterations << " CRITICAL alarms per path, delivered "
+              << (via_mqtt ? "through the MQTT broker" : "in-process") << std::endl;
+    report("fast action", measure(yaml, config.getMQTTSettings(), fans, true, via_mqtt, iterations));
+    report("queued action", measure(yaml, config.getMQTTSettings(), fans, false, via_mqtt, iterations));
+
+    std::vector<int64_t> skews;
+    skews.reserve(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        fans->set_fan_speed(i % 2 ? 60 : 30, CommandSource::MANUAL);
+        fans->flush_actuation();
+        skews.push_back(fans->get_last_write_skew_ns());
+    }
+    report("batched write skew", skews, "batches");
+
+    fans->stop();
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "common/alarm_message.hpp"
+#include "common/config.hpp"
+#include "fan_control_system/alarm_manager.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using fan_control_system::AlarmManager;
+using fan_control_system::AlarmSeverity;
+
+namespace fan_control_system {
+
+/**
+ * @brief Gives the benchmark access to the alarm manager's MQTT ingestion path
+ */
+struct AlarmStormBenchmarkAccess {
+    static void processMqttAlarmMessage(AlarmManager& manager, const std::string& topic, const char* payload,
+                                        size_t size) {
+        manager.process_mqtt_alarm_message(topic, payload, size);
+    }
+};
+
+} // namespace fan_control_system
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Gets the resident set size of this process
+ * @return VmRSS in kB, 0 if unavailable
+ */
+long residentKb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::stol(line.substr(6));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Source name of the i-th alarm
+ * @param i Alarm number
+ * @param sources Number of distinct sources, 0 for a new source per alarm
+ */
+std::string sourceName(size_t i, size_t sources) {
+    return "Storm" + std::to_string(sources == 0 ? i : i % sources);
+}
+
+/**
+ * @brief Drives one ingestion path of a fresh AlarmManager and prints the results
+ *
+ * Alarms are ingested back to back on one thread, like the MQTT callback
+ * thread, while the reader threads keep calling get_alarm_history() and
+ * get_alarm_statistics(). Severities alternate between INFO and WARNING so no
+ * actions or error logs are involved.
+ *
+ * @param name Label printed with the result
+ * @param config Configuration for the alarm manager
+ * @param mqtt_settings MQTT settings for the alarm manager
+ * @param via_mqtt Ingest encoded messages through process_mqtt_alarm_message() instead of raise_alarm()
+ * @param alarms Number of alarms
+ * @param sources Number of distinct sources, 0 for a new source per alarm
+ * @param readers Number of concurrent reader threads
+ */
+void runStorm(const std::string& name, const YAML::Node& config, const common::MQTTClient::Settings& mqtt_settings,
+              bool via_mqtt, size_t alarms, size_t sources, size_t readers) {
+    // Payloads are prepared up front; encoding is the producer's cost
+    std::vector<std::string> sources_by_alarm;
+    std::vector<std::string> payloads;
+    sources_by_alarm.reserve(alarms);
+    if (via_mqtt) {
+        payloads.reserve(alarms);
+    }
+    for (size_t i = 0; i < alarms; ++i) {
+        sources_by_alarm.push_back(sourceName(i, sources));
+        if (via_mqtt) {
+            common::AlarmMessage message;
+            message.severity = i % 2 ? AlarmSeverity::WARNING : AlarmSeverity::INFO;
+            message.epoch_ns = static_cast<int64_t>(i);
+            message.source = sources_by_alarm.back();
+            message.alarm_id = "storm";
+            message.message = "Alarm storm condition";
+            payloads.push_back(message.encode());
+        }
+    }
+    std::vector<int64_t> latencies(alarms);
+
+    long rss_before = residentKb();
+    AlarmManager manager(config, mqtt_settings);
+    if (!manager.start()) {
+        std::cerr << "Failed to start alarm manager" << std::endl;
+        return;
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::vector<std::thread> reader_threads;
+    for (size_t r = 0; r < readers; ++r) {
+        reader_threads.emplace_back([&manager, &done, &reads, r] {
+            while (!done.load(std::memory_order_relaxed)) {
+                if (r % 2 == 0) {
+                    manager.get_alarm_history("", 100);
+                } else {
+                    manager.get_alarm_statistics("", 1);
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    const std::string topic = "alarms/Storm/raise";
+    auto start = Clock::now();
+    for (size_t i = 0; i < alarms; ++i) {
+        auto begin = Clock::now();
+        if (via_mqtt) {
+            fan_control_system::AlarmStormBenchmarkAccess::processMqttAlarmMessage(
+                manager, topic, payloads[i].data(), payloads[i].size());
+        } else {
+            manager.raise_alarm(sources_by_alarm[i], i % 2 ? AlarmSeverity::WARNING : AlarmSeverity::INFO,
+                                "Alarm storm condition");
+        }
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    done = true;
+    for (auto& thread : reader_threads) {
+        thread.join();
+    }
+    long rss_after = residentKb();
+    size_t history = manager.get_alarm_history().size();
+    manager.stop();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto us = [](int64_t ns) { return ns / 1000.0; };
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(10) << alarms / seconds << " alarms/s"
+              << "  p50 " << std::setw(7) << us(latencies[alarms / 2]) << " us"
+              << "  p99 " << std::setw(7) << us(latencies[alarms * 99 / 100]) << " us"
+              << "  max " << std::setw(8) << us(latencies.back()) << " us"
+              << "  reads/s " << std::setw(9) << reads.load() / seconds
+              << "  history " << history
+              << "  rss +" << (rss_after - rss_before) << " kB" << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Measures how many alarms per second AlarmManager absorbs under concurrent readers
+ *
+ * Usage: alarm_storm_benchmark [config_file] [alarms] [sources] [readers] [history_size]
+ *
+ * sources is the number of distinct alarm sources the alarms cycle through
+ * (0 for a new source per alarm); history_size overrides Alarms.AlarmHistory.
+ */
+int main(int argc, char* argv[]) {
+    std::string config_file = argc > 1 ? argv[1] : "config/config.yaml";
+    size_t alarms = argc > 2 ? std::stoul(argv[2]) : 100000;
+    size_t sources = argc > 3 ? std::stoul(argv[3]) : 0;
+    size_t readers = argc > 4 ? std::stoul(argv[4]) : 2;
+
+    auto& config = common::Config::getInstance();
+    if (!config.load(config_file)) {
+        std::cerr << "Failed to load configuration file: " << config_file << std::endl;
+        return 1;
+    }
+    if (alarms == 0) {
+        std::cerr << "Number of alarms must be positive" << std::endl;
+        return 1;
+    }
+    YAML::Node yaml = config.getConfig();
+    // Measure the in-memory path only
+    yaml["Alarms"]["Journal"]["Enabled"] = false;
+    yaml["Alarms"]["Correlation"]["Enabled"] = false;
+    yaml["AppLogLevel"]["FanControlSystem"]["AlarmManager"] = "ERROR";
+    if (argc > 5) {
+        yaml["Alarms"]["AlarmHistory"] = std::stoi(argv[5]);
+    }
+
+    std::cout << alarms << " alarms from " << (sources == 0 ? "unique" : std::to_string(sources)) << " sources, "
+              << readers << " readers, history size " << yaml["Alarms"]["AlarmHistory"].as<int>() << std::endl;
+    runStorm("raise", yaml, config.getMQTTSettings(), false, alarms, sources, readers);
+    runStorm("mqtt", yaml, config.getMQTTSettings(), true, alarms, sources, readers);
+    return 0;
+}
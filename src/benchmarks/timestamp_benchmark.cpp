@@ -0,0 +1,80 @@
+#include "common/utils.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Reference implementation: the original stringstream + std::localtime formatter
+ * @param tp The timestamp to format
+ * @return Formatted timestamp string in "YYYY-MM-DD HH:MM:SS" format
+ */
+std::string legacyFormatTimestamp(const std::chrono::system_clock::time_point& tp) {
+    auto time = std::chrono::system_clock::to_time_t(tp);
+    std::stringstream ss;
+    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
+    return ss.str();
+}
+
+/**
+ * @brief Runs a formatter over a stream of increasing time points and reports ns per call
+ * @param name Label printed with the result
+ * @param iterations Number of calls to time
+ * @param format Formatter under test
+ */
+template <typename Formatter>
+void runBenchmark(const std::string& name, size_t iterations, Formatter format) {
+    auto base = std::chrono::system_clock::now();
+    size_t total_length = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        // Advance 100us per call so the second changes every 10000 calls, like a busy logger
+        total_length += format(base + std::chrono::microseconds(i * 100)).size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double ns_per_call = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    std::cout << std::left << std::setw(28) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ns_per_call
+              << " ns/call  (checksum " << total_length << ")" << std::endl;
+}
+
+} // namespace
+
+/**
+ * @brief Compares the legacy timestamp formatter against the cached formatters
+ * 
+ * Usage: timestamp_benchmark [iterations] [threads]
+ */
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    size_t threads = argc > 2 ? std::stoul(argv[2]) : 1;
+
+    auto now = std::chrono::system_clock::now();
+    std::cout << "legacy:    " << legacyFormatTimestamp(now) << std::endl;
+    std::cout << "cached:    " << common::utils::formatTimestamp(now) << std::endl;
+    std::cout << "cached ms: " << common::utils::formatTimestampMs(now) << std::endl;
+    std::cout << iterations << " iterations x " << threads << " thread(s)" << std::endl;
+
+    auto run_all = [iterations]() {
+        runBenchmark("legacy formatTimestamp", iterations, legacyFormatTimestamp);
+        runBenchmark("cached formatTimestamp", iterations, common::utils::formatTimestamp);
+        runBenchmark("cached formatTimestampMs", iterations, common::utils::formatTimestampMs);
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(run_all);
+    }
+    run_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return 0;
+}
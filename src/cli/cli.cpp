@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <chrono>
 
 namespace cli {
 
@@ -276,6 +277,22 @@ void CLI::processMCUCommand(const std::string& cmd, std::istringstream& iss) {
             std::cout << "Usage: set_sensor_noise <mcu_name> <sensor_id> <is_noisy>" << std::endl;
         }
     }
+    else if (cmd == "set_log_level") {
+        std::string logger_name, level;
+        if (iss >> logger_name >> level) {
+            setMCULogLevel(logger_name, level);
+        } else {
+            std::cout << "Usage: set_log_level <logger_name|all> <DEBUG|INFO|WARNING|ERROR>" << std::endl;
+        }
+    }
+    else if (cmd == "get_log_levels") {
+        setMCULogLevel("all", "");
+    }
+    else if (cmd == "dump_flight_recorder") {
+        std::string reason;
+        iss >> reason;
+        dumpMCUFlightRecorder(reason);
+    }
     else {
         std::cout << "Unknown command. Type 'help' for available commands." << std::endl;
     }
@@ -319,10 +336,12 @@ void CLI::processFanCommand(const std::string& cmd, std::istringstream& iss) {
     }
     else if (cmd == "make_fan_bad") {
         std::string fan_name;
+        std::string failure_mode;
         if (iss >> fan_name) {
-            makeFanBad(fan_name);
+            iss >> failure_mode;
+            makeFanBad(fan_name, failure_mode);
         } else {
-            std::cout << "Usage: make_fan_bad <fan_name>" << std::endl;
+            std::cout << "Usage: make_fan_bad <fan_name> [Stall|Degraded|NoSignal]" << std::endl;
         }
     }
     else if (cmd == "make_fan_good") {
@@ -333,6 +352,21 @@ void CLI::processFanCommand(const std::string& cmd, std::istringstream& iss) {
             std::cout << "Usage: make_fan_good <fan_name>" << std::endl;
         }
     }
+    else if (cmd == "get_fan_rpm") {
+        std::string fan_name;
+        int32_t count = 20;
+        if (iss >> fan_name) {
+            iss >> count;
+            getFanRpmHistory(fan_name, count);
+        } else {
+            std::cout << "Usage: get_fan_rpm <fan_name> [count]" << std::endl;
+        }
+    }
+    else if (cmd == "get_noise_exposure") {
+        std::string fan_name;
+        iss >> fan_name;
+        getNoiseExposure(fan_name);
+    }
     else if (cmd == "get_fan_noise") {
         std::string fan_name;
         if (iss >> fan_name) {
@@ -397,6 +431,44 @@ void CLI::processFanCommand(const std::string& cmd, std::istringstream& iss) {
             getAlarmStatistics(); // Get all alarm statistics with default 24 hours
         }
     }
+    else if (cmd == "get_action_queue_stats") {
+        getActionQueueStats();
+    }
+    else if (cmd == "get_incidents") {
+        int32_t max_incidents;
+        if (iss >> max_incidents) {
+            getIncidents(max_incidents);
+        } else {
+            getIncidents();
+        }
+    }
+    else if (cmd == "watch_alarms") {
+        int32_t count;
+        std::string alarm_name;
+        if (iss >> count) {
+            iss >> alarm_name;
+            watchAlarms(count, alarm_name);
+        } else {
+            watchAlarms();
+        }
+    }
+    // Logging operations
+    else if (cmd == "set_log_level") {
+        std::string logger_name, level;
+        if (iss >> logger_name >> level) {
+            setFanLogLevel(logger_name, level);
+        } else {
+            std::cout << "Usage: set_log_level <logger_name|LogFile|all> <DEBUG|INFO|WARNING|ERROR>" << std::endl;
+        }
+    }
+    else if (cmd == "get_log_levels") {
+        setFanLogLevel("all", "");
+    }
+    else if (cmd == "dump_flight_recorder") {
+        std::string reason;
+        iss >> reason;
+        dumpFanFlightRecorder(reason);
+    }
     else {
         std::cout << "Unknown command. Type 'help' for available commands." << std::endl;
     }
@@ -425,6 +497,9 @@ void CLI::showMCUHelp() {
     std::cout << "  set_mcu_fault <mcu_name> <is_faulty>  - Set MCU fault state (0=normal, 1=faulty)" << std::endl;
     std::cout << "  set_sensor_fault <mcu_name> <sensor_id> <is_faulty>  - Set sensor fault state (0=normal, 1=faulty)" << std::endl;
     std::cout << "  set_sensor_noise <mcu_name> <sensor_id> <is_noisy>  - Set sensor noise state (0=normal, 1=noisy)" << std::endl;
+    std::cout << "  set_log_level <logger_name|all> <level>  - Set log level (DEBUG, INFO, WARNING, ERROR)" << std::endl;
+    std::cout << "  get_log_levels  - Show log level of every logger" << std::endl;
+    std::cout << "  dump_flight_recorder [reason]  - Dump recent log/alarm records to a file" << std::endl;
 }
 
 void CLI::showFanHelp() {
@@ -434,9 +509,11 @@ void CLI::showFanHelp() {
     std::cout << "  set_fan_speed <fan_name> <duty_cycle> - Set fan speed" << std::endl;
     std::cout << "  set_fan_speed_all <duty_cycle>      - Set all fan speeds" << std::endl;
     std::cout << "  set_fan_pwm <fan_name> <pwm_count>  - Set fan PWM" << std::endl;
-    std::cout << "  make_fan_bad <fan_name>             - Make fan faulty" << std::endl;
+    std::cout << "  make_fan_bad <fan_name> [mode]      - Make fan faulty (Stall, Degraded, NoSignal)" << std::endl;
     std::cout << "  make_fan_good <fan_name>            - Restore fan" << std::endl;
     std::cout << "  get_fan_noise [fan_name]            - Get noise level" << std::endl;
+    std::cout << "  get_fan_rpm <fan_name> [count]      - Get recent tachometer readings (default 20)" << std::endl;
+    std::cout << "  get_noise_exposure [fan_name]       - Get noise exposure and dose" << std::endl;
     std::cout << std::endl;
     std::cout << "  # Temperature operations" << std::endl;
     std::cout << "  get_temp_history                    - Get temperature history for all sensors" << std::endl;
@@ -449,6 +526,14 @@ void CLI::showFanHelp() {
     std::cout << "  get_alarm_history [count]           - Get alarm history (all if no count)" << std::endl;
     std::cout << "  clear_alarm_history [alarm_name]    - Clear alarm history (all if no name)" << std::endl;
     std::cout << "  get_alarm_statistics [alarm_name] [time_window_hours] - Get alarm statistics" << std::endl;
+    std::cout << "  get_action_queue_stats              - Get alarm action queue metrics" << std::endl;
+    std::cout << "  watch_alarms [count] [alarm_name]   - Print the next alarm events as they happen (default 10)" << std::endl;
+    std::cout << "  get_incidents [count]               - Get correlated alarm incidents (all if no count)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  # Logging operations" << std::endl;
+    std::cout << "  set_log_level <logger_name|LogFile|all> <level> - Set log level (DEBUG, INFO, WARNING, ERROR)" << std::endl;
+    std::cout << "  get_log_levels                      - Show log level of every logger" << std::endl;
+    std::cout << "  dump_flight_recorder [reason]       - Dump recent log/alarm records to a file" << std::endl;
     std::cout << std::endl;
     std::cout << "  help                                - Show this help" << std::endl;
     std::cout << "  exit                                - Return to main menu" << std::endl;
@@ -761,6 +846,43 @@ void CLI::setSensorNoise(const std::string& mcu_name, const std::string& sensor_
     }
 }
 
+void CLI::setMCULogLevel(const std::string& logger_name, const std::string& level) {
+    mcu_simulator::SetLogLevelRequest request;
+    request.set_logger_name(logger_name);
+    request.set_level(level);
+
+    mcu_simulator::SetLogLevelResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = mcu_stub_->SetLogLevel(&context, request, &response);
+    if (status.ok()) {
+        if (!response.message().empty()) {
+            std::cout << response.message() << std::endl;
+        }
+        std::cout << "Logger levels:" << std::endl;
+        for (const auto& logger : response.loggers()) {
+            std::cout << "  " << logger.name() << ": " << logger.level() << std::endl;
+        }
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+void CLI::dumpMCUFlightRecorder(const std::string& reason) {
+    mcu_simulator::DumpFlightRecorderRequest request;
+    request.set_reason(reason);
+
+    mcu_simulator::DumpFlightRecorderResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = mcu_stub_->DumpFlightRecorder(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Flight recorder dumped " << response.record_count() << " records to "
+                  << response.file_path() << std::endl;
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
 
 void CLI::getFanStatus(const std::string& fan_name) {
     fan_control_system::FanStatusRequest request;
@@ -779,6 +901,12 @@ void CLI::getFanStatus(const std::string& fan_name) {
             std::cout << "  - Noise Level: " << fan.noise_level_db() << " dB" << std::endl;
             std::cout << "  - Health: " << (fan.status() == "Good" ? "Good" : "Bad") << std::endl;
             std::cout << "  - Model: " << fan.model() << " (" << fan.pwm_min() << "-" << fan.pwm_max() << ")" << std::endl;
+            std::cout << "  - Register Writes: " << fan.register_writes() << " (" << fan.commands_submitted()
+                      << " commands, " << fan.commands_coalesced() << " coalesced)" << std::endl;
+            if (fan.rpm() >= 0) {
+                std::cout << "  - Speed: " << fan.rpm() << " RPM"
+                          << (fan.tach_fault_detected() ? " (failure detected)" : "") << std::endl;
+            }
             std::cout << std::endl;
         }
     } else {
@@ -876,9 +1004,10 @@ void CLI::setFanPWM(const std::string& fan_name, int32_t pwm_count) {
     }
 }
 
-void CLI::makeFanBad(const std::string& fan_name) {
+void CLI::makeFanBad(const std::string& fan_name, const std::string& failure_mode) {
     fan_control_system::FanFaultRequest request;
     request.set_fan_name(fan_name);
+    request.set_failure_mode(failure_mode);
 
     fan_control_system::FaultResponse response;
     grpc::ClientContext context;
@@ -916,6 +1045,67 @@ void CLI::makeFanGood(const std::string& fan_name) {
     }
 }
 
+void CLI::getFanRpmHistory(const std::string& fan_name, int32_t max_samples) {
+    fan_control_system::FanRpmHistoryRequest request;
+    request.set_fan_name(fan_name);
+    request.set_max_samples(max_samples);
+
+    fan_control_system::FanRpmHistoryResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = fan_stub_->GetFanRpmHistory(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Fan: " << response.fan_name() << std::endl;
+        std::cout << "  Current Speed: " << response.current_rpm() << " RPM" << std::endl;
+        std::cout << "  Simulated Failure: " << response.tach_fault() << std::endl;
+        if (response.fault_detected()) {
+            std::cout << "  Failure Detected";
+            if (response.detection_latency_ms() >= 0) {
+                std::cout << " after " << response.detection_latency_ms() << " ms";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "  Samples (every " << response.sample_interval_ms() << " ms, oldest first):" << std::endl;
+        for (const auto& sample : response.samples()) {
+            std::cout << "    " << sample.timestamp_ms() << "  " << sample.duty_cycle() << "%  "
+                      << sample.rpm() << " RPM (expected " << sample.expected_rpm() << ")" << std::endl;
+        }
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+void CLI::getNoiseExposure(const std::string& fan_name) {
+    fan_control_system::NoiseExposureRequest request;
+    request.set_fan_name(fan_name);
+
+    fan_control_system::NoiseExposureResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = fan_stub_->GetNoiseExposure(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Noise Exposure (100% dose = " << response.criterion_level_db() << " dB for "
+                  << response.criterion_hours() << " h, shift " << response.shift_hours() << " h):" << std::endl;
+        auto print_exposure = [](const fan_control_system::ProtoNoiseExposure& exposure) {
+            std::cout << "  " << exposure.name() << ": " << exposure.level_db() << " dB now, "
+                      << exposure.changes() << " changes" << std::endl;
+            auto print_window = [](const char* label, const fan_control_system::ProtoExposureWindow& window) {
+                std::cout << "    " << label << window.leq_db() << " dB Leq, dose " << window.dose_percent()
+                          << "% over " << window.covered_s() << " s" << std::endl;
+            };
+            print_window("Last minute: ", exposure.last_minute());
+            print_window("Last hour:   ", exposure.last_hour());
+            print_window("Shift:       ", exposure.shift());
+        };
+        print_exposure(response.combined());
+        for (const auto& exposure : response.fans()) {
+            print_exposure(exposure);
+        }
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
 void CLI::getFanNoise(const std::string& fan_name) {
     fan_control_system::FanNoiseRequest request;
     request.set_fan_name(fan_name);
@@ -1083,6 +1273,18 @@ void CLI::getCoolingStatus() {
         std::cout << "  Average Temperature: " << response.average_temperature() << "°C" << std::endl;
         std::cout << "  Current Fan Speed: " << response.current_fan_speed() << "%" << std::endl;
         std::cout << "  Cooling Mode: " << response.cooling_mode() << std::endl;
+        const auto& shaper = response.shaper();
+        if (shaper.enabled()) {
+            std::cout << "  Actuation Shaper: " << shaper.writes() << " steps for " << shaper.requests()
+                      << " requests (unchanged " << shaper.avoided_unchanged()
+                      << ", hysteresis " << shaper.avoided_hysteresis()
+                      << ", dwell " << shaper.deferred_dwell()
+                      << ", slew limited " << shaper.slew_limited() << ")" << std::endl;
+        }
+        if (!response.fan_allocation().empty()) {
+            std::cout << "  Fan Allocation: " << response.fan_allocation() << std::endl;
+            std::cout << "  Total Fan Noise: " << response.total_noise_db() << " dB" << std::endl;
+        }
     } else {
         std::cout << "RPC failed: " << status.error_message() << std::endl;
     }
@@ -1274,4 +1476,148 @@ void CLI::getAlarmStatistics(const std::string& alarm_name, int32_t time_window_
     }
 }
 
-} // namespace cli 
\ No newline at end of file
+void CLI::getActionQueueStats() {
+    fan_control_system::ActionQueueStatsRequest request;
+    fan_control_system::ActionQueueStatsResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = fan_stub_->GetActionQueueStats(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Alarm Action Queue:" << std::endl;
+        std::cout << "  Workers: " << response.workers() << " (" << response.running() << " running)" << std::endl;
+        std::cout << "  Pending: " << response.pending() << " (high water " << response.high_water() << ")" << std::endl;
+        std::cout << "  Submitted: " << response.submitted() << std::endl;
+        std::cout << "  Coalesced: " << response.coalesced() << std::endl;
+        std::cout << "  Dropped: " << response.dropped() << std::endl;
+        std::cout << "  Executed: " << response.executed() << std::endl;
+        std::cout << "  Failed: " << response.failed() << std::endl;
+        std::cout << "  Timed Out: " << response.timed_out() << std::endl;
+        std::cout << "  Max Queue Wait: " << response.max_wait_ms() << " ms" << std::endl;
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+void CLI::getIncidents(int32_t max_incidents) {
+    fan_control_system::IncidentsRequest request;
+    fan_control_system::IncidentsResponse response;
+    grpc::ClientContext context;
+
+    request.set_max_incidents(max_incidents);
+    grpc::Status status = fan_stub_->GetIncidents(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Alarm Incidents (" << response.incidents_size() << "):" << std::endl;
+        for (const auto& incident : response.incidents()) {
+            std::cout << "  #" << incident.id() << " " << incident.rule()
+                      << (incident.key().empty() ? "" : " " + incident.key())
+                      << (incident.open() ? " [open]" : " [closed]") << std::endl;
+            std::cout << "    Root Cause: " << incident.root_source() << " - " << incident.root_message() << std::endl;
+            std::cout << "    Severity: " << severityToString(incident.severity()) << std::endl;
+            std::cout << "    First: " << incident.first_timestamp() << "  Latest: " << incident.latest_timestamp() << std::endl;
+            std::cout << "    Alarms: " << incident.alarm_count()
+                      << " (actions suppressed for " << incident.suppressed_actions() << ")" << std::endl;
+            for (const auto& member : incident.members()) {
+                std::cout << "      " << member.first << ": " << member.second << std::endl;
+            }
+        }
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+void CLI::watchAlarms(int32_t count, const std::string& alarm_name) {
+    fan_control_system::WatchAlarmsRequest request;
+    request.set_alarm_name(alarm_name);
+    request.set_min_severity(fan_control_system::ProtoAlarmSeverity::PROTO_ALARM_INFO);
+
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + std::chrono::seconds(60));
+
+    auto reader = fan_stub_->WatchAlarms(&context, request);
+    std::cout << "Watching alarms" << (alarm_name.empty() ? "" : " for " + alarm_name)
+              << " (" << count << " events)..." << std::endl;
+
+    fan_control_system::ProtoAlarmEvent event;
+    int32_t received = 0;
+    uint64_t dropped = 0;
+    while (received < count && reader->Read(&event)) {
+        received++;
+        const char* type = "RAISED";
+        switch (event.type()) {
+            case fan_control_system::PROTO_ALARM_EVENT_UPDATED: type = "UPDATED"; break;
+            case fan_control_system::PROTO_ALARM_EVENT_CLEARED: type = "CLEARED"; break;
+            case fan_control_system::PROTO_ALARM_EVENT_HISTORY_CLEARED: type = "HISTORY_CLEARED"; break;
+            default: break;
+        }
+        std::cout << "[" << event.sequence() << "] " << event.timestamp() << " " << type << " "
+                  << (event.alarm_name().empty() ? "*" : event.alarm_name());
+        if (event.type() == fan_control_system::PROTO_ALARM_EVENT_HISTORY_CLEARED) {
+            std::cout << " (" << event.cleared_entries() << " entries)" << std::endl;
+        } else {
+            if (!event.alarm_id().empty()) {
+                std::cout << "/" << event.alarm_id();
+            }
+            std::cout << " " << severityToString(event.severity()) << ": " << event.message();
+            if (event.occurrence_count() > 0) {
+                std::cout << " (occurrence #" << event.occurrence_count() << ")";
+            }
+            std::cout << std::endl;
+        }
+        if (event.dropped_events() > dropped) {
+            std::cout << "  (" << event.dropped_events() - dropped << " events dropped, watcher too slow)" << std::endl;
+            dropped = event.dropped_events();
+        }
+    }
+
+    if (received < count) {
+        grpc::Status status = reader->Finish();
+        if (!status.ok() && status.error_code() != grpc::StatusCode::DEADLINE_EXCEEDED) {
+            std::cout << "RPC failed: " << status.error_message() << std::endl;
+        }
+    } else {
+        context.TryCancel();
+        reader->Finish();
+    }
+    std::cout << "Received " << received << " alarm events" << std::endl;
+}
+
+void CLI::setFanLogLevel(const std::string& logger_name, const std::string& level) {
+    fan_control_system::SetLogLevelRequest request;
+    request.set_logger_name(logger_name);
+    request.set_level(level);
+
+    fan_control_system::SetLogLevelResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = fan_stub_->SetLogLevel(&context, request, &response);
+    if (status.ok()) {
+        if (!response.message().empty()) {
+            std::cout << response.message() << std::endl;
+        }
+        std::cout << "Log file level: " << response.file_level() << std::endl;
+        std::cout << "Logger levels:" << std::endl;
+        for (const auto& logger : response.loggers()) {
+            std::cout << "  " << logger.name() << ": " << logger.level() << std::endl;
+        }
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+void CLI::dumpFanFlightRecorder(const std::string& reason) {
+    fan_control_system::DumpFlightRecorderRequest request;
+    request.set_reason(reason);
+
+    fan_control_system::DumpFlightRecorderResponse response;
+    grpc::ClientContext context;
+
+    grpc::Status status = fan_stub_->DumpFlightRecorder(&context, request, &response);
+    if (status.ok()) {
+        std::cout << "Flight recorder dumped " << response.record_count() << " records to "
+                  << response.file_path() << std::endl;
+    } else {
+        std::cout << "RPC failed: " << status.error_message() << std::endl;
+    }
+}
+
+} // namespace cli
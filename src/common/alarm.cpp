@@ -1,16 +1,21 @@
 #include "common/alarm.hpp"
-#include "common/utils.hpp"
-#include <sstream>
-
-using json = nlohmann::json;
+#include "common/flight_recorder.hpp"
+#include "common/config.hpp"
 
 namespace common {
 
+namespace {
+
+const char* const kDefaultAlarmId = "default";  ///< Id used by the raise/clear overloads without an id
+
+} // namespace
+
 /**
  * @brief Constructs a new Alarm instance
  * 
  * Initializes the alarm with the given name and MQTT client. Sets up the MQTT topic
- * prefix for alarm messages and initializes the alarm state as inactive.
+ * prefix for alarm messages and reads the debouncing settings for this alarm
+ * system from the configuration.
  * 
  * @param name Name of the alarm system (used in MQTT topics)
  * @param mqtt_client Shared pointer to MQTT client for publishing alarms
@@ -19,73 +24,218 @@ Alarm::Alarm(const std::string& name, std::shared_ptr<MQTTClient> mqtt_client)
     : name_(name)
     , mqtt_client_(mqtt_client)
     , topic_prefix_("alarms/" + name)
-    , active_(false)
-    , current_severity_(AlarmSeverity::LOW)
+    , debounce_(Config::getInstance().getAlarmDebounce(name))
 {
 }
 
 /**
- * @brief Raises an alarm with the specified severity and message
+ * @brief Raises the alarm condition identified by alarm_id
  * 
- * Sets the alarm as active and publishes the alarm message to MQTT.
- * The message is published to the topic "alarms/{name}/raise".
+ * Publishes to "alarms/{name}/raise" only when the condition becomes active,
+ * changes severity (immediately, even within the hold-down), or has been
+ * active for a full re-raise interval since the last publish; other calls
+ * just update the tracked message and are counted as suppressed. A condition
+ * that was cleared less than the hold-down interval ago is tracked as active
+ * but not republished until the hold-down has passed, so it is picked up by
+ * a later raise while the condition persists. Published raises are written
+ * to the flight recorder; CRITICAL ones also trigger a (throttled) flight
+ * recorder dump once the raise has been published.
  * 
+ * @param alarm_id Stable id of the condition
  * @param severity The severity level of the alarm
  * @param message Description of the alarm condition
  */
-void Alarm::raise(AlarmSeverity severity, const std::string& message) {
-    active_ = true;
-    current_severity_ = severity;
-    mqtt_client_->publish(topic_prefix_ + "/raise", formatAlarmMessage(severity, message));
+void Alarm::raise(const std::string& alarm_id, AlarmSeverity severity, const std::string& message) {
+    auto now = std::chrono::steady_clock::now();
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        State& state = states_[alarm_id];
+
+        bool severity_changed = state.active && state.published && severity != state.severity;
+        if (!state.active || severity != state.severity) {
+            state.active = true;
+            state.published = false;
+            state.severity = severity;
+        }
+
+        bool publish;
+        if (!state.published) {
+            publish = severity_changed || !state.ever_cleared ||
+                      now - state.last_clear >= std::chrono::milliseconds(debounce_.hold_down_ms);
+        } else {
+            publish = debounce_.reraise_interval_sec > 0 &&
+                      now - state.last_publish >= std::chrono::seconds(debounce_.reraise_interval_sec);
+        }
+
+        if (!publish) {
+            state.suppressed++;
+            suppressed_total_++;
+            return;
+        }
+
+        payload = formatAlarmMessage(alarm_id, severity, message, false, state.suppressed);
+        state.published = true;
+        state.last_publish = now;
+        state.suppressed = 0;
+    }
+
+    auto& recorder = FlightRecorder::getInstance();
+    recorder.recordAlarm(severity, name_, message, false);
+    mqtt_client_->publish(topic_prefix_ + "/raise", payload);
+    // The dump writes a file; do it after the alarm is on its way, not in front of it
+    if (severity == AlarmSeverity::CRITICAL) {
+        recorder.dump("critical_alarm", false);
+    }
+}
+
+/**
+ * @brief Clears the alarm condition identified by alarm_id
+ * 
+ * If the condition is active, marks it inactive and publishes a clear message to
+ * "alarms/{name}/clear". A condition whose raise was never published (still in
+ * hold-down) is cleared silently.
+ * 
+ * @param alarm_id Stable id of the condition
+ * @param message Description of why the alarm is being cleared
+ */
+void Alarm::clear(const std::string& alarm_id, const std::string& message) {
+    AlarmSeverity severity;
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = states_.find(alarm_id);
+        if (it == states_.end() || !it->second.active) {
+            return;
+        }
+
+        State& state = it->second;
+        bool was_published = state.published;
+        severity = state.severity;
+        state.active = false;
+        state.published = false;
+        state.suppressed = 0;
+        if (!was_published) {
+            return;
+        }
+        state.ever_cleared = true;
+        state.last_clear = std::chrono::steady_clock::now();
+        payload = formatAlarmMessage(alarm_id, severity, message, true);
+    }
+
+    FlightRecorder::getInstance().recordAlarm(severity, name_, message, true);
+    mqtt_client_->publish(topic_prefix_ + "/clear", payload);
 }
 
 /**
- * @brief Clears the current alarm
+ * @brief Raises an alarm under the alarm system's default id
  * 
- * If an alarm is active, clears it and publishes a clear message to MQTT.
- * The message is published to the topic "alarms/{name}/clear".
+ * @param severity The severity level of the alarm
+ * @param message Description of the alarm condition
+ */
+void Alarm::raise(AlarmSeverity severity, const std::string& message) {
+    raise(kDefaultAlarmId, severity, message);
+}
+
+/**
+ * @brief Clears the alarm under the alarm system's default id
  * 
  * @param message Description of why the alarm is being cleared
  */
 void Alarm::clear(const std::string& message) {
-    if (!active_) return;
-    
-    active_ = false;
-    mqtt_client_->publish(topic_prefix_ + "/clear", formatAlarmMessage(current_severity_, message, true));
-    current_severity_ = AlarmSeverity::LOW;
+    clear(kDefaultAlarmId, message);
 }
 
 /**
- * @brief Formats an alarm message for MQTT publishing
+ * @brief Replaces the debouncing settings
  * 
- * Creates a JSON object containing the alarm details including timestamp,
- * severity, source, message, and state (raised/cleared).
+ * @param debounce New hold-down and re-raise intervals
+ */
+void Alarm::setDebounce(const AlarmDebounce& debounce) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    debounce_ = debounce;
+}
+
+/**
+ * @brief Checks if any alarm condition is active
  * 
- * @param severity The severity level of the alarm
- * @param message The alarm message
- * @param is_clear Whether this is a clear message (true) or raise message (false)
- * @return Formatted JSON string containing the alarm message
+ * @return true if an alarm is active, false otherwise
  */
-std::string Alarm::formatAlarmMessage(AlarmSeverity severity, const std::string& message, bool is_clear) {
-    json alarm_entry = {
-        {"timestamp", getTimestamp()},
-        {"severity", static_cast<int>(severity)},
-        {"source", name_},
-        {"message", message},
-        {"state", is_clear ? "cleared" : "raised"}
-    };
-    return alarm_entry.dump();
+bool Alarm::isActive() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& pair : states_) {
+        if (pair.second.active) {
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
- * @brief Gets the current timestamp in human-readable format
+ * @brief Checks if a specific alarm condition is active
  * 
- * Formats the current system time as "YYYY-MM-DD HH:MM:SS"
+ * @param alarm_id Stable id of the condition
+ * @return true if the condition is active, false otherwise
+ */
+bool Alarm::isActive(const std::string& alarm_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = states_.find(alarm_id);
+    return it != states_.end() && it->second.active;
+}
+
+/**
+ * @brief Gets the highest severity among the active alarm conditions
  * 
- * @return Timestamp string in the format "YYYY-MM-DD HH:MM:SS"
+ * @return The current alarm severity level (INFO if none is active)
+ */
+AlarmSeverity Alarm::getCurrentSeverity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AlarmSeverity severity = AlarmSeverity::INFO;
+    for (const auto& pair : states_) {
+        if (pair.second.active && pair.second.severity > severity) {
+            severity = pair.second.severity;
+        }
+    }
+    return severity;
+}
+
+/**
+ * @brief Gets the number of raises that were not published because nothing changed
+ * 
+ * @return Suppressed raise count since construction
+ */
+uint64_t Alarm::getSuppressedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return suppressed_total_;
+}
+
+/**
+ * @brief Encodes an alarm message for MQTT publishing
+ * 
+ * Fills an AlarmMessage with the alarm details (current time in nanoseconds,
+ * severity, source, alarm id, message, raised/cleared state and the number of
+ * raises suppressed since the previous publish of this alarm id) and returns
+ * its binary encoding.
+ * 
+ * @param alarm_id Stable id of the condition
+ * @param severity The severity level of the alarm
+ * @param message The alarm message
+ * @param is_clear Whether this is a clear message (true) or raise message (false)
+ * @param suppressed Number of raises suppressed since the previous publish
+ * @return Encoded AlarmMessage
  */
-std::string Alarm::getTimestamp() {
-    return utils::getCurrentTimestamp();
+std::string Alarm::formatAlarmMessage(const std::string& alarm_id, AlarmSeverity severity, const std::string& message,
+                                      bool is_clear, uint32_t suppressed) {
+    AlarmMessage alarm_message;
+    alarm_message.state = is_clear ? AlarmMessage::State::CLEARED : AlarmMessage::State::RAISED;
+    alarm_message.severity = severity;
+    alarm_message.suppressed = suppressed;
+    alarm_message.epoch_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    alarm_message.source = name_;
+    alarm_message.alarm_id = alarm_id;
+    alarm_message.message = message;
+    return alarm_message.encode();
 }
 
 } // namespace common 
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "common/alarm_message.hpp"
+#include <algorithm>
+
+namespace common {
+
+namespace {
+
+const uint8_t kFormatVersion = 1;   ///< Version byte of the current layout
+
+void putLE(char* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint64_t getLE(const char* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+const size_t AlarmMessage::kHeaderSize;
+const size_t AlarmMessage::kMaxFieldSize;
+
+/**
+ * @brief Gets the name of a severity as used in the configuration
+ *
+ * @param severity Severity level
+ * @return "INFO", "WARNING", "ERROR" or "CRITICAL" ("UNKNOWN" for invalid values)
+ */
+const char* alarmSeverityName(AlarmSeverity severity) {
+    static const char* const kNames[] = {"INFO", "WARNING", "ERROR", "CRITICAL"};
+    auto index = static_cast<uint8_t>(severity);
+    return index < 4 ? kNames[index] : "UNKNOWN";
+}
+
+/**
+ * @brief Encodes the message into its binary wire format
+ *
+ * Strings longer than kMaxFieldSize bytes are truncated.
+ *
+ * @return Encoded bytes
+ */
+std::string AlarmMessage::encode() const {
+    size_t source_size = std::min(source.size(), kMaxFieldSize);
+    size_t alarm_id_size = std::min(alarm_id.size(), kMaxFieldSize);
+    size_t message_size = std::min(message.size(), kMaxFieldSize);
+
+    std::string out(kHeaderSize + source_size + alarm_id_size + message_size, '\0');
+    char* p = &out[0];
+    p[0] = static_cast<char>(kFormatVersion);
+    p[1] = static_cast<char>(state);
+    p[2] = static_cast<char>(severity);
+    putLE(p + 4, suppressed, 4);
+    putLE(p + 8, static_cast<uint64_t>(epoch_ns), 8);
+    putLE(p + 16, source_size, 2);
+    putLE(p + 18, alarm_id_size, 2);
+    putLE(p + 20, message_size, 2);
+
+    p += kHeaderSize;
+    std::copy(source.data(), source.data() + source_size, p);
+    p += source_size;
+    std::copy(alarm_id.data(), alarm_id.data() + alarm_id_size, p);
+    p += alarm_id_size;
+    std::copy(message.data(), message.data() + message_size, p);
+    return out;
+}
+
+/**
+ * @brief Decodes a message from its binary wire format
+ *
+ * Rejects unknown versions, out-of-range state or severity values and sizes
+ * that do not match the header.
+ *
+ * @param data Encoded bytes
+ * @param size Number of bytes
+ * @param out Decoded message
+ * @return true if the bytes are a complete, valid message, false otherwise
+ */
+bool AlarmMessage::decode(const char* data, size_t size, AlarmMessage& out) {
+    if (size < kHeaderSize || static_cast<uint8_t>(data[0]) != kFormatVersion) {
+        return false;
+    }
+    auto state = static_cast<uint8_t>(data[1]);
+    auto severity = static_cast<uint8_t>(data[2]);
+    if (state > static_cast<uint8_t>(State::CLEARED) || severity > static_cast<uint8_t>(AlarmSeverity::CRITICAL)) {
+        return false;
+    }
+    size_t source_size = getLE(data + 16, 2);
+    size_t alarm_id_size = getLE(data + 18, 2);
+    size_t message_size = getLE(data + 20, 2);
+    if (size != kHeaderSize + source_size + alarm_id_size + message_size) {
+        return false;
+    }
+
+    out.state = static_cast<State>(state);
+    out.severity = static_cast<AlarmSeverity>(severity);
+    out.suppressed = static_cast<uint32_t>(getLE(data + 4, 4));
+    out.epoch_ns = static_cast<int64_t>(getLE(data + 8, 8));
+    const char* p = data + kHeaderSize;
+    out.source.assign(p, source_size);
+    p += source_size;
+    out.alarm_id.assign(p, alarm_id_size);
+    p += alarm_id_size;
+    out.message.assign(p, message_size);
+    return true;
+}
+
+} // namespace common
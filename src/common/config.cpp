@@ -113,4 +113,65 @@ const RPCServerConfig* Config::getRPCServerConfig(const std::string& server_name
     return nullptr;
 }
 
-} // namespace common 
\ No newline at end of file
+/**
+ * @brief Gets the log rate limit for a component
+ * 
+ * Reads AppLogLevel.RateLimit.Default and overrides each field that is set in
+ * AppLogLevel.RateLimit.<component>. Returns a disabled limit if the section is
+ * absent or the configuration has not been loaded.
+ * 
+ * @param component Component name to look up
+ * @return LogRateLimit settings for the component
+ */
+LogRateLimit Config::getLogRateLimit(const std::string& component) const {
+    LogRateLimit rate_limit;
+    if (!loaded_) return rate_limit;
+
+    try {
+        const auto& section = config_["AppLogLevel"]["RateLimit"];
+        if (!section) return rate_limit;
+
+        for (const auto& key : {std::string("Default"), component}) {
+            const auto& node = section[key];
+            if (!node) continue;
+            if (node["MessagesPerSecond"]) rate_limit.messages_per_second = node["MessagesPerSecond"].as<double>();
+            if (node["Burst"]) rate_limit.burst = node["Burst"].as<double>();
+            if (node["SummaryIntervalSec"]) rate_limit.summary_interval_sec = node["SummaryIntervalSec"].as<int>();
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "Failed to parse log rate limit for " << component << ": " << e.what() << std::endl;
+    }
+    return rate_limit;
+}
+
+/**
+ * @brief Gets the alarm debouncing settings for an alarm system
+ * 
+ * Reads AlarmDebounce.Default and overrides each field that is set in
+ * AlarmDebounce.<component>. Returns the built-in defaults if the section is
+ * absent or the configuration has not been loaded.
+ * 
+ * @param component Alarm system name to look up
+ * @return AlarmDebounce settings for the component
+ */
+AlarmDebounce Config::getAlarmDebounce(const std::string& component) const {
+    AlarmDebounce debounce;
+    if (!loaded_) return debounce;
+
+    try {
+        const auto& section = config_["AlarmDebounce"];
+        if (!section) return debounce;
+
+        for (const auto& key : {std::string("Default"), component}) {
+            const auto& node = section[key];
+            if (!node) continue;
+            if (node["HoldDownMs"]) debounce.hold_down_ms = node["HoldDownMs"].as<int>();
+            if (node["ReraiseIntervalSec"]) debounce.reraise_interval_sec = node["ReraiseIntervalSec"].as<int>();
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "Failed to parse alarm debounce settings for " << component << ": " << e.what() << std::endl;
+    }
+    return debounce;
+}
+
+} // namespace common
@@ -0,0 +1,364 @@
+#include "common/flight_recorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace common {
+
+namespace {
+
+/**
+ * @brief Minimal append-only text buffer usable from signal handlers
+ */
+struct SignalSafeBuffer {
+    char* data;       ///< Destination buffer
+    size_t size;      ///< Capacity of the buffer
+    size_t length;    ///< Bytes used so far
+
+    void append(const char* str) {
+        while (*str && length + 1 < size) {
+            data[length++] = *str++;
+        }
+        data[length] = '\0';
+    }
+
+    void appendUnsigned(uint64_t value, int min_digits = 1) {
+        char digits[24];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0 || count < min_digits);
+        while (count > 0 && length + 1 < size) {
+            data[length++] = digits[--count];
+        }
+        data[length] = '\0';
+    }
+};
+
+/**
+ * @brief Writes a whole buffer to a file descriptor, retrying short writes
+ */
+bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(fd, data, length);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Copies a string into a fixed-size field, truncating and null-terminating it
+ */
+void copyField(char* dest, size_t size, const std::string& src) {
+    size_t length = std::min(src.size(), size - 1);
+    std::memcpy(dest, src.data(), length);
+    dest[length] = '\0';
+}
+
+const char* logLevelName(uint8_t level) {
+    static const char* const kNames[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+    return level < 4 ? kNames[level] : "UNKNOWN";
+}
+
+/**
+ * @brief Crash signal handler: dumps the ring, then re-raises with the default action
+ */
+void crashSignalHandler(int signal_number) {
+    FlightRecorder::getInstance().dumpFromSignal(signal_number == SIGSEGV ? "SIGSEGV" : "SIGABRT");
+    ::signal(signal_number, SIG_DFL);
+    ::raise(signal_number);
+}
+
+} // namespace
+
+/**
+ * @brief Gets the process-wide flight recorder
+ * @return Reference to the FlightRecorder instance
+ */
+FlightRecorder& FlightRecorder::getInstance() {
+    static FlightRecorder instance;
+    return instance;
+}
+
+/**
+ * @brief Allocates the ring and reads its settings
+ *
+ * Reads FlightRecorder.{Enabled, Capacity, Level, DumpDirectory, MinDumpIntervalSec}.
+ * The dump directory is created if missing and the dump file prefix is prepared
+ * up front so that signal-time dumps do not need to allocate.
+ *
+ * @param process_name Name used in dump file names
+ * @param config Root configuration node
+ */
+void FlightRecorder::configure(const std::string& process_name, const YAML::Node& config) {
+    bool enabled = true;
+    size_t capacity = 2048;
+    std::string level = "INFO";
+    std::string directory = "/tmp";
+
+    try {
+        const auto& section = config["FlightRecorder"];
+        if (section) {
+            if (section["Enabled"]) enabled = section["Enabled"].as<bool>();
+            if (section["Capacity"]) capacity = section["Capacity"].as<size_t>();
+            if (section["Level"]) level = section["Level"].as<std::string>();
+            if (section["DumpDirectory"]) directory = section["DumpDirectory"].as<std::string>();
+            if (section["MinDumpIntervalSec"]) min_dump_interval_sec_ = section["MinDumpIntervalSec"].as<int>();
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "Failed to parse flight recorder config: " << e.what() << std::endl;
+    }
+
+    if (!enabled || capacity == 0) {
+        return;
+    }
+
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    records_.reset(new Record[rounded]);
+    capacity_ = rounded;
+
+    LogLevel min_level = LogLevel::INFO;
+    Logger::parseLevel(level, min_level);
+    min_level_ = static_cast<uint8_t>(min_level);
+
+    ::mkdir(directory.c_str(), 0755);
+    copyField(path_prefix_, sizeof(path_prefix_), directory + "/" + process_name + "_flight_");
+}
+
+/**
+ * @brief Records a log message
+ *
+ * @param level Log level of the message
+ * @param source Logger name
+ * @param message Log message
+ */
+void FlightRecorder::recordLog(LogLevel level, const std::string& source, const std::string& message) {
+    if (!recordsLog(level)) {
+        return;
+    }
+    write(RecordKind::LOG, static_cast<uint8_t>(level), source, message);
+}
+
+/**
+ * @brief Records an alarm raise or clear
+ *
+ * @param severity Alarm severity
+ * @param source Alarm source name
+ * @param message Alarm message
+ * @param cleared true for a clear, false for a raise
+ */
+void FlightRecorder::recordAlarm(AlarmSeverity severity, const std::string& source,
+                                 const std::string& message, bool cleared) {
+    write(cleared ? RecordKind::ALARM_CLEARED : RecordKind::ALARM_RAISED,
+          static_cast<uint8_t>(severity), source, message);
+}
+
+/**
+ * @brief Claims the next slot and copies a record into it
+ *
+ * The slot sequence is zeroed while the record is written and then set to
+ * ticket + 1, so a concurrent dump can detect and skip half-written records.
+ */
+void FlightRecorder::write(RecordKind kind, uint8_t level, const std::string& source, const std::string& message) {
+    if (capacity_ == 0) {
+        return;
+    }
+
+    uint64_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+    Record& record = records_[ticket & (capacity_ - 1)];
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.epoch_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    record.kind = kind;
+    record.level = level;
+    copyField(record.source, kSourceSize, source);
+    copyField(record.message, kMessageSize, message);
+
+    record.sequence.store(ticket + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Writes the ring contents to a new dump file
+ *
+ * Non-forced dumps are throttled to one per MinDumpIntervalSec so that a
+ * repeating CRITICAL alarm does not produce a dump every second.
+ *
+ * @param reason Short reason used in the file name and header
+ * @param force Ignore the minimum interval between dumps
+ * @param path Receives the path of the written file, if not null
+ * @param records Receives the number of records written, if not null
+ * @return true if a dump file was written
+ */
+bool FlightRecorder::dump(const char* reason, bool force, std::string* path, size_t* records) {
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    int64_t now_sec = static_cast<int64_t>(std::time(nullptr));
+    if (!force && now_sec - last_dump_sec_.load() < min_dump_interval_sec_) {
+        return false;
+    }
+    if (dumping_.exchange(true)) {
+        return false;
+    }
+
+    char path_buf[320];
+    long count = writeDump(reason, path_buf, sizeof(path_buf));
+    last_dump_sec_.store(now_sec);
+    dumping_.store(false);
+
+    if (count < 0) {
+        std::cerr << "Failed to write flight recorder dump: " << path_buf << std::endl;
+        return false;
+    }
+    if (path) *path = path_buf;
+    if (records) *records = static_cast<size_t>(count);
+    return true;
+}
+
+/**
+ * @brief Writes the ring contents from a signal handler
+ *
+ * @param reason Short reason used in the file name and header
+ */
+void FlightRecorder::dumpFromSignal(const char* reason) {
+    char path_buf[320];
+    writeDump(reason, path_buf, sizeof(path_buf));
+}
+
+/**
+ * @brief Installs SIGSEGV and SIGABRT handlers that dump the ring and re-raise the signal
+ *
+ * The alternate signal stack is only installed for the calling thread, so a
+ * stack overflow can be dumped only if it happens on that thread (normally
+ * main). Other threads run the handler on their own stack; a fault there is
+ * still dumped unless it is a stack overflow.
+ */
+void FlightRecorder::installCrashHandlers() {
+    static char alt_stack[64 * 1024];
+    stack_t ss;
+    ss.ss_sp = alt_stack;
+    ss.ss_size = sizeof(alt_stack);
+    ss.ss_flags = 0;
+    sigaltstack(&ss, nullptr);
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = crashSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_ONSTACK | SA_RESETHAND;
+    sigaction(SIGSEGV, &action, nullptr);
+    sigaction(SIGABRT, &action, nullptr);
+}
+
+/**
+ * @brief Writes the ring to a file using only async-signal-safe calls
+ *
+ * Records are written oldest first, one line each:
+ * "<epoch_seconds>.<millis> <LOG|RAISE|CLEAR> <level> <source>: <message>".
+ *
+ * @param reason Reason string
+ * @param path_out Buffer receiving the file path
+ * @param path_len Size of path_out
+ * @return Number of records written, or -1 on failure
+ */
+long FlightRecorder::writeDump(const char* reason, char* path_out, size_t path_len) {
+    SignalSafeBuffer path{path_out, path_len, 0};
+    path.append(path_prefix_);
+    path.appendUnsigned(static_cast<uint64_t>(std::time(nullptr)));
+    path.append("_");
+    path.appendUnsigned(dump_count_.fetch_add(1));
+    path.append("_");
+    path.append(reason);
+    path.append(".log");
+
+    if (capacity_ == 0) {
+        return -1;
+    }
+
+    int fd = ::open(path_out, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+
+    char line_buf[kSourceSize + kMessageSize + 64];
+    SignalSafeBuffer header{line_buf, sizeof(line_buf), 0};
+    header.append("# flight recorder dump, reason=");
+    header.append(reason);
+    header.append(", capacity=");
+    header.appendUnsigned(capacity_);
+    header.append("\n");
+    bool ok = writeAll(fd, line_buf, header.length);
+
+    uint64_t head = next_ticket_.load(std::memory_order_acquire);
+    uint64_t start = head > capacity_ ? head - capacity_ : 0;
+    long count = 0;
+    char source[kSourceSize];
+    char message[kMessageSize];
+
+    for (uint64_t ticket = start; ok && ticket < head; ++ticket) {
+        const Record& record = records_[ticket & (capacity_ - 1)];
+        uint64_t seq = record.sequence.load(std::memory_order_acquire);
+        if (seq != ticket + 1) {
+            continue;
+        }
+        int64_t epoch_ms = record.epoch_ms;
+        RecordKind kind = record.kind;
+        uint8_t level = record.level;
+        std::memcpy(source, record.source, kSourceSize);
+        std::memcpy(message, record.message, kMessageSize);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (record.sequence.load(std::memory_order_relaxed) != seq) {
+            continue;
+        }
+        source[kSourceSize - 1] = '\0';
+        message[kMessageSize - 1] = '\0';
+
+        SignalSafeBuffer line{line_buf, sizeof(line_buf), 0};
+        line.appendUnsigned(static_cast<uint64_t>(epoch_ms / 1000));
+        line.append(".");
+        line.appendUnsigned(static_cast<uint64_t>(epoch_ms % 1000), 3);
+        switch (kind) {
+            case RecordKind::LOG:
+                line.append(" LOG ");
+                line.append(logLevelName(level));
+                break;
+            case RecordKind::ALARM_RAISED:
+                line.append(" RAISE ");
+                line.append(alarmSeverityName(static_cast<AlarmSeverity>(level)));
+                break;
+            case RecordKind::ALARM_CLEARED:
+                line.append(" CLEAR ");
+                line.append(alarmSeverityName(static_cast<AlarmSeverity>(level)));
+                break;
+        }
+        line.append(" ");
+        line.append(source);
+        line.append(": ");
+        line.append(message);
+        line.append("\n");
+        ok = writeAll(fd, line_buf, line.length);
+        ++count;
+    }
+
+    ::close(fd);
+    return ok ? count : -1;
+}
+
+} // namespace common
@@ -1,5 +1,9 @@
 #include "common/logger.hpp"
 #include "common/utils.hpp"
+#include "common/config.hpp"
+#include "common/flight_recorder.hpp"
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <nlohmann/json.hpp>
 
@@ -7,30 +11,243 @@ using json = nlohmann::json;
 
 namespace common {
 
+namespace {
+
+constexpr size_t kMaxRateLimitBuckets = 256;  ///< Cap on tracked message templates per logger
+
+/**
+ * @brief Process-wide registry of live loggers, used for runtime level changes
+ */
+struct LoggerRegistry {
+    std::mutex mutex;                 ///< Protects the logger list
+    std::vector<Logger*> loggers;     ///< Registered loggers
+};
+
+/**
+ * @brief Gets the process-wide logger registry
+ * @return Reference to the registry
+ */
+LoggerRegistry& registry() {
+    static LoggerRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief Hashes the template of a message
+ * 
+ * Runs of digits are collapsed to a single placeholder so that messages which
+ * only differ in sensor numbers or readings share one key. Uses FNV-1a over
+ * the level and message without building an intermediate string.
+ * 
+ * @param level The log level
+ * @param message The log message
+ * @return 64-bit template hash
+ */
+uint64_t templateKey(LogLevel level, const std::string& message) {
+    const uint64_t kPrime = 1099511628211ULL;
+    uint64_t hash = 14695981039346656037ULL;
+    hash = (hash ^ static_cast<uint64_t>(level)) * kPrime;
+    bool in_number = false;
+    for (char c : message) {
+        if (std::isdigit(static_cast<unsigned char>(c)) || (in_number && c == '.')) {
+            if (!in_number) {
+                hash = (hash ^ static_cast<uint64_t>('#')) * kPrime;
+                in_number = true;
+            }
+            continue;
+        }
+        in_number = false;
+        hash = (hash ^ static_cast<uint64_t>(static_cast<unsigned char>(c))) * kPrime;
+    }
+    return hash;
+}
+
+} // namespace
+
 /**
  * @brief Constructs a new Logger instance
  * 
  * Initializes the logger with the given name and MQTT client. Sets up the MQTT topic
- * prefix for log messages.
+ * prefix for log messages and applies the configured rate limit.
  * 
  * @param name Name of the logger (used in MQTT topics)
+ * @param log_level Log level for the logger
  * @param mqtt_client Shared pointer to MQTT client for publishing logs
+ * @param rate_limit_component Key of the rate limit in AppLogLevel.RateLimit, empty for the logger name
  */
-Logger::Logger(const std::string& name, const std::string& log_level, std::shared_ptr<MQTTClient> mqtt_client)
+Logger::Logger(const std::string& name, const std::string& log_level, std::shared_ptr<MQTTClient> mqtt_client,
+               const std::string& rate_limit_component)
     : name_(name)
     , mqtt_client_(mqtt_client)
     , topic_prefix_("logs/" + name)
+    , log_level_(LogLevel::INFO)
 {
-    if (log_level == "DEBUG") {
-        log_level_ = LogLevel::DEBUG;
-    } else if (log_level == "INFO") {
-        log_level_ = LogLevel::INFO;
-    } else if (log_level == "WARNING") {
-        log_level_ = LogLevel::WARNING;
-    } else if (log_level == "ERROR") {
-        log_level_ = LogLevel::ERROR;
+    LogLevel level;
+    if (parseLevel(log_level, level)) {
+        log_level_ = level;
+    }
+    setRateLimit(Config::getInstance().getLogRateLimit(rate_limit_component.empty() ? name : rate_limit_component));
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.loggers.push_back(this);
+}
+
+/**
+ * @brief Destroys the Logger instance
+ * 
+ * Cancels the summary timer, waiting for a running summary, and removes the
+ * logger from the process-wide registry.
+ */
+Logger::~Logger() {
+    TimerWheel::TimerId timer;
+    {
+        std::lock_guard<std::mutex> lock(rate_mutex_);
+        timer = summary_timer_;
+        summary_timer_ = 0;
+    }
+    TimerWheel::getInstance().cancel(timer);
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.loggers.erase(std::remove(reg.loggers.begin(), reg.loggers.end(), this), reg.loggers.end());
+}
+
+/**
+ * @brief Changes the level of a named logger, or of every logger in the process
+ * 
+ * Several components may share a logger name (e.g. all loggers of one fan);
+ * every logger with a matching name is updated.
+ * 
+ * @param name Logger name, or empty / "all" for every registered logger
+ * @param level New log level
+ * @return Number of loggers whose level was changed
+ */
+size_t Logger::setLevelByName(const std::string& name, LogLevel level) {
+    bool all = name.empty() || name == "all";
+    size_t changed = 0;
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (Logger* logger : reg.loggers) {
+        if (all || logger->name_ == name) {
+            logger->setLevel(level);
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+/**
+ * @brief Lists every registered logger and its current level
+ * 
+ * @return Pairs of logger name and level string, sorted by name
+ */
+std::vector<std::pair<std::string, std::string>> Logger::listLevels() {
+    std::vector<std::pair<std::string, std::string>> levels;
+    {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const Logger* logger : reg.loggers) {
+            levels.emplace_back(logger->name_, levelToString(logger->getLevel()));
+        }
+    }
+    std::sort(levels.begin(), levels.end());
+    return levels;
+}
+
+/**
+ * @brief Parses a log level string
+ * 
+ * @param level_str Level name (DEBUG, INFO, WARNING, ERROR)
+ * @param level Parsed level (unchanged on failure)
+ * @return true if the string named a valid level, false otherwise
+ */
+bool Logger::parseLevel(const std::string& level_str, LogLevel& level) {
+    if (level_str == "DEBUG") {
+        level = LogLevel::DEBUG;
+    } else if (level_str == "INFO") {
+        level = LogLevel::INFO;
+    } else if (level_str == "WARNING") {
+        level = LogLevel::WARNING;
+    } else if (level_str == "ERROR") {
+        level = LogLevel::ERROR;
     } else {
-        log_level_ = LogLevel::INFO;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Converts a log level to its string name
+ * 
+ * @param level The log level
+ * @return Level name (DEBUG, INFO, WARNING, ERROR)
+ */
+std::string Logger::levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:
+            return "DEBUG";
+        case LogLevel::INFO:
+            return "INFO";
+        case LogLevel::WARNING:
+            return "WARNING";
+        case LogLevel::ERROR:
+            return "ERROR";
+    }
+    return "UNKNOWN";
+}
+
+/**
+ * @brief Sets the rate limit applied to repeated messages
+ * 
+ * Resets all existing buckets so that the new burst size applies immediately.
+ * Summaries are published by a periodic timer on the process-wide timer
+ * wheel, so they go out even when the suppressed message stops arriving.
+ * 
+ * @param rate_limit Token-bucket settings; a zero rate disables limiting
+ */
+void Logger::setRateLimit(const LogRateLimit& rate_limit) {
+    std::vector<std::pair<LogLevel, std::string>> summaries;
+    TimerWheel::TimerId old_timer;
+    {
+        std::lock_guard<std::mutex> lock(rate_mutex_);
+        collectSummaries(summaries);
+        rate_limit_ = rate_limit;
+        buckets_.clear();
+        rate_limited_.store(rate_limit_.enabled(), std::memory_order_relaxed);
+        old_timer = summary_timer_;
+        summary_timer_ = 0;
+    }
+    // Cancel outside rate_mutex_: a running summary takes it and cancel() waits for it
+    TimerWheel::getInstance().cancel(old_timer);
+    for (const auto& summary : summaries) {
+        publish(summary.first, summary.second);
+    }
+
+    if (rate_limit.enabled()) {
+        auto period = std::chrono::seconds(std::max(rate_limit.summary_interval_sec, 1));
+        TimerWheel::TimerId timer = TimerWheel::getInstance().schedulePeriodic(period, [this] { flushSuppressed(); });
+        {
+            std::lock_guard<std::mutex> lock(rate_mutex_);
+            std::swap(timer, summary_timer_);
+        }
+        TimerWheel::getInstance().cancel(timer);
+    }
+}
+
+/**
+ * @brief Publishes summaries for all currently suppressed messages
+ * 
+ * Runs periodically on the timer wheel while rate limiting is enabled.
+ */
+void Logger::flushSuppressed() {
+    std::vector<std::pair<LogLevel, std::string>> summaries;
+    {
+        std::lock_guard<std::mutex> lock(rate_mutex_);
+        collectSummaries(summaries);
+    }
+    for (const auto& summary : summaries) {
+        publish(summary.first, summary.second);
     }
 }
 
@@ -43,10 +260,7 @@ Logger::Logger(const std::string& name, const std::string& log_level, std::share
  * @param message The debug message to log
  */
 void Logger::debug(const std::string& message) {
-    if (log_level_ > LogLevel::DEBUG) {
-        return;
-    }
-    mqtt_client_->publish(topic_prefix_ + "/debug", formatMessage(LogLevel::DEBUG, message));
+    log(LogLevel::DEBUG, message);
 }
 
 /**
@@ -58,10 +272,7 @@ void Logger::debug(const std::string& message) {
  * @param message The info message to log
  */
 void Logger::info(const std::string& message) {
-    if (log_level_ > LogLevel::INFO) {
-        return;
-    }
-    mqtt_client_->publish(topic_prefix_ + "/info", formatMessage(LogLevel::INFO, message));
+    log(LogLevel::INFO, message);
 }
 
 /**
@@ -73,10 +284,7 @@ void Logger::info(const std::string& message) {
  * @param message The warning message to log
  */
 void Logger::warning(const std::string& message) {
-    if (log_level_ > LogLevel::WARNING) {
-        return;
-    }
-    mqtt_client_->publish(topic_prefix_ + "/warning", formatMessage(LogLevel::WARNING, message));
+    log(LogLevel::WARNING, message);
 }
 
 /**
@@ -88,7 +296,32 @@ void Logger::warning(const std::string& message) {
  * @param message The error message to log
  */
 void Logger::error(const std::string& message) {
-    mqtt_client_->publish(topic_prefix_ + "/error", formatMessage(LogLevel::ERROR, message));
+    log(LogLevel::ERROR, message);
+}
+
+/**
+ * @brief Records, rate limits and publishes a message
+ * 
+ * Messages below the logger's level are not published. They still go to the
+ * flight recorder if they pass its own level (FlightRecorder.Level), so
+ * post-mortem dumps can contain detail without running at DEBUG; otherwise
+ * they cost one comparison.
+ * 
+ * @param level The log level
+ * @param message The log message
+ */
+void Logger::log(LogLevel level, const std::string& message) {
+    if (getLevel() > level) {
+        auto& recorder = FlightRecorder::getInstance();
+        if (recorder.recordsLog(level)) {
+            recorder.recordLog(level, name_, message);
+        }
+        return;
+    }
+    if (!admit(level, message)) {
+        return;
+    }
+    publish(level, message);
 }
 
 /**
@@ -111,15 +344,122 @@ std::string Logger::formatMessage(LogLevel level, const std::string& message) {
     return log_entry.dump();
 }
 
+/**
+ * @brief Publishes a formatted message to the topic for its level
+ * 
+ * The message is written to the flight recorder before the MQTT publish.
+ * 
+ * @param level The log level
+ * @param message The log message
+ */
+void Logger::publish(LogLevel level, const std::string& message) {
+    const char* suffix = "/info";
+    switch (level) {
+        case LogLevel::DEBUG:
+            suffix = "/debug";
+            break;
+        case LogLevel::INFO:
+            suffix = "/info";
+            break;
+        case LogLevel::WARNING:
+            suffix = "/warning";
+            break;
+        case LogLevel::ERROR:
+            suffix = "/error";
+            break;
+    }
+    FlightRecorder::getInstance().recordLog(level, name_, message);
+    mqtt_client_->publish(topic_prefix_ + suffix, formatMessage(level, message));
+}
+
+/**
+ * @brief Applies the token-bucket rate limit to a message
+ * 
+ * ERROR messages always pass, and while rate limiting is disabled no lock is
+ * taken. Otherwise looks up the bucket for the message template, refills it
+ * for the elapsed time and consumes one token. When no token is available
+ * the message is counted as suppressed and reported by the summary timer.
+ * 
+ * @param level The log level
+ * @param message The log message
+ * @return true if the message should be published, false if it was suppressed
+ */
+bool Logger::admit(LogLevel level, const std::string& message) {
+    if (level >= LogLevel::ERROR || !rate_limited_.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    bool allowed = true;
+    {
+        std::lock_guard<std::mutex> lock(rate_mutex_);
+        if (!rate_limit_.enabled()) {
+            return true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        uint64_t key = templateKey(level, message);
+        auto it = buckets_.find(key);
+        if (it == buckets_.end()) {
+            if (buckets_.size() < kMaxRateLimitBuckets) {
+                SuppressionBucket bucket;
+                bucket.tokens = rate_limit_.burst - 1.0;
+                bucket.last_refill = now;
+                bucket.level = level;
+                buckets_.emplace(key, std::move(bucket));
+            }
+        } else {
+            SuppressionBucket& bucket = it->second;
+            double elapsed = std::chrono::duration<double>(now - bucket.last_refill).count();
+            bucket.tokens = std::min(rate_limit_.burst, bucket.tokens + elapsed * rate_limit_.messages_per_second);
+            bucket.last_refill = now;
+            if (bucket.tokens >= 1.0) {
+                bucket.tokens -= 1.0;
+            } else {
+                if (bucket.suppressed == 0) {
+                    bucket.sample = message;
+                }
+                ++bucket.suppressed;
+                allowed = false;
+            }
+        }
+    }
+    return allowed;
+}
+
+/**
+ * @brief Moves pending suppression counts into summary messages
+ * 
+ * Also evicts idle buckets (nothing suppressed) once the bucket table is full,
+ * so the number of tracked templates stays bounded.
+ * 
+ * @param[out] summaries Level and text of each summary to publish
+ */
+void Logger::collectSummaries(std::vector<std::pair<LogLevel, std::string>>& summaries) {
+    for (auto it = buckets_.begin(); it != buckets_.end();) {
+        SuppressionBucket& bucket = it->second;
+        if (bucket.suppressed > 0) {
+            summaries.emplace_back(bucket.level,
+                "Suppressed " + std::to_string(bucket.suppressed) + " similar messages: " + bucket.sample);
+            bucket.suppressed = 0;
+            bucket.sample.clear();
+            ++it;
+        } else if (buckets_.size() >= kMaxRateLimitBuckets) {
+            it = buckets_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 /**
  * @brief Gets the current timestamp in human-readable format
  * 
- * Formats the current system time as "YYYY-MM-DD HH:MM:SS"
+ * Formats the current system time as "YYYY-MM-DD HH:MM:SS.mmm"
  * 
- * @return Timestamp string in the format "YYYY-MM-DD HH:MM:SS"
+ * @return Timestamp string in the format "YYYY-MM-DD HH:MM:SS.mmm"
  */
 std::string Logger::getTimestamp() {
-    return utils::getCurrentTimestamp();
+    return utils::getCurrentTimestampMs();
 }
 
 } // namespace common 
\ No newline at end of file
@@ -121,6 +121,20 @@ bool MQTTClient::connect() {
  * @return true if publishing was successful, false otherwise
  */
 bool MQTTClient::publish(const std::string& topic, const std::string& payload) {
+    return publish(topic, payload, settings_.retain);
+}
+
+/**
+ * @brief Publishes a message to an MQTT topic with an explicit retain flag
+ * 
+ * Same as publish() but overrides the configured retain setting.
+ * 
+ * @param topic The MQTT topic to publish to
+ * @param payload The message payload to publish
+ * @param retain Whether the broker keeps the message for later subscribers
+ * @return true if publishing was successful, false otherwise
+ */
+bool MQTTClient::publish(const std::string& topic, const std::string& payload, bool retain) {
     if (!client_) return false;
 
     int rc = mosquitto_publish(client_,
@@ -129,7 +143,7 @@ bool MQTTClient::publish(const std::string& topic, const std::string& payload) {
                              payload.length(),
                              payload.c_str(),
                              settings_.qos,
-                             settings_.retain);
+                             retain);
     return rc == MOSQ_ERR_SUCCESS;
 }
 
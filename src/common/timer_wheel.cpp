@@ -0,0 +1,332 @@
+#include "common/timer_wheel.hpp"
+#include <algorithm>
+
+namespace common {
+
+namespace {
+
+const uint64_t kNoEvent = UINT64_MAX;   ///< Tick value meaning "no timer filed"
+
+/**
+ * @brief Gets the index of the lowest set bit
+ */
+int lowestBit(uint64_t bits) {
+    return __builtin_ctzll(bits);
+}
+
+} // namespace
+
+const int TimerWheel::kLevels;
+const int TimerWheel::kSlotBits;
+const int TimerWheel::kSlots;
+
+/**
+ * @brief Gets the process-wide timer wheel
+ *
+ * The instance is intentionally leaked so that device destructors running
+ * during static destruction can still cancel their timers; the mains stop it
+ * explicitly once the devices are stopped.
+ *
+ * @return Shared instance
+ */
+TimerWheel& TimerWheel::getInstance() {
+    static TimerWheel* instance = new TimerWheel();
+    return *instance;
+}
+
+/**
+ * @brief Constructs a timer wheel and starts its thread
+ *
+ * @param tick Timer resolution
+ */
+TimerWheel::TimerWheel(std::chrono::milliseconds tick)
+    : tick_(tick.count() > 0 ? tick : std::chrono::milliseconds(1)),
+      origin_(std::chrono::steady_clock::now()) {
+    thread_ = std::thread(&TimerWheel::run, this);
+}
+
+/**
+ * @brief Stops the wheel and joins its thread
+ */
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+/**
+ * @brief Runs a callback every period
+ *
+ * The first expiry is the next tick that is a multiple of the period, so
+ * timers with equal periods expire on the same ticks.
+ *
+ * @param period Interval, rounded up to whole ticks
+ * @param callback Function to run
+ * @return Timer id, 0 if the wheel is stopped
+ */
+TimerWheel::TimerId TimerWheel::schedulePeriodic(std::chrono::milliseconds period, Callback callback) {
+    uint64_t period_ticks = std::max<int64_t>(1, (period.count() + tick_.count() - 1) / tick_.count());
+    uint64_t first = (nowTick() / period_ticks + 1) * period_ticks;
+    return addTimer(first, period_ticks, std::move(callback));
+}
+
+/**
+ * @brief Runs a callback once after a delay
+ *
+ * @param delay Delay, rounded up to whole ticks
+ * @param callback Function to run
+ * @return Timer id, 0 if the wheel is stopped
+ */
+TimerWheel::TimerId TimerWheel::scheduleOnce(std::chrono::milliseconds delay, Callback callback) {
+    uint64_t delay_ticks = std::max<int64_t>(1, (delay.count() + tick_.count() - 1) / tick_.count());
+    return addTimer(nowTick() + delay_ticks, 0, std::move(callback));
+}
+
+/**
+ * @brief Cancels a timer
+ *
+ * A callback that is already running is not interrupted; the call waits for
+ * it so the caller may release what the callback uses once this returns.
+ *
+ * @param id Timer id returned by a schedule call
+ * @return true if the timer was pending
+ */
+bool TimerWheel::cancel(TimerId id) {
+    if (id == 0) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool pending = timers_.erase(id) > 0;
+    // Slot entries of the timer go stale and are dropped when their slot comes up
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        done_cv_.wait(lock, [this, id] { return running_id_ != id; });
+    }
+    return pending;
+}
+
+/**
+ * @brief Cancels all timers and joins the wheel thread
+ */
+void TimerWheel::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        timers_.clear();
+        for (auto& level : wheel_) {
+            for (auto& slot : level) {
+                slot.clear();
+            }
+        }
+        occupied_.fill(0);
+        overflow_.clear();
+    }
+    wake_cv_.notify_all();
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id()) {
+        thread_.join();
+    }
+}
+
+/**
+ * @brief Gets the number of pending timers
+ *
+ * @return Timer count
+ */
+size_t TimerWheel::timerCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return timers_.size();
+}
+
+/**
+ * @brief Adds a timer and files it into its slot
+ *
+ * Wakes the thread if the timer expires before the tick it sleeps until.
+ *
+ * @param expiry Tick of the first expiry, after the current tick
+ * @param period_ticks Period in ticks, 0 for one-shot timers
+ * @param callback Function to run
+ * @return Timer id, 0 if the wheel is stopped
+ */
+TimerWheel::TimerId TimerWheel::addTimer(uint64_t expiry, uint64_t period_ticks, Callback callback) {
+    bool wake = false;
+    TimerId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return 0;
+        }
+        id = next_id_++;
+        Timer& timer = timers_[id];
+        timer.expiry = expiry;
+        timer.period = period_ticks;
+        timer.callback = std::make_shared<Callback>(std::move(callback));
+        place(id, timer.expiry);
+        wake = timer.expiry < wake_tick_;
+    }
+    if (wake) {
+        wake_cv_.notify_one();
+    }
+    return id;
+}
+
+/**
+ * @brief Files a timer reference into the slot of its expiry
+ *
+ * The level is the lowest one whose slot groups the expiry together with
+ * current_tick_, i.e. the expiry and the current tick agree on all bits above
+ * that level. Expiries outside the top level's span wait in overflow_.
+ *
+ * @param id Timer id
+ * @param expiry Tick the timer is due at
+ */
+void TimerWheel::place(TimerId id, uint64_t expiry) {
+    for (int level = 0; level < kLevels; ++level) {
+        int shift = kSlotBits * (level + 1);
+        if ((expiry >> shift) == (current_tick_ >> shift)) {
+            int slot = static_cast<int>((expiry >> (kSlotBits * level)) & (kSlots - 1));
+            wheel_[level][slot].push_back({id, expiry});
+            occupied_[level] |= uint64_t(1) << slot;
+            return;
+        }
+    }
+    overflow_.push_back({id, expiry});
+}
+
+/**
+ * @brief Finds the next tick after current_tick_ at which a slot needs processing
+ *
+ * For level 0 that is the expiry tick of the next occupied slot, for higher
+ * levels the first tick covered by the next occupied slot, where its timers
+ * are refiled.
+ *
+ * @return Tick, or UINT64_MAX if no timers are filed
+ */
+uint64_t TimerWheel::nextEventTick() const {
+    uint64_t next = kNoEvent;
+    for (int level = 0; level < kLevels; ++level) {
+        int shift = kSlotBits * level;
+        int current_slot = static_cast<int>((current_tick_ >> shift) & (kSlots - 1));
+        uint64_t later = current_slot == kSlots - 1 ? 0 : occupied_[level] & (~uint64_t(0) << (current_slot + 1));
+        if (later) {
+            uint64_t base = (current_tick_ >> (shift + kSlotBits)) << (shift + kSlotBits);
+            next = std::min(next, base | (static_cast<uint64_t>(lowestBit(later)) << shift));
+        }
+    }
+    if (!overflow_.empty()) {
+        int span = kSlotBits * kLevels;
+        next = std::min(next, ((current_tick_ >> span) + 1) << span);
+    }
+    return next;
+}
+
+/**
+ * @brief Refiles the timers of the higher-level slots that start at current_tick_
+ *
+ * Runs from the top level down so timers refiled from one level can land in
+ * a lower-level slot that is refiled next.
+ */
+void TimerWheel::cascade() {
+    int span = kSlotBits * kLevels;
+    if ((current_tick_ & ((uint64_t(1) << span) - 1)) == 0 && !overflow_.empty()) {
+        std::vector<SlotEntry> entries;
+        entries.swap(overflow_);
+        for (const auto& entry : entries) {
+            place(entry.id, entry.expiry);
+        }
+    }
+    for (int level = kLevels - 1; level > 0; --level) {
+        int shift = kSlotBits * level;
+        if ((current_tick_ & ((uint64_t(1) << shift) - 1)) != 0) {
+            continue;
+        }
+        int slot = static_cast<int>((current_tick_ >> shift) & (kSlots - 1));
+        if (!(occupied_[level] & (uint64_t(1) << slot))) {
+            continue;
+        }
+        std::vector<SlotEntry> entries;
+        entries.swap(wheel_[level][slot]);
+        occupied_[level] &= ~(uint64_t(1) << slot);
+        for (const auto& entry : entries) {
+            auto it = timers_.find(entry.id);
+            if (it != timers_.end() && it->second.expiry == entry.expiry) {
+                place(entry.id, entry.expiry);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the current tick of the steady clock
+ *
+ * @return Whole ticks since construction
+ */
+uint64_t TimerWheel::nowTick() const {
+    auto elapsed = std::chrono::steady_clock::now() - origin_;
+    return static_cast<uint64_t>(elapsed / tick_);
+}
+
+/**
+ * @brief Main loop of the wheel thread
+ *
+ * Sleeps until the next tick with work, processes it and runs the due
+ * callbacks with the lock released. Periodic timers are refiled before their
+ * callback runs; one that overran skips the periods it missed instead of
+ * firing in a burst.
+ */
+void TimerWheel::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        uint64_t next = nextEventTick();
+        if (next > nowTick()) {
+            wake_tick_ = next;
+            if (next == kNoEvent) {
+                wake_cv_.wait(lock);
+            } else {
+                wake_cv_.wait_until(lock, origin_ + tick_ * next);
+            }
+            wake_tick_ = kNoEvent;
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        current_tick_ = next;
+        cascade();
+        int slot = static_cast<int>(current_tick_ & (kSlots - 1));
+        if (!(occupied_[0] & (uint64_t(1) << slot))) {
+            continue;
+        }
+        std::vector<SlotEntry> due;
+        due.swap(wheel_[0][slot]);
+        occupied_[0] &= ~(uint64_t(1) << slot);
+
+        for (const auto& entry : due) {
+            if (stopped_) {
+                break;
+            }
+            // Skip timers cancelled meanwhile, including by an earlier callback of this tick
+            auto it = timers_.find(entry.id);
+            if (it == timers_.end() || it->second.expiry != entry.expiry) {
+                continue;
+            }
+            std::shared_ptr<Callback> callback = it->second.callback;
+            if (it->second.period > 0) {
+                uint64_t period = it->second.period;
+                uint64_t expiry = entry.expiry + period;
+                uint64_t now = nowTick();
+                if (expiry <= now) {
+                    expiry += ((now - expiry) / period + 1) * period;
+                }
+                it->second.expiry = expiry;
+                place(entry.id, expiry);
+            } else {
+                timers_.erase(it);
+            }
+
+            running_id_ = entry.id;
+            lock.unlock();
+            (*callback)();
+            lock.lock();
+            running_id_ = 0;
+            done_cv_.notify_all();
+        }
+    }
+}
+
+} // namespace common
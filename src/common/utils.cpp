@@ -1,24 +1,73 @@
 #include "common/utils.hpp"
-#include <iomanip>
-#include <sstream>
+#include <cstring>
+#include <ctime>
 
 namespace common {
 namespace utils {
 
+namespace {
+
+constexpr size_t kSecondsPrefixLength = 19;  ///< Length of "YYYY-MM-DD HH:MM:SS"
+
+/**
+ * @struct TimestampCache
+ * @brief Per-thread cache of the last formatted second
+ */
+struct TimestampCache {
+    std::time_t seconds = static_cast<std::time_t>(-1);  ///< Second the prefix was formatted for
+    char prefix[kSecondsPrefixLength + 1] = {};           ///< Cached "YYYY-MM-DD HH:MM:SS"
+};
+
+/**
+ * @brief Returns the cached seconds prefix for the given time, refreshing it if needed
+ * 
+ * Uses the thread-safe localtime_r and only calls it when the second changes.
+ * 
+ * @param seconds Time in seconds since the epoch
+ * @return Pointer to the null-terminated "YYYY-MM-DD HH:MM:SS" prefix
+ */
+const char* secondsPrefix(std::time_t seconds) {
+    thread_local TimestampCache cache;
+    if (cache.seconds != seconds) {
+        std::tm tm_buf;
+        localtime_r(&seconds, &tm_buf);
+        std::strftime(cache.prefix, sizeof(cache.prefix), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        cache.seconds = seconds;
+    }
+    return cache.prefix;
+}
+
+/**
+ * @brief Splits a time point into whole seconds and milliseconds
+ * @param tp The time point to split
+ * @param[out] millis Millisecond part in the range [0, 999]
+ * @return Whole seconds since the epoch
+ */
+std::time_t splitTimePoint(const std::chrono::system_clock::time_point& tp, int& millis) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    auto secs = ms / 1000;
+    millis = static_cast<int>(ms % 1000);
+    if (millis < 0) {
+        millis += 1000;
+        --secs;
+    }
+    return static_cast<std::time_t>(secs);
+}
+
+} // namespace
+
 /**
  * @brief Formats a system clock time point to a human-readable timestamp string
  * 
  * Converts a std::chrono::system_clock::time_point to a string in the format
- * "YYYY-MM-DD HH:MM:SS" using the local timezone.
+ * "YYYY-MM-DD HH:MM:SS" using the local timezone. The formatted string is
+ * cached per thread and reused until the second changes.
  * 
  * @param tp The system clock time point to format
  * @return Formatted timestamp string in "YYYY-MM-DD HH:MM:SS" format
  */
 std::string formatTimestamp(const std::chrono::system_clock::time_point& tp) {
-    auto time = std::chrono::system_clock::to_time_t(tp);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    return std::string(secondsPrefix(std::chrono::system_clock::to_time_t(tp)), kSecondsPrefixLength);
 }
 
 /**
@@ -33,5 +82,36 @@ std::string getCurrentTimestamp() {
     return formatTimestamp(std::chrono::system_clock::now());
 }
 
+/**
+ * @brief Formats a system clock time point with millisecond precision
+ * 
+ * Reuses the per-thread cached "YYYY-MM-DD HH:MM:SS" prefix and appends
+ * ".mmm", so the cost is one string construction plus three digits.
+ * 
+ * @param tp The system clock time point to format
+ * @return Formatted timestamp string in "YYYY-MM-DD HH:MM:SS.mmm" format
+ */
+std::string formatTimestampMs(const std::chrono::system_clock::time_point& tp) {
+    int millis = 0;
+    std::time_t seconds = splitTimePoint(tp, millis);
+
+    char buf[kSecondsPrefixLength + 4];
+    std::memcpy(buf, secondsPrefix(seconds), kSecondsPrefixLength);
+    buf[kSecondsPrefixLength] = '.';
+    buf[kSecondsPrefixLength + 1] = static_cast<char>('0' + millis / 100);
+    buf[kSecondsPrefixLength + 2] = static_cast<char>('0' + (millis / 10) % 10);
+    buf[kSecondsPrefixLength + 3] = static_cast<char>('0' + millis % 10);
+    return std::string(buf, sizeof(buf));
+}
+
+/**
+ * @brief Gets the current system time as a timestamp string with milliseconds
+ * 
+ * @return Current timestamp string in "YYYY-MM-DD HH:MM:SS.mmm" format
+ */
+std::string getCurrentTimestampMs() {
+    return formatTimestampMs(std::chrono::system_clock::now());
+}
+
 } // namespace utils
 } // namespace common 
\ No newline at end of file
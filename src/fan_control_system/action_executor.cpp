@@ -0,0 +1,432 @@
+#include "fan_control_system/action_executor.hpp"
+#include "fan_control_system/alarm_manager.hpp"
+#include <algorithm>
+
+namespace fan_control_system {
+
+/**
+ * @brief Constructs the executor
+ *
+ * @param settings Pool size, queue capacity and timeouts
+ * @param logger Logger used for action results
+ */
+ActionExecutor::ActionExecutor(const ActionExecutorSettings& settings, common::Logger* logger)
+    : core_(std::make_shared<Core>()) {
+    core_->settings = settings;
+    core_->settings.workers = std::max(settings.workers, 1);
+    core_->settings.queue_capacity = std::max<size_t>(settings.queue_capacity, 1);
+    core_->settings.stop_timeout_ms = std::max(settings.stop_timeout_ms, 0);
+    core_->settings.max_abandoned_workers = std::max(settings.max_abandoned_workers, 0);
+    core_->logger = logger;
+}
+
+/**
+ * @brief Destructor that stops the workers
+ */
+ActionExecutor::~ActionExecutor() {
+    stop();
+}
+
+/**
+ * @brief Starts the worker pool and the timeout watchdog
+ */
+void ActionExecutor::start() {
+    std::lock_guard<std::mutex> lock(core_->mutex);
+    if (core_->running) {
+        return;
+    }
+    core_->running = true;
+    for (int i = 0; i < core_->settings.workers; ++i) {
+        spawn_worker_locked(core_);
+    }
+    watchdog_ = std::thread(&ActionExecutor::watchdog_loop, this);
+}
+
+/**
+ * @brief Stops the workers
+ *
+ * Actions still pending are discarded. Running actions get stop_timeout_ms
+ * to finish; the workers still inside a callback after that are abandoned
+ * like timed-out ones and detached, all others are joined. Workers abandoned
+ * earlier by the watchdog are already detached and are not waited for.
+ */
+void ActionExecutor::stop() {
+    std::vector<std::shared_ptr<Worker>> workers;
+    {
+        std::lock_guard<std::mutex> lock(core_->mutex);
+        if (!core_->running) {
+            return;
+        }
+        core_->running = false;
+        workers.swap(core_->workers);
+        for (auto& lane : core_->lanes) {
+            lane.clear();
+        }
+        core_->pending.clear();
+    }
+    core_->work_cv.notify_all();
+    core_->watchdog_cv.notify_all();
+
+    if (watchdog_.joinable()) {
+        watchdog_.join();
+    }
+
+    auto idle = [&workers] {
+        for (const auto& worker : workers) {
+            std::lock_guard<std::mutex> worker_lock(worker->mutex);
+            if (worker->busy) {
+                return false;
+            }
+        }
+        return true;
+    };
+    {
+        std::unique_lock<std::mutex> lock(core_->mutex);
+        core_->idle_cv.wait_for(lock, std::chrono::milliseconds(core_->settings.stop_timeout_ms), idle);
+    }
+
+    std::vector<std::string> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(core_->mutex);
+        for (auto& worker : workers) {
+            std::lock_guard<std::mutex> worker_lock(worker->mutex);
+            if (worker->busy) {
+                worker->abandoned = true;
+                core_->abandoned++;
+                abandoned.push_back(worker->action_name + " for alarm: " + worker->alarm_source);
+            }
+        }
+    }
+    for (auto& worker : workers) {
+        if (worker->abandoned) {
+            worker->thread.detach();
+        } else if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    for (const auto& action : abandoned) {
+        core_->logger->error("Action still running at stop, worker abandoned: " + action);
+    }
+}
+
+/**
+ * @brief Enqueues an action
+ *
+ * Runs in O(1) apart from the rare eviction when the queue is full; the action
+ * itself is never called on the submitting thread. An action whose previous
+ * run for the same alarm source timed out and has not returned yet is dropped.
+ *
+ * @param action_name Name of the action
+ * @param action Callback to run
+ * @param priority Severity of the triggering alarm
+ * @param alarm_source Source of the alarm
+ * @param message Alarm message
+ * @return true if the action was queued or coalesced, false if it was dropped
+ */
+bool ActionExecutor::submit(const std::string& action_name, Action action, AlarmSeverity priority,
+                            const std::string& alarm_source, const std::string& message) {
+    int lane = std::min(std::max(static_cast<int>(priority), 0), kLaneCount - 1);
+    std::string key = action_name + '\x1f' + alarm_source;
+    const char* dropped = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(core_->mutex);
+        if (!core_->running) {
+            return false;
+        }
+        core_->stats.submitted++;
+
+        auto it = core_->pending.find(key);
+        if (core_->stuck.count(key)) {
+            core_->stats.dropped++;
+            dropped = "Previous run still stuck, dropped action: ";
+        } else if (it != core_->pending.end()) {
+            Task& task = *it->second;
+            task.message = message;
+            if (lane > task.lane) {
+                // The entry left in the lower lane is skipped when popped
+                task.lane = lane;
+                core_->lanes[lane].push_back(it->second);
+            }
+            core_->stats.coalesced++;
+            return true;
+        } else if (core_->pending.size() >= core_->settings.queue_capacity && !evict_below_locked(lane)) {
+            core_->stats.dropped++;
+            dropped = "Action queue full, dropped action: ";
+        } else {
+            auto task = std::make_shared<Task>();
+            task->key = key;
+            task->action_name = action_name;
+            task->action = std::move(action);
+            task->alarm_source = alarm_source;
+            task->message = message;
+            task->lane = lane;
+            task->enqueued = std::chrono::steady_clock::now();
+            core_->lanes[lane].push_back(task);
+            core_->pending.emplace(std::move(key), std::move(task));
+            core_->stats.high_water = std::max(core_->stats.high_water, core_->pending.size());
+        }
+    }
+
+    if (dropped) {
+        core_->logger->warning(dropped + action_name + " for alarm: " + alarm_source);
+        return false;
+    }
+    core_->work_cv.notify_one();
+    return true;
+}
+
+/**
+ * @brief Gets queue and execution metrics
+ *
+ * @return Snapshot of the executor statistics
+ */
+ActionExecutorStats ActionExecutor::get_stats() const {
+    std::lock_guard<std::mutex> lock(core_->mutex);
+    ActionExecutorStats stats = core_->stats;
+    stats.pending = core_->pending.size();
+    stats.workers = core_->workers.size();
+    stats.running = 0;
+    for (const auto& worker : core_->workers) {
+        std::lock_guard<std::mutex> worker_lock(worker->mutex);
+        if (worker->busy) {
+            stats.running++;
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief Starts one worker thread
+ *
+ * The thread holds its own references to the core and to its worker state,
+ * never to the executor, so both stay valid if the worker is abandoned and
+ * detached.
+ *
+ * @param core State shared with the worker threads
+ */
+void ActionExecutor::spawn_worker_locked(const std::shared_ptr<Core>& core) {
+    auto worker = std::make_shared<Worker>();
+    worker->thread = std::thread(&ActionExecutor::worker_loop, core, worker);
+    core->workers.push_back(worker);
+}
+
+/**
+ * @brief Worker thread loop
+ *
+ * After each action the worker checks whether the watchdog or stop()
+ * abandoned it; an abandoned worker returns immediately without touching the
+ * logger, which may already have been destroyed with the executor. A worker
+ * whose action had timed out releases the action's key first, so the action
+ * can run again for that alarm source. Tasks for a key that is still stuck
+ * are dropped instead of run.
+ *
+ * @param core State shared with the worker threads
+ * @param worker Shared state of this worker
+ */
+void ActionExecutor::worker_loop(std::shared_ptr<Core> core, std::shared_ptr<Worker> worker) {
+    for (;;) {
+        std::shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(core->mutex);
+            core->work_cv.wait(lock, [&core] { return !core->running || !core->pending.empty(); });
+            if (!core->running) {
+                return;
+            }
+            task = pop_locked(*core);
+            if (!task) {
+                continue;
+            }
+            if (core->stuck.count(task->key)) {
+                core->stats.dropped++;
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            int64_t wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - task->enqueued).count();
+            core->stats.max_wait_ms = std::max(core->stats.max_wait_ms, wait_ms);
+
+            std::lock_guard<std::mutex> worker_lock(worker->mutex);
+            worker->busy = true;
+            worker->key = task->key;
+            worker->action_name = task->action_name;
+            worker->alarm_source = task->alarm_source;
+            worker->started = now;
+            worker->timeout = timeout_for(*core, task->action_name);
+        }
+
+        std::string error;
+        try {
+            task->action(task->alarm_source, task->message);
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "unknown exception";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(core->mutex);
+            std::lock_guard<std::mutex> worker_lock(worker->mutex);
+            if (worker->timed_out) {
+                auto stuck = core->stuck.find(worker->key);
+                if (--stuck->second == 0) {
+                    core->stuck.erase(stuck);
+                }
+                worker->timed_out = false;
+            }
+            if (worker->abandoned) {
+                core->abandoned--;
+                return;
+            }
+            worker->busy = false;
+            if (error.empty()) {
+                core->stats.executed++;
+            } else {
+                core->stats.failed++;
+            }
+        }
+        core->idle_cv.notify_all();
+        if (error.empty()) {
+            core->logger->info("Executed action: " + task->action_name + " for alarm: " + task->alarm_source);
+        } else {
+            core->logger->error("Action " + task->action_name + " for alarm " + task->alarm_source + " failed: " + error);
+        }
+    }
+}
+
+/**
+ * @brief Watchdog loop that abandons and replaces timed-out workers
+ *
+ * Checks running actions every 50 ms. A timed-out worker is detached and
+ * replaced by a fresh one, so a hung callback costs one thread but never the
+ * pool's capacity. Once max_abandoned_workers are abandoned and still stuck,
+ * further timed-out workers are kept in the pool until their action returns
+ * or an abandoned one finishes. Either way the action's key is marked stuck.
+ */
+void ActionExecutor::watchdog_loop() {
+    std::unique_lock<std::mutex> lock(core_->mutex);
+    while (core_->running) {
+        core_->watchdog_cv.wait_for(lock, std::chrono::milliseconds(50));
+        if (!core_->running) {
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::string> timed_out;
+        std::vector<std::string> kept;
+        for (auto it = core_->workers.begin(); it != core_->workers.end();) {
+            auto& worker = *it;
+            bool expired = false;
+            {
+                std::lock_guard<std::mutex> worker_lock(worker->mutex);
+                if (worker->busy && now - worker->started > worker->timeout) {
+                    std::string action = worker->action_name + " for alarm: " + worker->alarm_source;
+                    bool first = !worker->timed_out;
+                    if (first) {
+                        worker->timed_out = true;
+                        core_->stats.timed_out++;
+                        core_->stuck[worker->key]++;
+                    }
+                    if (core_->abandoned < static_cast<size_t>(core_->settings.max_abandoned_workers)) {
+                        worker->abandoned = true;
+                        core_->abandoned++;
+                        expired = true;
+                        timed_out.push_back(action);
+                    } else if (first) {
+                        kept.push_back(action);
+                    }
+                }
+            }
+            if (expired) {
+                worker->thread.detach();
+                it = core_->workers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (size_t i = 0; i < timed_out.size(); ++i) {
+            spawn_worker_locked(core_);
+        }
+
+        if (!timed_out.empty() || !kept.empty()) {
+            lock.unlock();
+            for (const auto& action : timed_out) {
+                core_->logger->error("Action timed out, worker replaced: " + action);
+            }
+            for (const auto& action : kept) {
+                core_->logger->error("Action timed out, too many abandoned workers, worker kept: " + action);
+            }
+            lock.lock();
+        }
+    }
+}
+
+/**
+ * @brief Removes the next task from the most severe non-empty lane
+ *
+ * Entries left behind in a lower lane by a priority upgrade are skipped.
+ *
+ * @param core State shared with the worker threads
+ * @return Next task, or nullptr if none is pending
+ */
+std::shared_ptr<ActionExecutor::Task> ActionExecutor::pop_locked(Core& core) {
+    for (int lane = kLaneCount - 1; lane >= 0; --lane) {
+        auto& queue = core.lanes[lane];
+        while (!queue.empty()) {
+            std::shared_ptr<Task> task = std::move(queue.front());
+            queue.pop_front();
+            if (task->lane != lane) {
+                continue;
+            }
+            auto it = core.pending.find(task->key);
+            if (it == core.pending.end() || it->second != task) {
+                continue;
+            }
+            core.pending.erase(it);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Evicts the oldest task of a lane below the given one
+ *
+ * @param lane Lane of the task that needs room
+ * @return true if a task was evicted
+ */
+bool ActionExecutor::evict_below_locked(int lane) {
+    for (int lower = 0; lower < lane; ++lower) {
+        auto& queue = core_->lanes[lower];
+        while (!queue.empty()) {
+            std::shared_ptr<Task> task = std::move(queue.front());
+            queue.pop_front();
+            if (task->lane != lower) {
+                continue;
+            }
+            auto it = core_->pending.find(task->key);
+            if (it == core_->pending.end() || it->second != task) {
+                continue;
+            }
+            core_->pending.erase(it);
+            core_->stats.dropped++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the timeout configured for an action
+ *
+ * @param core State shared with the worker threads
+ * @param action_name Action name
+ * @return Per-action timeout, or the default timeout
+ */
+std::chrono::milliseconds ActionExecutor::timeout_for(const Core& core, const std::string& action_name) {
+    auto it = core.settings.timeouts_ms.find(action_name);
+    return std::chrono::milliseconds(it != core.settings.timeouts_ms.end() ? it->second : core.settings.default_timeout_ms);
+}
+
+} // namespace fan_control_system
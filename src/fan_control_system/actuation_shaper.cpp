@@ -0,0 +1,195 @@
+#include "fan_control_system/actuation_shaper.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace fan_control_system {
+
+/**
+ * @brief Reads the settings from the Actuator.Shaper configuration section
+ *
+ * All keys are optional: Enabled, SlewRatePercentPerSec, HysteresisUpPercent,
+ * HysteresisDownPercent, MinDwellMs and RampIntervalMs. Leaving out
+ * SlewRatePercentPerSec means no slew limit; a configured rate must be
+ * positive, and hysteresis and dwell must not be negative.
+ *
+ * @param config Shaper configuration node, may be undefined
+ * @return Settings, disabled if the section is missing
+ * @throw std::runtime_error if a configured value is out of range
+ */
+ActuationShaperSettings ActuationShaperSettings::fromConfig(const YAML::Node& config) {
+    ActuationShaperSettings settings;
+    if (!config) {
+        return settings;
+    }
+    settings.enabled = config["Enabled"] ? config["Enabled"].as<bool>() : true;
+    if (config["SlewRatePercentPerSec"]) settings.slew_rate_percent_per_s = config["SlewRatePercentPerSec"].as<double>();
+    if (config["HysteresisUpPercent"]) settings.hysteresis_up_percent = config["HysteresisUpPercent"].as<int>();
+    if (config["HysteresisDownPercent"]) settings.hysteresis_down_percent = config["HysteresisDownPercent"].as<int>();
+    if (config["MinDwellMs"]) settings.min_dwell = std::chrono::milliseconds(config["MinDwellMs"].as<int>());
+    if (config["RampIntervalMs"]) settings.ramp_interval = std::chrono::milliseconds(config["RampIntervalMs"].as<int>());
+    settings.ramp_interval = std::max(settings.ramp_interval, std::chrono::milliseconds(1));
+
+    if (config["SlewRatePercentPerSec"] && !(settings.slew_rate_percent_per_s > 0.0)) {
+        throw std::runtime_error("Actuator.Shaper.SlewRatePercentPerSec must be positive, got " +
+                                 std::to_string(settings.slew_rate_percent_per_s));
+    }
+    if (settings.hysteresis_up_percent < 0 || settings.hysteresis_down_percent < 0) {
+        throw std::runtime_error("Actuator.Shaper hysteresis must not be negative, got " +
+                                 std::to_string(settings.hysteresis_up_percent) + " up and " +
+                                 std::to_string(settings.hysteresis_down_percent) + " down");
+    }
+    if (settings.min_dwell.count() < 0) {
+        throw std::runtime_error("Actuator.Shaper.MinDwellMs must not be negative, got " +
+                                 std::to_string(settings.min_dwell.count()));
+    }
+    return settings;
+}
+
+/**
+ * @brief Constructs the shaper
+ *
+ * @param fan_count Number of fans
+ * @param settings Shaper configuration
+ */
+ActuationShaper::ActuationShaper(size_t fan_count, const ActuationShaperSettings& settings)
+    : settings_(settings), fans_(fan_count) {
+}
+
+/**
+ * @brief Sets the target of a fan from the control loop
+ *
+ * A target on the other side of a ramp under way stops the ramp; the fan then
+ * counts as settled at its current speed, so reversing down waits for the
+ * dwell time.
+ *
+ * @param fan Fan index
+ * @param duty_cycle Target duty cycle
+ * @param now Current time
+ */
+void ActuationShaper::set_target(size_t fan, int duty_cycle, std::chrono::steady_clock::time_point now) {
+    if (fan >= fans_.size()) {
+        return;
+    }
+    FanShaping& state = fans_[fan];
+    ++stats_.requests;
+    if (state.moving && (duty_cycle > state.output) != (state.target > state.output)) {
+        state.moving = false;
+        state.settled = now;
+    }
+    if (state.target != duty_cycle) {
+        state.counted = false;
+    }
+    state.target = duty_cycle;
+}
+
+/**
+ * @brief Records a speed written outside the shaper and drops the target
+ *
+ * @param fan Fan index
+ * @param duty_cycle Duty cycle the fan was set to
+ * @param now Time of the change
+ */
+void ActuationShaper::sync(size_t fan, int duty_cycle, std::chrono::steady_clock::time_point now) {
+    if (fan >= fans_.size()) {
+        return;
+    }
+    FanShaping& state = fans_[fan];
+    state.output = duty_cycle;
+    state.target = -1;
+    state.moving = false;
+    state.settled = now;
+}
+
+/**
+ * @brief Computes the next step of every fan that needs one
+ *
+ * A fan at rest drops targets inside its hysteresis band and keeps a lower
+ * target pending until its dwell time has passed. A moving fan advances by at
+ * most slew rate x ramp interval once per ramp interval; the first step of a
+ * move is taken immediately.
+ *
+ * @param now Current time
+ * @param commands AUTO commands for the fans to write, appended
+ */
+void ActuationShaper::step(std::chrono::steady_clock::time_point now, std::vector<ActuatorCommand>& commands) {
+    double interval_s = std::chrono::duration<double>(settings_.ramp_interval).count();
+    int max_step = settings_.slew_rate_percent_per_s > 0.0
+                       ? std::max(1, static_cast<int>(settings_.slew_rate_percent_per_s * interval_s))
+                       : 100;
+    for (size_t i = 0; i < fans_.size(); ++i) {
+        FanShaping& state = fans_[i];
+        if (state.target < 0) {
+            continue;
+        }
+        if (state.target == state.output) {
+            if (!state.moving) {
+                ++stats_.avoided_unchanged;
+            }
+            state.target = -1;
+            state.moving = false;
+            continue;
+        }
+
+        bool up = state.target > state.output || state.output < 0;
+        int distance = state.output < 0 ? 100 : std::abs(state.target - state.output);
+        if (!state.moving) {
+            if (state.output >= 0 &&
+                distance < (up ? settings_.hysteresis_up_percent : settings_.hysteresis_down_percent)) {
+                ++stats_.avoided_hysteresis;
+                state.target = -1;
+                continue;
+            }
+            if (!up && now - state.settled < settings_.min_dwell) {
+                // Kept pending and retried on the next ramp interval
+                if (!state.counted) {
+                    ++stats_.deferred_dwell;
+                    state.counted = true;
+                }
+                continue;
+            }
+            state.moving = true;
+            state.last_step = now - settings_.ramp_interval;
+        }
+        if (now - state.last_step < settings_.ramp_interval) {
+            continue;
+        }
+
+        int next = state.target;
+        if (state.output >= 0 && distance > max_step) {
+            next = up ? state.output + max_step : state.output - max_step;
+            ++stats_.slew_limited;
+        }
+        state.output = next;
+        state.last_step = now;
+        if (next == state.target) {
+            state.target = -1;
+            state.moving = false;
+            state.settled = now;
+        }
+
+        ActuatorCommand command;
+        command.fan = i;
+        command.source = CommandSource::AUTO;
+        command.duty_cycle = next;
+        commands.push_back(command);
+        ++stats_.writes;
+    }
+}
+
+/**
+ * @brief Gets whether any fan still has a target it has not reached
+ *
+ * @return true if step() may emit more commands
+ */
+bool ActuationShaper::pending() const {
+    for (const auto& state : fans_) {
+        if (state.target >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace fan_control_system
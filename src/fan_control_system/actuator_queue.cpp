@@ -0,0 +1,279 @@
+#include "fan_control_system/actuator_queue.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace fan_control_system {
+
+/**
+ * @brief Gets the name of a command source for logs
+ *
+ * @param source Command source
+ * @return "AUTO", "MANUAL" or "EMERGENCY"
+ */
+const char* commandSourceName(CommandSource source) {
+    switch (source) {
+        case CommandSource::MANUAL: return "MANUAL";
+        case CommandSource::EMERGENCY: return "EMERGENCY";
+        default: return "AUTO";
+    }
+}
+
+/**
+ * @brief Constructs the queue
+ *
+ * @param fan_count Number of fans
+ * @param tick Minimum interval between two batches of regular commands
+ * @param applier Function writing a batch, called by one thread at a time
+ */
+ActuatorQueue::ActuatorQueue(size_t fan_count, std::chrono::milliseconds tick, Applier applier)
+    : tick_(std::max(tick, std::chrono::milliseconds(0))), applier_(std::move(applier)),
+      slots_(fan_count), stats_(fan_count) {
+}
+
+/**
+ * @brief Stops the writer thread
+ */
+ActuatorQueue::~ActuatorQueue() {
+    stop();
+}
+
+/**
+ * @brief Starts the writer thread
+ */
+void ActuatorQueue::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    thread_ = std::thread(&ActuatorQueue::run, this);
+}
+
+/**
+ * @brief Stops the writer thread
+ *
+ * A batch being written is finished; commands still pending are discarded
+ * and waiters are released. Batches are also written by flush() on other
+ * threads, so the writer mutex is taken last: once this returns no batch is
+ * being applied and none will be.
+ */
+void ActuatorQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        for (auto& slot : slots_) {
+            slot.pending = false;
+        }
+        pending_count_ = 0;
+    }
+    work_cv_.notify_all();
+    applied_cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    std::lock_guard<std::mutex> writer_lock(writer_mutex_);
+}
+
+/**
+ * @brief Submits commands for one or more fans
+ *
+ * Each command takes its fan's slot unless the slot holds a command of higher
+ * priority; either way one of the two is counted as coalesced. Regular
+ * commands are written on the writer thread's next tick, a submission with an
+ * EMERGENCY command writes the pending batch right away on this thread.
+ * A reported submission keeps a copy of its commands whose written flags are
+ * filled in as they are applied; a command that loses its slot is never
+ * written and keeps the flag cleared.
+ *
+ * @param commands Commands, at most one per fan is kept
+ * @param report Keep the outcome of each command for wait_applied()
+ * @return Ticket to pass to wait_applied(), 0 if a fan index is invalid
+ */
+uint64_t ActuatorQueue::submit(const std::vector<ActuatorCommand>& commands, bool report) {
+    bool urgent = false;
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& command : commands) {
+            if (command.fan >= slots_.size()) {
+                return 0;
+            }
+        }
+        ticket = next_ticket_++;
+        if (report) {
+            std::vector<ActuatorCommand>& outcome = reports_[ticket];
+            outcome = commands;
+            for (auto& command : outcome) {
+                command.written = false;
+            }
+        }
+        for (const auto& command : commands) {
+            Slot& slot = slots_[command.fan];
+            ActuatorFanStats& stats = stats_[command.fan];
+            ++stats.submitted;
+            if (slot.pending) {
+                ++stats.coalesced;
+                if (slot.command.source > command.source) {
+                    continue;
+                }
+            } else {
+                slot.pending = true;
+                ++pending_count_;
+            }
+            slot.command = command;
+            slot.command.written = false;
+            slot.ticket = ticket;
+            urgent = urgent || command.source == CommandSource::EMERGENCY;
+        }
+    }
+    if (urgent) {
+        write_pending();
+    } else {
+        work_cv_.notify_one();
+    }
+    return ticket;
+}
+
+/**
+ * @brief Waits until the commands of a submission have been written or superseded
+ *
+ * The outcome of a reported submission is handed out and dropped here, also
+ * on timeout, so later batches no longer track it.
+ *
+ * @param ticket Ticket returned by submit()
+ * @param timeout Maximum time to wait
+ * @param outcome Receives the submitted commands with their written flags
+ * @return true if the submission was processed, false on timeout or stop
+ */
+bool ActuatorQueue::wait_applied(uint64_t ticket, std::chrono::milliseconds timeout,
+                                 std::vector<ActuatorCommand>* outcome) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool applied = applied_cv_.wait_for(lock, timeout, [this, ticket] {
+        return applied_ticket_ >= ticket || !running_;
+    }) && applied_ticket_ >= ticket;
+    auto report = reports_.find(ticket);
+    if (report != reports_.end()) {
+        if (outcome) {
+            *outcome = std::move(report->second);
+        }
+        reports_.erase(report);
+    }
+    return applied;
+}
+
+/**
+ * @brief Writes all pending commands on the calling thread without waiting for the tick
+ *
+ * @return true if everything submitted so far was processed, false if the queue is stopped
+ */
+bool ActuatorQueue::flush() {
+    return write_pending();
+}
+
+/**
+ * @brief Gets the counters of one fan
+ *
+ * @param fan Fan index
+ * @return Counters, all zero for an invalid index
+ */
+ActuatorFanStats ActuatorQueue::get_stats(size_t fan) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fan < stats_.size() ? stats_[fan] : ActuatorFanStats();
+}
+
+/**
+ * @brief Gets the number of batches written
+ *
+ * @return Batch count since construction
+ */
+uint64_t ActuatorQueue::get_batch_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_;
+}
+
+/**
+ * @brief Writer thread loop
+ *
+ * Sleeps until a command is pending, then until one tick after the previous
+ * batch, and writes everything pending as one batch. Commands arriving while
+ * a batch is written wait for the next one.
+ */
+void ActuatorQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        work_cv_.wait(lock, [this] { return pending_count_ > 0 || !running_; });
+        work_cv_.wait_until(lock, last_batch_ + tick_, [this] { return !running_; });
+        if (!running_) {
+            break;
+        }
+        lock.unlock();
+        write_pending();
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Takes all pending commands and writes them as one batch on the calling thread
+ *
+ * The writer mutex keeps batches in order: a batch taken later is only
+ * written after the previous one, and once this returns every submission
+ * made before the call has been processed.
+ *
+ * @return false if the queue is stopped
+ */
+bool ActuatorQueue::write_pending() {
+    std::lock_guard<std::mutex> writer_lock(writer_mutex_);
+    std::vector<ActuatorCommand> batch;
+    std::vector<uint64_t> tickets;
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        ticket = next_ticket_ - 1;
+        if (pending_count_ == 0) {
+            applied_ticket_ = std::max(applied_ticket_, ticket);
+            return true;
+        }
+        batch.reserve(pending_count_);
+        tickets.reserve(pending_count_);
+        for (auto& slot : slots_) {
+            if (slot.pending) {
+                batch.push_back(slot.command);
+                tickets.push_back(slot.ticket);
+                slot.pending = false;
+            }
+        }
+        pending_count_ = 0;
+        last_batch_ = std::chrono::steady_clock::now();
+    }
+
+    applier_(batch);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const ActuatorCommand& command = batch[i];
+            ActuatorFanStats& stats = stats_[command.fan];
+            ++(command.written ? stats.register_writes : stats.failed_writes);
+            auto report = reports_.find(tickets[i]);
+            if (report != reports_.end()) {
+                for (auto& reported : report->second) {
+                    if (reported.fan == command.fan) {
+                        reported.written = command.written;
+                    }
+                }
+            }
+        }
+        ++batches_;
+        applied_ticket_ = std::max(applied_ticket_, ticket);
+    }
+    applied_cv_.notify_all();
+    return true;
+}
+
+} // namespace fan_control_system
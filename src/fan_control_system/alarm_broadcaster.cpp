@@ -0,0 +1,204 @@
+#include "fan_control_system/alarm_broadcaster.hpp"
+#include <algorithm>
+
+namespace fan_control_system {
+
+/**
+ * @brief Constructs a subscription
+ *
+ * @param capacity Maximum number of buffered events
+ * @param source Source filter, empty for all sources
+ * @param min_severity Lowest severity delivered
+ */
+AlarmSubscription::AlarmSubscription(size_t capacity, const std::string& source, AlarmSeverity min_severity)
+    : capacity_(std::max<size_t>(capacity, 1)), source_(source), min_severity_(min_severity) {
+}
+
+/**
+ * @brief Waits for the next event
+ *
+ * Buffered events are still returned after the subscription was closed.
+ *
+ * @param event Next event
+ * @param timeout Maximum time to wait
+ * @return true if an event was returned, false on timeout or when closed and drained
+ */
+bool AlarmSubscription::next(AlarmEvent& event, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, timeout, [this] { return closed_ || !events_.empty(); }) || events_.empty()) {
+        return false;
+    }
+    event = *events_.front();
+    events_.pop_front();
+    return true;
+}
+
+/**
+ * @brief Gets the number of events dropped because the buffer was full
+ *
+ * @return Dropped event count
+ */
+uint64_t AlarmSubscription::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+/**
+ * @brief Checks whether the subscription was closed by the broadcaster
+ *
+ * @return true if closed
+ */
+bool AlarmSubscription::closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+/**
+ * @brief Checks whether an event passes the filter
+ *
+ * History clears without a source apply to every source; clears are not
+ * filtered by severity.
+ *
+ * @param event Event to check
+ * @return true if the event is delivered to this subscriber
+ */
+bool AlarmSubscription::matches(const AlarmEvent& event) const {
+    if (!source_.empty() && !event.source.empty() && event.source != source_) {
+        return false;
+    }
+    return event.type == AlarmEvent::Type::HISTORY_CLEARED ||
+           static_cast<int>(event.severity) >= static_cast<int>(min_severity_);
+}
+
+/**
+ * @brief Buffers an event, dropping the oldest if full
+ *
+ * @param event Event to buffer
+ */
+void AlarmSubscription::push(const std::shared_ptr<const AlarmEvent>& event) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        if (events_.size() >= capacity_) {
+            events_.pop_front();
+            dropped_++;
+        }
+        events_.push_back(event);
+    }
+    cv_.notify_one();
+}
+
+/**
+ * @brief Wakes the consumer and makes next() return false once drained
+ */
+void AlarmSubscription::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+}
+
+/**
+ * @brief Constructs the broadcaster
+ *
+ * @param buffer_size Events buffered per subscriber
+ * @param max_subscribers Maximum number of concurrent subscribers
+ */
+AlarmBroadcaster::AlarmBroadcaster(size_t buffer_size, size_t max_subscribers)
+    : buffer_size_(buffer_size)
+    , max_subscribers_(max_subscribers)
+    , subscribers_(std::make_shared<SubscriberList>()) {
+}
+
+/**
+ * @brief Adds a subscriber
+ *
+ * @param source Source filter, empty for all sources
+ * @param min_severity Lowest severity delivered
+ * @return Subscription, or nullptr if the subscriber limit is reached
+ */
+std::shared_ptr<AlarmSubscription> AlarmBroadcaster::subscribe(const std::string& source, AlarmSeverity min_severity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (subscribers_->size() >= max_subscribers_) {
+        return nullptr;
+    }
+    auto subscription = std::make_shared<AlarmSubscription>(buffer_size_, source, min_severity);
+    auto list = std::make_shared<SubscriberList>(*subscribers_);
+    list->push_back(subscription);
+    subscribers_ = std::move(list);
+    return subscription;
+}
+
+/**
+ * @brief Removes and closes a subscriber
+ *
+ * @param subscription Subscription returned by subscribe()
+ */
+void AlarmBroadcaster::unsubscribe(const std::shared_ptr<AlarmSubscription>& subscription) {
+    if (!subscription) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto list = std::make_shared<SubscriberList>(*subscribers_);
+        list->erase(std::remove(list->begin(), list->end(), subscription), list->end());
+        subscribers_ = std::move(list);
+    }
+    subscription->close();
+}
+
+/**
+ * @brief Delivers an event to every matching subscriber
+ *
+ * Never blocks on a subscriber; see AlarmSubscription::push().
+ *
+ * @param event Event to deliver
+ */
+void AlarmBroadcaster::publish(AlarmEvent event) {
+    std::shared_ptr<const SubscriberList> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event.sequence = ++sequence_;
+        subscribers = subscribers_;
+    }
+    if (subscribers->empty()) {
+        return;
+    }
+
+    auto shared_event = std::make_shared<const AlarmEvent>(std::move(event));
+    for (const auto& subscriber : *subscribers) {
+        if (subscriber->matches(*shared_event)) {
+            subscriber->push(shared_event);
+        }
+    }
+}
+
+/**
+ * @brief Closes and removes all subscribers
+ */
+void AlarmBroadcaster::close_all() {
+    std::shared_ptr<const SubscriberList> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscribers = subscribers_;
+        subscribers_ = std::make_shared<SubscriberList>();
+    }
+    for (const auto& subscriber : *subscribers) {
+        subscriber->close();
+    }
+}
+
+/**
+ * @brief Gets the number of subscribers
+ *
+ * @return Subscriber count
+ */
+size_t AlarmBroadcaster::subscriber_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_->size();
+}
+
+} // namespace fan_control_system
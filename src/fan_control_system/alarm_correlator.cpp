@@ -0,0 +1,187 @@
+#include "fan_control_system/alarm_correlator.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace fan_control_system {
+
+/**
+ * @brief Constructs the correlator
+ *
+ * @param settings Window, retention and rules
+ */
+AlarmCorrelator::AlarmCorrelator(const AlarmCorrelationSettings& settings)
+    : settings_(settings) {
+}
+
+/**
+ * @brief Assigns an alarm to an incident
+ *
+ * Only the rule lookup and one hash lookup happen under the lock, so this is
+ * cheap enough to run ahead of the fast actions.
+ *
+ * @param source Alarm source
+ * @param alarm_id Alarm id within the source, empty if unknown
+ * @param message Alarm message
+ * @param severity Alarm severity
+ * @param now_ms Current time in milliseconds since the epoch
+ * @return Incident and whether the alarm is significant for it
+ */
+CorrelationResult AlarmCorrelator::correlate(const std::string& source, const std::string& alarm_id,
+                                             const std::string& message, AlarmSeverity severity, int64_t now_ms) {
+    CorrelationResult result;
+
+    const CorrelationRule* rule = nullptr;
+    std::string key;
+    for (const auto& candidate : settings_.rules) {
+        bool covered = false;
+        for (const auto& pattern : candidate.sources) {
+            if (matches(pattern, source)) {
+                covered = true;
+                break;
+            }
+        }
+        if (!covered) {
+            continue;
+        }
+        if (!candidate.group_by.empty()) {
+            key = find_key(candidate.group_by, source);
+            if (key.empty()) key = find_key(candidate.group_by, alarm_id);
+            if (key.empty()) key = find_key(candidate.group_by, message);
+            if (key.empty()) {
+                continue;
+            }
+        }
+        rule = &candidate;
+        break;
+    }
+    if (!rule) {
+        return result;
+    }
+
+    bool is_parent = !rule->parent.empty() && matches(rule->parent, source);
+    std::string group = rule->name + "/" + key;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    AlarmIncident* incident = nullptr;
+    auto open_it = open_groups_.find(group);
+    if (open_it != open_groups_.end()) {
+        incident = find_incident(open_it->second);
+        if (incident && now_ms - incident->latest_time_ms > settings_.window_ms) {
+            incident = nullptr;
+        }
+    }
+
+    if (!incident) {
+        AlarmIncident created;
+        created.id = next_id_++;
+        created.rule = rule->name;
+        created.key = key;
+        created.root_source = source;
+        created.root_message = message;
+        created.severity = severity;
+        created.first_time_ms = now_ms;
+        incidents_.push_back(std::move(created));
+        while (incidents_.size() > settings_.max_incidents && incidents_.size() > 1) {
+            incidents_.pop_front();
+        }
+        incident = &incidents_.back();
+        open_groups_[group] = incident->id;
+        result.new_incident = true;
+    } else {
+        if (static_cast<int>(severity) > static_cast<int>(incident->severity)) {
+            incident->severity = severity;
+            result.escalated = true;
+        } else {
+            incident->suppressed_actions++;
+        }
+        // The parent takes over as root cause from a child that was seen first
+        if (is_parent && !matches(rule->parent, incident->root_source)) {
+            incident->root_source = source;
+            incident->root_message = message;
+        }
+    }
+
+    incident->latest_time_ms = now_ms;
+    incident->alarm_count++;
+    incident->members[source]++;
+    result.incident_id = incident->id;
+    return result;
+}
+
+/**
+ * @brief Gets the retained incidents
+ *
+ * @param now_ms Current time in milliseconds since the epoch, used for the open flag
+ * @param max_incidents Maximum number returned, 0 for all
+ * @return Incidents, newest first
+ */
+std::vector<AlarmIncident> AlarmCorrelator::get_incidents(int64_t now_ms, size_t max_incidents) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<AlarmIncident> incidents;
+    size_t count = max_incidents == 0 ? incidents_.size() : std::min(max_incidents, incidents_.size());
+    incidents.reserve(count);
+    for (auto it = incidents_.rbegin(); it != incidents_.rend() && incidents.size() < count; ++it) {
+        incidents.push_back(*it);
+        incidents.back().open = now_ms - it->latest_time_ms <= settings_.window_ms;
+    }
+    return incidents;
+}
+
+/**
+ * @brief Checks a source against a pattern
+ *
+ * @param pattern Exact source name, or a prefix followed by '*'
+ * @param source Alarm source
+ * @return true if the source matches
+ */
+bool AlarmCorrelator::matches(const std::string& pattern, const std::string& source) {
+    if (!pattern.empty() && pattern.back() == '*') {
+        return source.compare(0, pattern.size() - 1, pattern, 0, pattern.size() - 1) == 0;
+    }
+    return pattern == source;
+}
+
+/**
+ * @brief Finds the first "<prefix><digits>" token in a text
+ *
+ * The token must start the text or follow a non-alphanumeric character, so
+ * "MCU001" is found in "stddev.MCU001" and "MCU MCU001 ..." but "MCUSimulator"
+ * has no key.
+ *
+ * @param prefix Token prefix
+ * @param text Text to search
+ * @return Token, empty if none
+ */
+std::string AlarmCorrelator::find_key(const std::string& prefix, const std::string& text) {
+    for (size_t pos = text.find(prefix); pos != std::string::npos; pos = text.find(prefix, pos + 1)) {
+        if (pos > 0 && std::isalnum(static_cast<unsigned char>(text[pos - 1]))) {
+            continue;
+        }
+        size_t end = pos + prefix.size();
+        while (end < text.size() && std::isdigit(static_cast<unsigned char>(text[end]))) {
+            end++;
+        }
+        if (end > pos + prefix.size()) {
+            return text.substr(pos, end - pos);
+        }
+    }
+    return "";
+}
+
+/**
+ * @brief Gets a retained incident by id
+ *
+ * Ids are consecutive, so the position in the deque follows from the id.
+ *
+ * @param id Incident id
+ * @return Incident, nullptr if it was dropped
+ */
+AlarmIncident* AlarmCorrelator::find_incident(uint64_t id) {
+    if (incidents_.empty() || id < incidents_.front().id) {
+        return nullptr;
+    }
+    size_t index = static_cast<size_t>(id - incidents_.front().id);
+    return index < incidents_.size() ? &incidents_[index] : nullptr;
+}
+
+} // namespace fan_control_system
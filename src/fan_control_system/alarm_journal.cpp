@@ -0,0 +1,477 @@
+#include "fan_control_system/alarm_journal.hpp"
+#include "fan_control_system/alarm_manager.hpp"
+#include "fan_control_system/alarm_store.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <experimental/filesystem>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::experimental::filesystem;
+
+namespace fan_control_system {
+
+namespace {
+
+const char kSnapshotMagic[8] = {'F', 'C', 'S', 'S', 'N', 'A', 'P', '1'};
+
+/**
+ * @struct RecordHeader
+ * @brief Fixed header preceding every journal record
+ *
+ * The checksum covers the sequence number, type and payload.
+ */
+struct RecordHeader {
+    uint32_t payload_size;   ///< Bytes of payload following the header
+    uint32_t checksum;       ///< CRC-32 of sequence, type and payload
+    uint64_t sequence;       ///< Monotonic record sequence number
+    uint8_t type;            ///< RecordType
+    uint8_t reserved[7];     ///< Padding, always zero
+};
+
+/**
+ * @struct SnapshotHeader
+ * @brief Fixed header of the snapshot file
+ */
+struct SnapshotHeader {
+    char magic[8];           ///< kSnapshotMagic
+    uint64_t sequence;       ///< Last journal sequence contained in the image
+    uint64_t image_size;     ///< Bytes of store image following the header
+    uint32_t checksum;       ///< CRC-32 of the image
+    uint32_t reserved;       ///< Padding, always zero
+};
+
+/**
+ * @brief Computes a CRC-32 (IEEE) over a buffer, continuing from a previous value
+ */
+uint32_t crc32(const void* data, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)initialized;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t record_checksum(const RecordHeader& header, const char* payload) {
+    uint32_t crc = crc32(&header.sequence, sizeof(header.sequence));
+    crc = crc32(&header.type, sizeof(header.type), crc);
+    return crc32(payload, header.payload_size, crc);
+}
+
+/**
+ * @brief Reads a whole file with one sequential read
+ * @return false if the file does not exist or cannot be read
+ */
+bool read_file(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::streamsize size = file.tellg();
+    file.seekg(0);
+    contents.resize(static_cast<size_t>(size));
+    return size == 0 || file.read(&contents[0], size);
+}
+
+/**
+ * @brief Writes a buffer to a file descriptor, retrying short writes
+ */
+bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Atomically replaces a file: write to a temporary, sync, rename
+ */
+bool replace_file(const std::string& path, const std::string& head, const std::string& body) {
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = write_all(fd, head.data(), head.size()) && write_all(fd, body.data(), body.size()) &&
+              ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Finds the offset of the first record with a sequence above the given one
+ *
+ * Records in a buffer are in increasing sequence order.
+ */
+size_t find_records_after(const std::string& buffer, uint64_t sequence) {
+    size_t offset = 0;
+    while (offset + sizeof(RecordHeader) <= buffer.size()) {
+        RecordHeader header;
+        std::memcpy(&header, buffer.data() + offset, sizeof(header));
+        if (header.sequence > sequence) {
+            break;
+        }
+        offset += sizeof(header) + header.payload_size;
+    }
+    return std::min(offset, buffer.size());
+}
+
+} // namespace
+
+/**
+ * @brief Constructs the journal
+ *
+ * @param settings Directory, group-commit interval and snapshot cadence
+ */
+AlarmJournal::AlarmJournal(const AlarmJournalSettings& settings)
+    : settings_(settings)
+    , snapshot_path_((fs::path(settings.directory) / "alarms.snapshot").string())
+    , journal_path_((fs::path(settings.directory) / "alarms.journal").string()) {
+    settings_.group_commit_ms = std::max(settings_.group_commit_ms, 1);
+    settings_.snapshot_every_records = std::max<size_t>(settings_.snapshot_every_records, 1);
+}
+
+/**
+ * @brief Destructor that stops the writer thread
+ */
+AlarmJournal::~AlarmJournal() {
+    stop();
+}
+
+/**
+ * @brief Rebuilds a store from the latest snapshot and the journal tail
+ *
+ * Records up to the snapshot's sequence are skipped; the rest are applied in
+ * order. Reading stops at the first truncated or corrupt record and the file
+ * is cut back to the last valid one.
+ *
+ * @param store Store to load into
+ * @param recovery Recovery measurements
+ * @return true on success
+ */
+bool AlarmJournal::recover(AlarmStore& store, AlarmJournalRecovery& recovery) {
+    auto start_time = std::chrono::steady_clock::now();
+    recovery = AlarmJournalRecovery();
+
+    try {
+        fs::create_directories(fs::path(settings_.directory));
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to create alarm journal directory: " << e.what() << std::endl;
+        return false;
+    }
+
+    uint64_t snapshot_sequence = 0;
+    std::string contents;
+    if (read_file(snapshot_path_, contents)) {
+        recovery.snapshot_bytes = contents.size();
+        SnapshotHeader header;
+        if (contents.size() >= sizeof(header)) {
+            std::memcpy(&header, contents.data(), sizeof(header));
+            std::string image = contents.substr(sizeof(header));
+            if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 &&
+                header.image_size == image.size() &&
+                header.checksum == crc32(image.data(), image.size()) &&
+                store.deserialize(image)) {
+                snapshot_sequence = header.sequence;
+                recovery.snapshot_loaded = true;
+            }
+        }
+        if (!recovery.snapshot_loaded) {
+            std::cerr << "Ignoring invalid alarm snapshot: " << snapshot_path_ << std::endl;
+        }
+    }
+
+    uint64_t last_sequence = snapshot_sequence;
+    contents.clear();
+    if (read_file(journal_path_, contents)) {
+        recovery.journal_bytes = contents.size();
+        size_t offset = 0;
+        while (offset < contents.size()) {
+            RecordHeader header;
+            if (contents.size() - offset < sizeof(header)) {
+                break;
+            }
+            std::memcpy(&header, contents.data() + offset, sizeof(header));
+            const char* payload = contents.data() + offset + sizeof(header);
+            if (contents.size() - offset - sizeof(header) < header.payload_size ||
+                header.checksum != record_checksum(header, payload)) {
+                break;
+            }
+
+            if (header.sequence <= snapshot_sequence) {
+                recovery.records_skipped++;
+            } else {
+                const char* end = payload + header.payload_size;
+                if (header.type == static_cast<uint8_t>(RecordType::UPSERT)) {
+                    AlarmEntry entry;
+                    if (!AlarmStore::decode_entry(payload, end, entry)) {
+                        break;
+                    }
+                    bool inserted;
+                    store.add_or_update(entry, inserted);
+                } else if (header.type == static_cast<uint8_t>(RecordType::CLEAR)) {
+                    store.clear(std::string(payload, end));
+                } else {
+                    break;
+                }
+                recovery.records_replayed++;
+            }
+            last_sequence = std::max(last_sequence, header.sequence);
+            offset += sizeof(header) + header.payload_size;
+        }
+
+        if (offset < contents.size()) {
+            recovery.tail_truncated = true;
+            if (::truncate(journal_path_.c_str(), static_cast<off_t>(offset)) != 0) {
+                std::cerr << "Failed to truncate alarm journal: " << journal_path_ << std::endl;
+                return false;
+            }
+        }
+        records_since_snapshot_ = recovery.records_replayed + recovery.records_skipped;
+    }
+
+    last_sequence_.store(last_sequence);
+    recovery.duration_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+    return true;
+}
+
+/**
+ * @brief Opens the journal for appending and starts the writer thread
+ *
+ * If the journal holds any records after recovery, the writer first compacts
+ * them into a snapshot so that the next start reads just the snapshot.
+ *
+ * @param snapshot_source Callback producing store snapshots
+ * @return true if the journal file could be opened
+ */
+bool AlarmJournal::start(SnapshotSource snapshot_source) {
+    if (!open_journal()) {
+        return false;
+    }
+    snapshot_source_ = std::move(snapshot_source);
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        running_ = true;
+    }
+    writer_ = std::thread(&AlarmJournal::writer_loop, this);
+    return true;
+}
+
+/**
+ * @brief Flushes buffered records, writes a final snapshot and stops the writer
+ */
+void AlarmJournal::stop() {
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    buffer_cv_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+        journal_fd_ = -1;
+    }
+}
+
+/**
+ * @brief Appends an upsert record
+ *
+ * @param entry Entry passed to AlarmStore::add_or_update
+ */
+void AlarmJournal::append_upsert(const AlarmEntry& entry) {
+    std::string payload;
+    AlarmStore::encode_entry(entry, payload);
+    append(RecordType::UPSERT, payload);
+}
+
+/**
+ * @brief Appends a clear record
+ *
+ * @param source Source passed to AlarmStore::clear, empty for all
+ */
+void AlarmJournal::append_clear(const std::string& source) {
+    append(RecordType::CLEAR, source);
+}
+
+/**
+ * @brief Encodes a record into the pending buffer
+ *
+ * Only copies into memory; the writer thread does the I/O.
+ *
+ * @param type Record type
+ * @param payload Encoded payload
+ */
+void AlarmJournal::append(RecordType type, const std::string& payload) {
+    RecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.payload_size = static_cast<uint32_t>(payload.size());
+    header.type = static_cast<uint8_t>(type);
+
+    std::lock_guard<std::mutex> lock(buffer_mutex_);
+    header.sequence = last_sequence_.load() + 1;
+    header.checksum = record_checksum(header, payload.data());
+    last_sequence_.store(header.sequence);
+    pending_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    pending_.append(payload);
+    pending_records_++;
+}
+
+/**
+ * @brief Writer thread loop
+ *
+ * Wakes once per group-commit interval, writes and syncs everything appended
+ * since the last wake-up, and compacts the journal when enough records have
+ * accumulated. A final flush and snapshot are done on stop.
+ */
+void AlarmJournal::writer_loop() {
+    bool compact = records_since_snapshot_ > 0;
+    for (;;) {
+        bool running;
+        {
+            std::unique_lock<std::mutex> lock(buffer_mutex_);
+            buffer_cv_.wait_for(lock, std::chrono::milliseconds(settings_.group_commit_ms),
+                                [this] { return !running_; });
+            running = running_;
+        }
+
+        if (!flush()) {
+            std::cerr << "Failed to write alarm journal: " << journal_path_ << std::endl;
+        }
+        if (compact || records_since_snapshot_ >= settings_.snapshot_every_records || !running) {
+            if (!snapshot()) {
+                std::cerr << "Failed to write alarm snapshot: " << snapshot_path_ << std::endl;
+            }
+            compact = false;
+        }
+        if (!running) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Writes the pending buffer to the journal and syncs it
+ *
+ * @param written Receives the bytes that were written, if not null
+ * @return true on success
+ */
+bool AlarmJournal::flush(std::string* written) {
+    std::string batch;
+    size_t records;
+    {
+        std::lock_guard<std::mutex> lock(buffer_mutex_);
+        batch.swap(pending_);
+        records = pending_records_;
+        pending_records_ = 0;
+    }
+    if (written) {
+        *written = batch;
+    }
+    if (batch.empty()) {
+        return true;
+    }
+
+    records_since_snapshot_ += records;
+    return journal_fd_ >= 0 && write_all(journal_fd_, batch.data(), batch.size()) && ::fdatasync(journal_fd_) == 0;
+}
+
+/**
+ * @brief Saves a snapshot and rewrites the journal to the records newer than it
+ *
+ * The store image is captured at sequence S. Everything buffered is written to
+ * the journal first, so the old snapshot plus journal stay complete until the
+ * new snapshot has been renamed into place. Records newer than S can only be in
+ * that last batch; the journal is then replaced by just those records. A crash
+ * at any point leaves a snapshot and a journal whose records up to the
+ * snapshot's sequence are skipped on recovery.
+ *
+ * @return true on success
+ */
+bool AlarmJournal::snapshot() {
+    std::string image;
+    uint64_t sequence = 0;
+    snapshot_source_(image, sequence);
+
+    std::string batch;
+    if (!flush(&batch)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.sequence = sequence;
+    header.image_size = image.size();
+    header.checksum = crc32(image.data(), image.size());
+    if (!replace_file(snapshot_path_, std::string(reinterpret_cast<const char*>(&header), sizeof(header)), image)) {
+        return false;
+    }
+
+    std::string tail = batch.substr(find_records_after(batch, sequence));
+    if (!replace_file(journal_path_, std::string(), tail)) {
+        return false;
+    }
+    records_since_snapshot_ = 0;
+    for (size_t offset = 0; offset + sizeof(RecordHeader) <= tail.size();) {
+        RecordHeader record;
+        std::memcpy(&record, tail.data() + offset, sizeof(record));
+        offset += sizeof(record) + record.payload_size;
+        records_since_snapshot_++;
+    }
+    return open_journal();
+}
+
+/**
+ * @brief Opens (or reopens) the journal file for appending
+ *
+ * @return true on success
+ */
+bool AlarmJournal::open_journal() {
+    if (journal_fd_ >= 0) {
+        ::close(journal_fd_);
+    }
+    journal_fd_ = ::open(journal_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (journal_fd_ < 0) {
+        std::cerr << "Failed to open alarm journal: " << journal_path_ << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace fan_control_system
@@ -1,10 +1,11 @@
 #include "fan_control_system/alarm_manager.hpp"
+#include "fan_control_system/alarm_store.hpp"
+#include "fan_control_system/alarm_broadcaster.hpp"
+#include "fan_control_system/action_executor.hpp"
 #include "common/utils.hpp"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
-#include <nlohmann/json.hpp>
-#include <iomanip>
-#include <sstream>
 
 namespace fan_control_system {
 
@@ -25,6 +26,11 @@ AlarmManager::AlarmManager(const YAML::Node& config, const common::MQTTClient::S
     if (!load_alarm_configs()) {
         throw std::runtime_error("Failed to initialize alarm manager");
     }
+    alarm_store_ = std::make_unique<AlarmStore>(static_cast<size_t>(std::max(max_history_entries_, 1)));
+    alarm_broadcaster_ = std::make_unique<AlarmBroadcaster>(alarm_config_.watch_buffer_size, alarm_config_.max_watchers);
+    if (alarm_config_.correlation.enabled) {
+        alarm_correlator_ = std::make_unique<AlarmCorrelator>(alarm_config_.correlation);
+    }
 }
 
 /**
@@ -39,7 +45,8 @@ AlarmManager::~AlarmManager() {
 /**
  * @brief Starts the alarm manager
  * 
- * Initializes MQTT client and logger, starts the main monitoring thread.
+ * Initializes MQTT client and logger. Alarms are processed on the callers'
+ * threads, so no thread of its own is started.
  * 
  * @return true if startup was successful, false otherwise
  */
@@ -53,14 +60,13 @@ bool AlarmManager::start() {
     }
 
     running_ = true;
-    main_thread_ = std::thread(&AlarmManager::main_thread_function, this);
     return true;
 }
 
 /**
  * @brief Stops the alarm manager
  * 
- * Stops the main monitoring thread and cleans up resources.
+ * Stops the action executor and journal and closes the alarm watchers.
  */
 void AlarmManager::stop() {
     if (!running_) {
@@ -68,9 +74,13 @@ void AlarmManager::stop() {
     }
 
     running_ = false;
-    if (main_thread_.joinable()) {
-        main_thread_.join();
+    if (action_executor_) {
+        action_executor_->stop();
+    }
+    if (alarm_journal_) {
+        alarm_journal_->stop();
     }
+    alarm_broadcaster_->close_all();
 }
 
 /**
@@ -100,6 +110,19 @@ void AlarmManager::register_action(
     action_callbacks_[action_name] = callback;
 }
 
+/**
+ * @brief Registers a latency-critical action run inline when an alarm arrives
+ * 
+ * @param action_name Name of the action to register
+ * @param callback Function to be called when the action is triggered
+ */
+void AlarmManager::register_fast_action(
+    const std::string& action_name,
+    std::function<void(const std::string&, const std::string&)> callback) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    fast_action_callbacks_[action_name] = callback;
+}
+
 /**
  * @brief Gets the configuration for the alarm system
  * 
@@ -114,95 +137,61 @@ const AlarmConfig& AlarmManager::get_alarm_config() const {
 
 std::vector<AlarmEntry> AlarmManager::get_alarm_history(const std::string& alarm_name, int max_entries) const {
     std::lock_guard<std::mutex> lock(history_mutex_);
-    std::vector<AlarmEntry> result;
-    
-    for (const auto& entry : alarm_history_) {
-        if (alarm_name.empty() || entry.name == alarm_name) {
-            result.push_back(entry);
-            if (max_entries > 0 && result.size() >= static_cast<size_t>(max_entries)) {
-                break;
-            }
-        }
-    }
-    
-    return result;
+    return alarm_store_->get_entries(alarm_name, max_entries);
 }
 
 int AlarmManager::clear_alarm_history(const std::string& alarm_name) {
     std::lock_guard<std::mutex> lock(history_mutex_);
-    int cleared_count = 0;
-    
-    if (alarm_name.empty()) {
-        cleared_count = alarm_history_.size();
-        alarm_history_.clear();
-    } else {
-        auto it = alarm_history_.begin();
-        while (it != alarm_history_.end()) {
-            if (it->name == alarm_name) {
-                it = alarm_history_.erase(it);
-                cleared_count++;
-            } else {
-                ++it;
-            }
-        }
+    if (alarm_journal_) {
+        alarm_journal_->append_clear(alarm_name);
     }
-    
-    return cleared_count;
+    int cleared = alarm_store_->clear(alarm_name);
+
+    AlarmEvent event;
+    event.type = AlarmEvent::Type::HISTORY_CLEARED;
+    event.source = alarm_name;
+    event.timestamp = common::utils::formatTimestampMs(std::chrono::system_clock::now());
+    event.cleared_entries = cleared;
+    alarm_broadcaster_->publish(std::move(event));
+    return cleared;
 }
 
 std::vector<AlarmStatistics> AlarmManager::get_alarm_statistics(const std::string& alarm_name, int time_window_hours) const {
-    std::lock_guard<std::mutex> lock(history_mutex_);
-    std::map<std::string, AlarmStatistics> stats_map;
-    
-    auto now = std::chrono::system_clock::now();
-    auto window_duration = std::chrono::hours(time_window_hours);
-    
-    for (const auto& entry : alarm_history_) {
-        // Parse latest timestamp and check if within time window
-        std::tm tm = {};
-        std::istringstream ss(entry.latest_timestamp);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-        auto entry_time = std::chrono::system_clock::from_time_t(std::mktime(&tm));
-        
-        if (now - entry_time > window_duration) {
-            continue; // Skip entries outside time window
-        }
-        
-        if (!alarm_name.empty() && entry.name != alarm_name) {
-            continue; // Skip if filtering by specific alarm
-        }
-        
-        auto& stats = stats_map[entry.name];
-        stats.alarm_name = entry.name;
-        stats.total_count++;
-        stats.total_occurrences += entry.occurrence_count;
-        
-        if (entry.is_active) {
-            stats.active_count++;
-        }
-        
-        if (entry.acknowledged) {
-            stats.acknowledged_count++;
-        }
-        
-        std::string severity_str = severity_to_string(entry.severity);
-        stats.severity_counts[severity_str]++;
-        
-        if (stats.last_occurrence.empty() || entry.latest_timestamp > stats.last_occurrence) {
-            stats.last_occurrence = entry.latest_timestamp;
-        }
-        
-        if (stats.first_occurrence.empty() || entry.first_timestamp < stats.first_occurrence) {
-            stats.first_occurrence = entry.first_timestamp;
-        }
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    // Only the counters are copied under the lock; summing, formatting and
+    // sorting happen after it is released so that ingest is not held up
+    AlarmStore::StatisticsSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        alarm_store_->snapshot_statistics(alarm_name, time_window_hours, now_ms, snapshot);
     }
-    
-    std::vector<AlarmStatistics> result;
-    for (const auto& pair : stats_map) {
-        result.push_back(pair.second);
+    return AlarmStore::summarize_statistics(snapshot);
+}
+
+ActionExecutorStats AlarmManager::get_action_executor_stats() const {
+    if (!action_executor_) {
+        return ActionExecutorStats();
     }
-    
-    return result;
+    return action_executor_->get_stats();
+}
+
+std::shared_ptr<AlarmSubscription> AlarmManager::watch_alarms(const std::string& alarm_name, AlarmSeverity min_severity) {
+    return alarm_broadcaster_->subscribe(alarm_name, min_severity);
+}
+
+void AlarmManager::unwatch_alarms(const std::shared_ptr<AlarmSubscription>& subscription) {
+    alarm_broadcaster_->unsubscribe(subscription);
+}
+
+std::vector<AlarmIncident> AlarmManager::get_incidents(size_t max_incidents) const {
+    if (!alarm_correlator_) {
+        return {};
+    }
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return alarm_correlator_->get_incidents(now_ms, max_incidents);
 }
 
 /**
@@ -224,6 +213,15 @@ bool AlarmManager::initialize() {
     logger_ = std::make_unique<common::Logger>(name_, log_level, mqtt_client_);
     logger_->info("Alarm Manager initialized successfully");
 
+    // Restore the alarm history persisted by the previous run
+    if (alarm_config_.journal.enabled && !recover_alarm_history()) {
+        return false;
+    }
+
+    // Start the action executor before alarms can arrive
+    action_executor_ = std::make_unique<ActionExecutor>(alarm_config_.action_executor, logger_.get());
+    action_executor_->start();
+
     // Subscribe to alarm topics from other modules
     mqtt_client_->subscribe("alarms/#", 0);
 
@@ -233,6 +231,44 @@ bool AlarmManager::initialize() {
     return true;
 }
 
+/**
+ * @brief Restores the alarm history from the journal and starts journaling
+ * 
+ * Loads the latest snapshot and replays the newer journal records into the
+ * store, logs how long that took, then starts the journal writer. Snapshots
+ * are captured under the history mutex so that the image and its journal
+ * sequence number are consistent.
+ * 
+ * @return true if recovery succeeded, false otherwise
+ */
+bool AlarmManager::recover_alarm_history() {
+    alarm_journal_ = std::make_unique<AlarmJournal>(alarm_config_.journal);
+
+    AlarmJournalRecovery recovery;
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        if (!alarm_journal_->recover(*alarm_store_, recovery)) {
+            logger_->error("Failed to recover alarm history from: " + alarm_config_.journal.directory);
+            alarm_journal_.reset();
+            return false;
+        }
+        logger_->info("Recovered " + std::to_string(alarm_store_->size()) + " alarm entries in " +
+                      std::to_string(recovery.duration_us) + " us (snapshot " +
+                      std::to_string(recovery.snapshot_bytes) + " bytes, journal " +
+                      std::to_string(recovery.journal_bytes) + " bytes, " +
+                      std::to_string(recovery.records_replayed) + " records replayed)");
+    }
+    if (recovery.tail_truncated) {
+        logger_->warning("Discarded torn alarm journal tail");
+    }
+
+    return alarm_journal_->start([this](std::string& image, uint64_t& sequence) {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        alarm_store_->serialize(image);
+        sequence = alarm_journal_->last_sequence();
+    });
+}
+
 /**
  * @brief Callback function for MQTT messages
  * 
@@ -246,35 +282,44 @@ void AlarmManager::mqtt_message_callback(
     if (!manager) return;
     
     std::string topic(reinterpret_cast<const char*>(msg->topic));
-    std::string payload(reinterpret_cast<const char*>(msg->payload), msg->payloadlen);
     
-    manager->process_mqtt_alarm_message(topic, payload);
+    manager->process_mqtt_alarm_message(topic, static_cast<const char*>(msg->payload), msg->payloadlen);
 }
 
 /**
  * @brief Processes incoming MQTT alarm messages
  * 
+ * Decodes the typed alarm message published by common::Alarm. Its severity is
+ * the shared common::AlarmSeverity, so the action table entry is selected
+ * without any conversion; the event time is only formatted for watchers of
+ * cleared alarms.
+ * 
  * @param topic MQTT topic
- * @param payload Message payload
+ * @param payload Encoded common::AlarmMessage
+ * @param size Payload size in bytes
  */
-void AlarmManager::process_mqtt_alarm_message(const std::string& topic, const std::string& payload) {
-    try {
-        nlohmann::json alarm_json = nlohmann::json::parse(payload);
-        
-        // Extract fields from the actual alarm message format
-        std::string source = alarm_json.value("source", "");
-        std::string message = alarm_json.value("message", "");
-        std::string state = alarm_json.value("state", "");
-        int severity_int = alarm_json.value("severity", 0);
-        std::string timestamp = alarm_json.value("timestamp", "");
-        
-        // Only process raised alarms (not cleared ones)
-        if (state == "raised" && !source.empty() && !message.empty()) {
-            AlarmSeverity severity = static_cast<AlarmSeverity>(severity_int);
-            process_alarm(source, severity, message);
-        }
-    } catch (const std::exception& e) {
-        logger_->error("Failed to process MQTT alarm message: " + std::string(e.what()));
+void AlarmManager::process_mqtt_alarm_message(const std::string& topic, const char* payload, size_t size) {
+    common::AlarmMessage alarm;
+    if (!common::AlarmMessage::decode(payload, size, alarm)) {
+        logger_->error("Discarding malformed alarm message on " + topic);
+        return;
+    }
+
+    if (alarm.state == common::AlarmMessage::State::RAISED && !alarm.source.empty() && !alarm.message.empty()) {
+        process_alarm(alarm.source, alarm.severity, alarm.message, alarm.alarm_id);
+    } else if (alarm.state == common::AlarmMessage::State::CLEARED && !alarm.source.empty()) {
+        // Cleared alarms run no actions and keep their history; only watchers are told
+        AlarmEvent event;
+        event.type = AlarmEvent::Type::CLEARED;
+        event.source = std::move(alarm.source);
+        event.alarm_id = std::move(alarm.alarm_id);
+        event.message = std::move(alarm.message);
+        event.severity = alarm.severity;
+        event.timestamp = common::utils::formatTimestampMs(std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(alarm.epoch_ns))));
+
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        alarm_broadcaster_->publish(std::move(event));
     }
 }
 
@@ -293,6 +338,56 @@ bool AlarmManager::load_alarm_configs() {
         // Load alarm history size
         alarm_config_.alarm_history_size = alarms["AlarmHistory"].as<int>();
         max_history_entries_ = alarm_config_.alarm_history_size;
+
+        // Load action executor settings (optional, defaults otherwise)
+        const auto& executor = alarms["ActionExecutor"];
+        if (executor) {
+            auto& settings = alarm_config_.action_executor;
+            if (executor["Workers"]) settings.workers = executor["Workers"].as<int>();
+            if (executor["QueueCapacity"]) settings.queue_capacity = executor["QueueCapacity"].as<size_t>();
+            if (executor["DefaultTimeoutMs"]) settings.default_timeout_ms = executor["DefaultTimeoutMs"].as<int>();
+            if (executor["StopTimeoutMs"]) settings.stop_timeout_ms = executor["StopTimeoutMs"].as<int>();
+            if (executor["MaxAbandonedWorkers"]) settings.max_abandoned_workers = executor["MaxAbandonedWorkers"].as<int>();
+            for (const auto& timeout : executor["TimeoutsMs"]) {
+                settings.timeouts_ms[timeout.first.as<std::string>()] = timeout.second.as<int>();
+            }
+        }
+
+        // Load alarm journal settings (optional, disabled otherwise)
+        const auto& journal = alarms["Journal"];
+        if (journal) {
+            auto& settings = alarm_config_.journal;
+            if (journal["Enabled"]) settings.enabled = journal["Enabled"].as<bool>();
+            if (journal["Directory"]) settings.directory = journal["Directory"].as<std::string>();
+            if (journal["GroupCommitMs"]) settings.group_commit_ms = journal["GroupCommitMs"].as<int>();
+            if (journal["SnapshotEveryRecords"]) settings.snapshot_every_records = journal["SnapshotEveryRecords"].as<size_t>();
+        }
+
+        // Load alarm watch settings (optional, defaults otherwise)
+        const auto& watch = alarms["Watch"];
+        if (watch) {
+            if (watch["BufferSize"]) alarm_config_.watch_buffer_size = watch["BufferSize"].as<size_t>();
+            if (watch["MaxSubscribers"]) alarm_config_.max_watchers = watch["MaxSubscribers"].as<size_t>();
+        }
+        
+        // Load correlation rules (optional, disabled otherwise)
+        const auto& correlation = alarms["Correlation"];
+        if (correlation) {
+            auto& settings = alarm_config_.correlation;
+            if (correlation["Enabled"]) settings.enabled = correlation["Enabled"].as<bool>();
+            if (correlation["WindowMs"]) settings.window_ms = correlation["WindowMs"].as<int>();
+            if (correlation["MaxIncidents"]) settings.max_incidents = correlation["MaxIncidents"].as<size_t>();
+            for (const auto& rule_node : correlation["Rules"]) {
+                CorrelationRule rule;
+                rule.name = rule_node["Name"].as<std::string>();
+                for (const auto& source : rule_node["Sources"]) {
+                    rule.sources.push_back(source.as<std::string>());
+                }
+                if (rule_node["GroupBy"]) rule.group_by = rule_node["GroupBy"].as<std::string>();
+                if (rule_node["Parent"]) rule.parent = rule_node["Parent"].as<std::string>();
+                settings.rules.push_back(rule);
+            }
+        }
         
         // Load severity actions
         const auto& severity_actions = alarms["SeverityActions"];
@@ -317,17 +412,40 @@ bool AlarmManager::load_alarm_configs() {
 /**
  * @brief Processes an alarm when it is raised
  * 
- * Executes configured actions, publishes the alarm to MQTT, and logs the event
- * according to the alarm's severity level.
+ * Runs the fast actions first, for every alarm: they only drive the fans,
+ * and an incident can stay open longer than the emergency speed is held.
+ * The alarm is then assigned to an incident. An alarm that joins an open
+ * incident without raising its severity queues no actions, as they already
+ * ran for the incident, and is only logged at debug level. Otherwise queues
+ * the configured actions on the action executor and logs the event
+ * according to the alarm's severity level. Every alarm is recorded in
+ * the runtime database, its statistics and the watch stream. Actions run
+ * asynchronously, so ingestion latency does not depend on how expensive they
+ * are.
  * 
- * @param alarm_name Name of the alarm to process
+ * @param alarm_source Source of the alarm
+ * @param severity Severity of the alarm
  * @param message Description of the alarm condition
+ * @param alarm_id Alarm id within the source, empty if unknown
  */
-void AlarmManager::process_alarm(const std::string& alarm_source, AlarmSeverity severity, const std::string& message) {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+void AlarmManager::process_alarm(const std::string& alarm_source, AlarmSeverity severity, const std::string& message,
+                                 const std::string& alarm_id) {
+    auto now = std::chrono::system_clock::now();
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
 
-    // Execute severity-based actions
-    execute_severity_actions(severity, alarm_source, message);
+    // Cooling reacts first, before any bookkeeping, and is never held back by correlation
+    execute_fast_actions(severity, alarm_source, message);
+
+    CorrelationResult incident;
+    if (alarm_correlator_) {
+        incident = alarm_correlator_->correlate(alarm_source, alarm_id, message, severity, now_ms);
+    }
+    bool significant = !alarm_correlator_ || incident.is_significant();
+
+    if (significant) {
+        // Queue severity-based actions
+        execute_severity_actions(severity, alarm_source, message);
+    }
 
     // Create alarm entry for runtime database
     AlarmEntry entry;
@@ -339,15 +457,26 @@ void AlarmManager::process_alarm(const std::string& alarm_source, AlarmSeverity
     entry.occurrence_count = 1;
     
     // Generate timestamp
-    std::string current_timestamp = common::utils::getCurrentTimestamp();
+    std::string current_timestamp = common::utils::formatTimestampMs(now);
     entry.first_timestamp = current_timestamp;
     entry.latest_timestamp = current_timestamp;
+    entry.first_time_ms = now_ms;
+    entry.latest_time_ms = entry.first_time_ms;
 
     // Add to runtime database
     add_alarm_entry(entry);
 
     // Log the alarm
+    if (!significant) {
+        logger_->debug("Alarm correlated into incident #" + std::to_string(incident.incident_id) + ": " +
+                       alarm_source + " - " + message);
+        return;
+    }
     std::string log_message = "Alarm Processed: " + alarm_source + " - " + message;
+    if (incident.incident_id != 0) {
+        log_message += (incident.new_incident ? " (opened incident #" : " (escalated incident #") +
+                       std::to_string(incident.incident_id) + ")";
+    }
     switch (severity) {
         case AlarmSeverity::INFO:
             logger_->info(log_message);
@@ -365,76 +494,116 @@ void AlarmManager::process_alarm(const std::string& alarm_source, AlarmSeverity
 }
 
 /**
- * @brief Executes actions for a specific severity level
+ * @brief Queues the actions configured for a severity level
+ * 
+ * The callbacks are resolved under the config mutex and handed to the action
+ * executor, which runs them on its worker pool with CRITICAL actions first.
  * 
  * @param severity Severity level
  * @param alarm_source Source of the alarm
  * @param message Alarm message
  */
 void AlarmManager::execute_severity_actions(AlarmSeverity severity, const std::string& alarm_source, const std::string& message) {
-    std::string severity_str = severity_to_string(severity);
-    auto it = alarm_config_.severity_actions.find(severity_str);
-    
-    if (it != alarm_config_.severity_actions.end()) {
+    if (!action_executor_) {
+        return;
+    }
+
+    std::vector<std::pair<std::string, ActionExecutor::Action>> actions;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        auto it = alarm_config_.severity_actions.find(severity_to_string(severity));
+        if (it == alarm_config_.severity_actions.end()) {
+            return;
+        }
         for (const auto& action_name : it->second) {
             auto action_it = action_callbacks_.find(action_name);
             if (action_it != action_callbacks_.end()) {
-                action_it->second(alarm_source, message);
-                logger_->info("Executed action: " + action_name + " for alarm: " + alarm_source);
+                actions.emplace_back(action_name, action_it->second);
             }
         }
     }
+
+    for (auto& action : actions) {
+        action_executor_->submit(action.first, std::move(action.second), severity, alarm_source, message);
+    }
 }
 
 /**
- * @brief Adds an alarm entry to the runtime database
+ * @brief Runs the fast actions configured for a severity level
  * 
- * If the same alarm already exists, updates the existing entry with the latest timestamp
- * and increments the occurrence count instead of creating a new entry.
+ * Fast actions bypass the action executor: they run on the calling thread in
+ * their configured order. Failures are logged after all of them have run.
  * 
- * @param entry Alarm entry to add
+ * @param severity Severity level
+ * @param alarm_source Source of the alarm
+ * @param message Alarm message
  */
-void AlarmManager::add_alarm_entry(const AlarmEntry& entry) {
-    std::lock_guard<std::mutex> lock(history_mutex_);
-    
-    // Check if this alarm already exists in the history
-    for (auto& existing_entry : alarm_history_) {
-        if (existing_entry.name == entry.name && existing_entry.severity == entry.severity) {
-            // Update existing alarm entry
-            existing_entry.latest_timestamp = entry.latest_timestamp;
-            existing_entry.is_active = entry.is_active;
-            existing_entry.occurrence_count++;
-            
-            // Update message if it's different
-            if (existing_entry.message != entry.message) {
-                existing_entry.message = entry.message;
-            }
-            
-            logger_->info("Updated existing alarm: " + entry.name + " (occurrence #" + 
-                         std::to_string(existing_entry.occurrence_count) + ")");
+void AlarmManager::execute_fast_actions(AlarmSeverity severity, const std::string& alarm_source, const std::string& message) {
+    std::vector<std::pair<const std::string*, std::function<void(const std::string&, const std::string&)>>> actions;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (fast_action_callbacks_.empty()) {
+            return;
+        }
+        auto it = alarm_config_.severity_actions.find(severity_to_string(severity));
+        if (it == alarm_config_.severity_actions.end()) {
             return;
         }
+        for (const auto& action_name : it->second) {
+            auto action_it = fast_action_callbacks_.find(action_name);
+            if (action_it != fast_action_callbacks_.end()) {
+                actions.emplace_back(&action_it->first, action_it->second);
+            }
+        }
     }
-    
-    // If alarm doesn't exist, add as new entry
-    alarm_history_.push_back(entry);
-    
-    // Maintain maximum history size
-    while (alarm_history_.size() > static_cast<size_t>(max_history_entries_)) {
-        alarm_history_.pop_front();
+
+    std::vector<std::string> errors;
+    for (auto& action : actions) {
+        try {
+            action.second(alarm_source, message);
+        } catch (const std::exception& e) {
+            errors.push_back(*action.first + ": " + e.what());
+        }
+    }
+    for (const auto& error : errors) {
+        logger_->error("Fast action for alarm " + alarm_source + " failed: " + error);
     }
-    
-    logger_->info("Added new alarm: " + entry.name);
 }
 
 /**
- * @brief Main thread function for the alarm manager
+ * @brief Adds an alarm entry to the runtime database
+ * 
+ * If the same alarm already exists, updates the existing entry with the latest timestamp
+ * and increments the occurrence count instead of creating a new entry. The lookup
+ * uses the store's (source, severity) hash index, so it does not scan the history.
+ * Watchers are notified while the history mutex is held, so they see events in
+ * the same order as the history.
  * 
- * Runs in a loop while the alarm manager is active, handling any background tasks.
+ * @param entry Alarm entry to add
  */
-void AlarmManager::main_thread_function() {
-    while (running_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+void AlarmManager::add_alarm_entry(const AlarmEntry& entry) {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+
+    bool inserted = false;
+    const AlarmEntry& stored = alarm_store_->add_or_update(entry, inserted);
+    if (alarm_journal_) {
+        alarm_journal_->append_upsert(entry);
+    }
+
+    AlarmEvent event;
+    event.type = inserted ? AlarmEvent::Type::RAISED : AlarmEvent::Type::UPDATED;
+    event.source = stored.name;
+    event.message = stored.message;
+    event.severity = stored.severity;
+    event.timestamp = stored.latest_timestamp;
+    event.occurrence_count = stored.occurrence_count;
+    alarm_broadcaster_->publish(std::move(event));
+
+    if (inserted) {
+        logger_->info("Added new alarm: " + entry.name);
+    } else {
+        logger_->info("Updated existing alarm: " + entry.name + " (occurrence #" + 
+                     std::to_string(stored.occurrence_count) + ")");
     }
 }
 
@@ -445,13 +614,7 @@ void AlarmManager::main_thread_function() {
  * @return String representation
  */
 std::string AlarmManager::severity_to_string(AlarmSeverity severity) {
-    switch (severity) {
-        case AlarmSeverity::INFO: return "INFO";
-        case AlarmSeverity::WARNING: return "WARNING";
-        case AlarmSeverity::ERROR: return "ERROR";
-        case AlarmSeverity::CRITICAL: return "CRITICAL";
-        default: return "UNKNOWN";
-    }
+    return common::alarmSeverityName(severity);
 }
 
 /**
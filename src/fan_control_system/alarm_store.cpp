@@ -0,0 +1,725 @@
+#include "fan_control_system/alarm_store.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include "common/utils.hpp"
+
+namespace fan_control_system {
+
+namespace {
+
+const uint32_t kImageVersion = 2;   ///< Version of the serialize() image layout
+const uint32_t kHasHourBuckets = 1; ///< Source flag: hour buckets follow the minute buckets
+
+void put_u32(std::string& out, uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_i64(std::string& out, int64_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& value) {
+    put_u32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+template <typename T>
+bool get_pod(const char*& data, const char* end, T& value) {
+    if (end - data < static_cast<ptrdiff_t>(sizeof(T))) {
+        return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+}
+
+bool get_string(const char*& data, const char* end, std::string& value) {
+    uint32_t length;
+    if (!get_pod(data, end, length) || end - data < static_cast<ptrdiff_t>(length)) {
+        return false;
+    }
+    value.assign(data, length);
+    data += length;
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Constructs an empty alarm store
+ *
+ * Allocates all slots up front so that entries never move.
+ *
+ * @param capacity Maximum number of entries kept
+ */
+AlarmStore::AlarmStore(size_t capacity)
+    : slots_(std::max<size_t>(capacity, 1)) {
+    free_slots_.reserve(slots_.size());
+    for (size_t i = slots_.size(); i > 0; --i) {
+        free_slots_.push_back(static_cast<int32_t>(i - 1));
+    }
+    index_.reserve(slots_.size());
+}
+
+/**
+ * @brief Inserts an entry or updates the existing one with the same source and severity
+ *
+ * An existing entry gets the latest timestamp, active state and message, and its
+ * occurrence count is incremented. A new entry is appended in insertion order,
+ * evicting the oldest entry if the store is full. Either way the occurrence is
+ * counted in the source's rolling statistics, which live as long as the
+ * source has entries.
+ *
+ * @param entry Entry to add
+ * @param inserted Set to true if a new entry was created
+ * @return Reference to the stored entry
+ */
+const AlarmEntry& AlarmStore::add_or_update(const AlarmEntry& entry, bool& inserted) {
+    uint32_t source_id;
+    auto it = lookup(entry.name, source_id) ? index_.find(make_key(source_id, entry.severity)) : index_.end();
+    if (it != index_.end()) {
+        stats_[source_id]->add(entry.latest_time_ms, static_cast<int>(entry.severity));
+        AlarmEntry& existing = slots_[it->second].entry;
+        existing.latest_timestamp = entry.latest_timestamp;
+        existing.latest_time_ms = entry.latest_time_ms;
+        existing.is_active = entry.is_active;
+        existing.occurrence_count++;
+        if (existing.message != entry.message) {
+            existing.message = entry.message;
+        }
+        inserted = false;
+        return existing;
+    }
+
+    inserted = true;
+    Slot& slot = insert_new(entry);
+    stats_[slot.source_id]->add(entry.latest_time_ms, static_cast<int>(entry.severity));
+    return slot.entry;
+}
+
+/**
+ * @brief Looks up the entry for a source and severity
+ *
+ * @param source Alarm source name
+ * @param severity Alarm severity
+ * @return Pointer to the entry, or nullptr if none exists
+ */
+const AlarmEntry* AlarmStore::find(const std::string& source, AlarmSeverity severity) const {
+    uint32_t source_id;
+    if (!lookup(source, source_id)) {
+        return nullptr;
+    }
+    auto it = index_.find(make_key(source_id, severity));
+    return it != index_.end() ? &slots_[it->second].entry : nullptr;
+}
+
+/**
+ * @brief Gets entries in insertion order (oldest first)
+ *
+ * With a source filter only that source's k entries are visited.
+ *
+ * @param source Optional source filter
+ * @param max_entries Maximum number of entries to return, <= 0 for all
+ * @return Copies of the matching entries
+ */
+std::vector<AlarmEntry> AlarmStore::get_entries(const std::string& source, int max_entries) const {
+    std::vector<AlarmEntry> result;
+    size_t limit = max_entries > 0 ? static_cast<size_t>(max_entries) : size_;
+
+    if (source.empty()) {
+        result.reserve(std::min(limit, size_));
+        for (int32_t i = oldest_; i != kNoSlot && result.size() < limit; i = slots_[i].next) {
+            result.push_back(slots_[i].entry);
+        }
+        return result;
+    }
+
+    uint32_t source_id;
+    if (!lookup(source, source_id)) {
+        return result;
+    }
+    auto it = by_source_.find(source_id);
+    if (it == by_source_.end()) {
+        return result;
+    }
+    // Slots are appended on insert, so the per-source list is already oldest first
+    for (int32_t slot_index : it->second) {
+        if (result.size() >= limit) {
+            break;
+        }
+        result.push_back(slots_[slot_index].entry);
+    }
+    return result;
+}
+
+/**
+ * @brief Removes entries
+ *
+ * The cleared sources' rolling statistics are released with their entries.
+ *
+ * @param source Source whose entries are removed, empty to remove all
+ * @return Number of entries removed
+ */
+int AlarmStore::clear(const std::string& source) {
+    if (source.empty()) {
+        int cleared = static_cast<int>(size_);
+        while (oldest_ != kNoSlot) {
+            release(oldest_);
+        }
+        return cleared;
+    }
+
+    uint32_t source_id;
+    if (!lookup(source, source_id)) {
+        return 0;
+    }
+    auto it = by_source_.find(source_id);
+    if (it == by_source_.end()) {
+        return 0;
+    }
+    std::vector<int32_t> to_release = it->second;
+    for (int32_t slot_index : to_release) {
+        release(slot_index);
+    }
+    return static_cast<int>(to_release.size());
+}
+
+/**
+ * @brief Gets rolling statistics per source
+ *
+ * @param source Optional source filter, empty for all sources
+ * @param window_hours Time window in hours, clamped to 1..168
+ * @param now_ms Current time in milliseconds since the epoch
+ * @return Statistics for every source with occurrences inside the window
+ */
+std::vector<AlarmStatistics> AlarmStore::get_statistics(const std::string& source, int window_hours,
+                                                        int64_t now_ms) const {
+    StatisticsSnapshot snapshot;
+    snapshot_statistics(source, window_hours, now_ms, snapshot);
+    return summarize_statistics(snapshot);
+}
+
+/**
+ * @brief Copies the counters a statistics query needs, without aggregating them
+ *
+ * A one-hour window copies the 60 minute buckets, a longer one the hour
+ * buckets of the window only (at most 168); a source without hour buckets
+ * copies its minute buckets for any window. Sources whose last occurrence
+ * is older than the window are skipped. Active and acknowledged counts come
+ * from the source's current entries.
+ *
+ * @param source Optional source filter, empty for all sources
+ * @param window_hours Time window in hours, clamped to 1..168
+ * @param now_ms Current time in milliseconds since the epoch
+ * @param snapshot Receives the counters
+ */
+void AlarmStore::snapshot_statistics(const std::string& source, int window_hours, int64_t now_ms,
+                                     StatisticsSnapshot& snapshot) const {
+    window_hours = std::max(window_hours, 1);
+    if (window_hours > kHourBuckets) {
+        window_hours = kHourBuckets;
+    }
+    snapshot.window_hours = window_hours;
+    snapshot.now_ms = now_ms;
+    snapshot.sources.clear();
+    snapshot.buckets.clear();
+
+    uint32_t first_id = 0;
+    uint32_t end_id = static_cast<uint32_t>(stats_.size());
+    if (!source.empty()) {
+        if (!lookup(source, first_id)) {
+            return;
+        }
+        end_id = first_id + 1;
+    }
+
+    const int64_t now_hour = now_ms / 3600000;
+    const int64_t window_start_ms = window_hours <= 1 ? (now_ms / 60000 - kMinuteBuckets + 1) * 60000
+                                                     : (now_hour - window_hours + 1) * 3600000;
+    for (uint32_t source_id = first_id; source_id < end_id; ++source_id) {
+        if (!stats_[source_id] || stats_[source_id]->last_ms < window_start_ms) {
+            continue;
+        }
+        const SourceStats& stats = *stats_[source_id];
+
+        SourceSnapshot entry;
+        entry.name = source_names_[source_id];
+        entry.first_ms = stats.first_ms;
+        entry.last_ms = stats.last_ms;
+        entry.hourly = window_hours > 1 && stats.hours;
+        entry.first_bucket = snapshot.buckets.size();
+        if (entry.hourly) {
+            for (int64_t hour = now_hour; hour > now_hour - window_hours && hour >= 0; --hour) {
+                snapshot.buckets.push_back((*stats.hours)[hour % kHourBuckets]);
+            }
+        } else {
+            snapshot.buckets.insert(snapshot.buckets.end(), std::begin(stats.minutes), std::end(stats.minutes));
+        }
+        entry.bucket_count = snapshot.buckets.size() - entry.first_bucket;
+
+        auto slots = by_source_.find(source_id);
+        if (slots != by_source_.end()) {
+            for (int32_t slot_index : slots->second) {
+                const AlarmEntry& alarm = slots_[slot_index].entry;
+                if (alarm.is_active) entry.active_count++;
+                if (alarm.acknowledged) entry.acknowledged_count++;
+            }
+        }
+        snapshot.sources.push_back(std::move(entry));
+    }
+}
+
+/**
+ * @brief Aggregates a snapshot into statistics; needs no access to the store
+ *
+ * Minute buckets count within a one-hour window when less than 60 minutes
+ * old, and within longer windows by the hour they fall in. Timestamps are
+ * only formatted here, on output.
+ *
+ * @param snapshot Counters from snapshot_statistics()
+ * @return Statistics for every source with occurrences inside the window, sorted by name
+ */
+std::vector<AlarmStatistics> AlarmStore::summarize_statistics(const StatisticsSnapshot& snapshot) {
+    static const char* const kSeverityNames[kSeverityCount] = {"INFO", "WARNING", "ERROR", "CRITICAL"};
+
+    const int window_hours = snapshot.window_hours;
+    const int64_t now_minute = snapshot.now_ms / 60000;
+    const int64_t now_hour = snapshot.now_ms / 3600000;
+    std::vector<AlarmStatistics> result;
+    result.reserve(snapshot.sources.size());
+    for (const SourceSnapshot& source : snapshot.sources) {
+        uint32_t totals[kSeverityCount] = {0, 0, 0, 0};
+        for (size_t i = source.first_bucket; i < source.first_bucket + source.bucket_count; ++i) {
+            const Bucket& bucket = snapshot.buckets[i];
+            int64_t age = source.hourly ? now_hour - bucket.period
+                        : window_hours <= 1 ? now_minute - bucket.period
+                        : now_hour - bucket.period / 60;
+            if (bucket.period >= 0 && age >= 0 && age < (window_hours <= 1 ? kMinuteBuckets : window_hours)) {
+                for (int s = 0; s < kSeverityCount; ++s) {
+                    totals[s] += bucket.counts[s];
+                }
+            }
+        }
+
+        AlarmStatistics entry;
+        entry.alarm_name = source.name;
+        entry.total_count = 0;
+        entry.active_count = source.active_count;
+        entry.acknowledged_count = source.acknowledged_count;
+        entry.total_occurrences = 0;
+        for (int severity = 0; severity < kSeverityCount; ++severity) {
+            if (totals[severity] > 0) {
+                entry.severity_counts[kSeverityNames[severity]] = static_cast<int32_t>(totals[severity]);
+                entry.total_occurrences += static_cast<int32_t>(totals[severity]);
+                entry.total_count++;
+            }
+        }
+        if (entry.total_occurrences == 0) {
+            continue;
+        }
+
+        entry.first_occurrence = common::utils::formatTimestampMs(
+            std::chrono::system_clock::time_point(std::chrono::milliseconds(source.first_ms)));
+        entry.last_occurrence = common::utils::formatTimestampMs(
+            std::chrono::system_clock::time_point(std::chrono::milliseconds(source.last_ms)));
+        result.push_back(std::move(entry));
+    }
+
+    std::sort(result.begin(), result.end(), [](const AlarmStatistics& a, const AlarmStatistics& b) {
+        return a.alarm_name < b.alarm_name;
+    });
+    return result;
+}
+
+/**
+ * @brief Appends a compact binary image of all entries and rolling statistics
+ *
+ * Layout (host byte order): version, source count, then per source its name,
+ * first/last occurrence, flags and raw minute buckets, followed by the raw
+ * hour buckets if the source has them, then entry count and the entries
+ * oldest first.
+ *
+ * @param out Buffer the image is appended to
+ */
+void AlarmStore::serialize(std::string& out) const {
+    out.reserve(out.size() + by_source_.size() * (sizeof(SourceStats) + sizeof(HourBuckets) + 32) + size_ * 128);
+    put_u32(out, kImageVersion);
+    put_u32(out, static_cast<uint32_t>(by_source_.size()));
+    for (size_t id = 0; id < stats_.size(); ++id) {
+        if (!stats_[id]) {
+            continue;
+        }
+        const SourceStats& stats = *stats_[id];
+        put_string(out, source_names_[id]);
+        put_i64(out, stats.first_ms);
+        put_i64(out, stats.last_ms);
+        put_u32(out, stats.hours ? kHasHourBuckets : 0u);
+        out.append(reinterpret_cast<const char*>(stats.minutes), sizeof(stats.minutes));
+        if (stats.hours) {
+            out.append(reinterpret_cast<const char*>(stats.hours->data()), sizeof(HourBuckets));
+        }
+    }
+
+    put_u32(out, static_cast<uint32_t>(size_));
+    for (int32_t i = oldest_; i != kNoSlot; i = slots_[i].next) {
+        encode_entry(slots_[i].entry, out);
+    }
+}
+
+/**
+ * @brief Replaces the store contents with a binary image produced by serialize()
+ *
+ * The image is decoded into a fresh store which replaces this one only if the
+ * whole image is valid. Version 1 images, which always carried hour buckets
+ * in a split layout, are still accepted. Sources left without entries are
+ * released after loading.
+ *
+ * @param data Image to load
+ * @return true on success
+ */
+bool AlarmStore::deserialize(const std::string& data) {
+    const char* pos = data.data();
+    const char* end = pos + data.size();
+    AlarmStore loaded(capacity());
+
+    uint32_t version, source_count;
+    if (!get_pod(pos, end, version) || (version != 1 && version != kImageVersion) ||
+        !get_pod(pos, end, source_count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < source_count; ++i) {
+        std::string name;
+        if (!get_string(pos, end, name)) {
+            return false;
+        }
+        SourceStats& stats = *loaded.stats_[loaded.intern(name)];
+        if (!get_pod(pos, end, stats.first_ms) || !get_pod(pos, end, stats.last_ms)) {
+            return false;
+        }
+        if (version == 1) {
+            int64_t minute_id[kMinuteBuckets];
+            uint32_t minute_counts[kMinuteBuckets][kSeverityCount];
+            int64_t hour_id[kHourBuckets];
+            uint32_t hour_counts[kHourBuckets][kSeverityCount];
+            if (!get_pod(pos, end, minute_id) || !get_pod(pos, end, minute_counts) ||
+                !get_pod(pos, end, hour_id) || !get_pod(pos, end, hour_counts)) {
+                return false;
+            }
+            stats.hours = std::make_unique<HourBuckets>();
+            for (int m = 0; m < kMinuteBuckets; ++m) {
+                stats.minutes[m].period = minute_id[m];
+                std::memcpy(stats.minutes[m].counts, minute_counts[m], sizeof(minute_counts[m]));
+            }
+            for (int h = 0; h < kHourBuckets; ++h) {
+                (*stats.hours)[h].period = hour_id[h];
+                std::memcpy((*stats.hours)[h].counts, hour_counts[h], sizeof(hour_counts[h]));
+            }
+            continue;
+        }
+        uint32_t flags;
+        if (!get_pod(pos, end, flags) || !get_pod(pos, end, stats.minutes)) {
+            return false;
+        }
+        if (flags & kHasHourBuckets) {
+            stats.hours = std::make_unique<HourBuckets>();
+            if (!get_pod(pos, end, *stats.hours)) {
+                return false;
+            }
+        }
+    }
+
+    uint32_t entry_count;
+    if (!get_pod(pos, end, entry_count)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < entry_count; ++i) {
+        AlarmEntry entry;
+        if (!decode_entry(pos, end, entry)) {
+            return false;
+        }
+        uint32_t source_id;
+        auto it = loaded.lookup(entry.name, source_id) ? loaded.index_.find(make_key(source_id, entry.severity))
+                                                       : loaded.index_.end();
+        if (it != loaded.index_.end()) {
+            loaded.slots_[it->second].entry = entry;
+        } else {
+            loaded.insert_new(entry);
+        }
+    }
+    for (uint32_t source_id = 0; source_id < loaded.stats_.size(); ++source_id) {
+        if (loaded.stats_[source_id] && loaded.by_source_.find(source_id) == loaded.by_source_.end()) {
+            loaded.forget(source_id);
+        }
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+/**
+ * @brief Appends the binary encoding of one entry
+ *
+ * @param entry Entry to encode
+ * @param out Buffer the encoding is appended to
+ */
+void AlarmStore::encode_entry(const AlarmEntry& entry, std::string& out) {
+    put_string(out, entry.name);
+    put_string(out, entry.message);
+    put_u32(out, static_cast<uint32_t>(entry.severity));
+    put_string(out, entry.first_timestamp);
+    put_string(out, entry.latest_timestamp);
+    put_i64(out, entry.first_time_ms);
+    put_i64(out, entry.latest_time_ms);
+    put_u32(out, (entry.is_active ? 1u : 0u) | (entry.acknowledged ? 2u : 0u));
+    put_u32(out, static_cast<uint32_t>(entry.occurrence_count));
+    put_u32(out, static_cast<uint32_t>(entry.actions_taken.size()));
+    for (const auto& action : entry.actions_taken) {
+        put_string(out, action);
+    }
+}
+
+/**
+ * @brief Decodes one entry and advances the read position
+ *
+ * @param data Read position
+ * @param end End of the readable data
+ * @param entry Decoded entry
+ * @return true on success, false if the data is truncated or malformed
+ */
+bool AlarmStore::decode_entry(const char*& data, const char* end, AlarmEntry& entry) {
+    uint32_t severity, flags, occurrences, action_count;
+    if (!get_string(data, end, entry.name) || !get_string(data, end, entry.message) ||
+        !get_pod(data, end, severity) || severity >= static_cast<uint32_t>(kSeverityCount) ||
+        !get_string(data, end, entry.first_timestamp) || !get_string(data, end, entry.latest_timestamp) ||
+        !get_pod(data, end, entry.first_time_ms) || !get_pod(data, end, entry.latest_time_ms) ||
+        !get_pod(data, end, flags) || !get_pod(data, end, occurrences) || !get_pod(data, end, action_count)) {
+        return false;
+    }
+    entry.severity = static_cast<AlarmSeverity>(severity);
+    entry.is_active = (flags & 1u) != 0;
+    entry.acknowledged = (flags & 2u) != 0;
+    entry.occurrence_count = static_cast<int>(occurrences);
+    entry.actions_taken.clear();
+    for (uint32_t i = 0; i < action_count; ++i) {
+        std::string action;
+        if (!get_string(data, end, action)) {
+            return false;
+        }
+        entry.actions_taken.push_back(std::move(action));
+    }
+    return true;
+}
+
+/**
+ * @brief Calls a function for every entry in insertion order
+ *
+ * @param visitor Function receiving each entry
+ */
+void AlarmStore::for_each(const std::function<void(const AlarmEntry&)>& visitor) const {
+    for (int32_t i = oldest_; i != kNoSlot; i = slots_[i].next) {
+        visitor(slots_[i].entry);
+    }
+}
+
+/**
+ * @brief Appends a new entry in insertion order, evicting the oldest if full
+ *
+ * The source is interned only after the eviction, which may release it.
+ *
+ * @param entry Entry to copy into the slot
+ * @return Slot holding the entry
+ */
+AlarmStore::Slot& AlarmStore::insert_new(const AlarmEntry& entry) {
+    if (free_slots_.empty()) {
+        release(oldest_);
+    }
+    uint32_t source_id = intern(entry.name);
+    int32_t slot_index = free_slots_.back();
+    free_slots_.pop_back();
+
+    Slot& slot = slots_[slot_index];
+    slot.entry = entry;
+    slot.source_id = source_id;
+    slot.used = true;
+    slot.prev = newest_;
+    slot.next = kNoSlot;
+    if (newest_ != kNoSlot) {
+        slots_[newest_].next = slot_index;
+    } else {
+        oldest_ = slot_index;
+    }
+    newest_ = slot_index;
+    ++size_;
+
+    index_[make_key(source_id, entry.severity)] = slot_index;
+    by_source_[source_id].push_back(slot_index);
+
+    return slot;
+}
+
+/**
+ * @brief Returns the id of a source, interning it if it is new
+ *
+ * Ids released by forget() are reused before new ones are issued.
+ *
+ * @param source Alarm source name
+ * @return Interned source id
+ */
+uint32_t AlarmStore::intern(const std::string& source) {
+    auto it = source_ids_.find(source);
+    if (it != source_ids_.end()) {
+        return it->second;
+    }
+    uint32_t source_id;
+    if (!free_source_ids_.empty()) {
+        source_id = free_source_ids_.back();
+        free_source_ids_.pop_back();
+        source_names_[source_id] = source;
+        stats_[source_id].reset(new SourceStats());
+    } else {
+        source_id = static_cast<uint32_t>(source_names_.size());
+        source_names_.push_back(source);
+        stats_.emplace_back(new SourceStats());
+    }
+    source_ids_.emplace(source, source_id);
+    return source_id;
+}
+
+/**
+ * @brief Releases the statistics and id of a source without entries
+ *
+ * @param source_id Interned source id
+ */
+void AlarmStore::forget(uint32_t source_id) {
+    source_ids_.erase(source_names_[source_id]);
+    source_names_[source_id].clear();
+    source_names_[source_id].shrink_to_fit();
+    stats_[source_id].reset();
+    free_source_ids_.push_back(source_id);
+}
+
+/**
+ * @brief Looks up the id of a source without interning it
+ *
+ * @param source Alarm source name
+ * @param source_id Receives the id if found
+ * @return true if the source is known
+ */
+bool AlarmStore::lookup(const std::string& source, uint32_t& source_id) const {
+    auto it = source_ids_.find(source);
+    if (it == source_ids_.end()) {
+        return false;
+    }
+    source_id = it->second;
+    return true;
+}
+
+/**
+ * @brief Unlinks a slot from all indexes and returns it to the free list
+ *
+ * Releasing the last entry of a source releases the source as well.
+ *
+ * @param slot_index Index of the slot to release
+ */
+void AlarmStore::release(int32_t slot_index) {
+    Slot& slot = slots_[slot_index];
+
+    if (slot.prev != kNoSlot) {
+        slots_[slot.prev].next = slot.next;
+    } else {
+        oldest_ = slot.next;
+    }
+    if (slot.next != kNoSlot) {
+        slots_[slot.next].prev = slot.prev;
+    } else {
+        newest_ = slot.prev;
+    }
+
+    index_.erase(make_key(slot.source_id, slot.entry.severity));
+    auto it = by_source_.find(slot.source_id);
+    if (it != by_source_.end()) {
+        auto& slots = it->second;
+        slots.erase(std::remove(slots.begin(), slots.end(), slot_index), slots.end());
+        if (slots.empty()) {
+            by_source_.erase(it);
+            forget(slot.source_id);
+        }
+    }
+
+    slot.entry = AlarmEntry();
+    slot.used = false;
+    slot.prev = kNoSlot;
+    slot.next = kNoSlot;
+    free_slots_.push_back(slot_index);
+    --size_;
+}
+
+/**
+ * @brief Counts occurrences in the bucket of their period
+ *
+ * A bucket still holding an older period is reset before it is reused; one
+ * already holding a newer period means the occurrences are older than the
+ * window the ring covers, so they are not counted at that resolution.
+ *
+ * @param ring Bucket ring
+ * @param size Number of buckets in the ring
+ * @param period Minute or hour of the occurrences
+ * @param counts Occurrences per severity to add
+ */
+void AlarmStore::count(Bucket* ring, int size, int64_t period, const uint32_t (&counts)[kSeverityCount]) {
+    Bucket& bucket = ring[period % size];
+    if (period < bucket.period) {
+        return;
+    }
+    if (bucket.period != period) {
+        bucket = Bucket();
+        bucket.period = period;
+    }
+    for (int s = 0; s < kSeverityCount; ++s) {
+        bucket.counts[s] += counts[s];
+    }
+}
+
+/**
+ * @brief Counts one occurrence in its minute and hour buckets
+ *
+ * The hour buckets are allocated when an occurrence arrives 59 minutes or
+ * more after the first one, while the minute buckets still hold every
+ * earlier occurrence; they are seeded from the minute buckets.
+ *
+ * @param time_ms Occurrence time in milliseconds since the epoch
+ * @param severity Severity index
+ */
+void AlarmStore::SourceStats::add(int64_t time_ms, int severity) {
+    if (severity < 0 || severity >= kSeverityCount || time_ms < 0) {
+        return;
+    }
+
+    int64_t minute = time_ms / 60000;
+    if (!hours && first_ms != 0 && minute - first_ms / 60000 >= kMinuteBuckets - 1) {
+        hours = std::make_unique<HourBuckets>();
+        for (const Bucket& bucket : minutes) {
+            if (bucket.period >= 0) {
+                count(hours->data(), kHourBuckets, bucket.period / 60, bucket.counts);
+            }
+        }
+    }
+
+    uint32_t one[kSeverityCount] = {0, 0, 0, 0};
+    one[severity] = 1;
+    count(minutes, kMinuteBuckets, minute, one);
+    if (hours) {
+        count(hours->data(), kHourBuckets, time_ms / 3600000, one);
+    }
+
+    if (first_ms == 0 || time_ms < first_ms) {
+        first_ms = time_ms;
+    }
+    if (time_ms > last_ms) {
+        last_ms = time_ms;
+    }
+}
+
+} // namespace fan_control_system
@@ -0,0 +1,154 @@
+#include "fan_control_system/duty_allocator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fan_control_system {
+
+/**
+ * @brief Gets the name of an allocation mode for config, logs and RPC
+ *
+ * @param mode Allocation mode
+ * @return "Equal" or "NoiseOptimized"
+ */
+const char* fanAllocationModeName(FanAllocationMode mode) {
+    return mode == FanAllocationMode::NOISE_OPTIMIZED ? "NoiseOptimized" : "Equal";
+}
+
+/**
+ * @brief Parses an allocation mode name as returned by fanAllocationModeName()
+ *
+ * @param name Mode name
+ * @param mode Parsed mode
+ * @return true if the name is known, false otherwise
+ */
+bool parseFanAllocationMode(const std::string& name, FanAllocationMode& mode) {
+    for (FanAllocationMode candidate : {FanAllocationMode::EQUAL, FanAllocationMode::NOISE_OPTIMIZED}) {
+        if (name == fanAllocationModeName(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Sums noise levels in the power domain
+ *
+ * @param levels_db Noise levels in dB
+ * @return 10 log10 of the summed powers, 0 if there are no levels
+ */
+double sumNoiseDb(const std::vector<int>& levels_db) {
+    double power = 0.0;
+    for (int level : levels_db) {
+        power += std::pow(10.0, level / 10.0);
+    }
+    return power > 0.0 ? 10.0 * std::log10(power) : 0.0;
+}
+
+/**
+ * @brief Solves the allocation for every effort
+ *
+ * Weights are reduced by their common divisor and, if the largest is still
+ * above kMaxWeight, scaled down to it, which keeps the programme small.
+ * One dynamic programme covers all efforts: cost[k][t] is the lowest noise
+ * power of the first k fans with weighted duty cycles summing to exactly t,
+ * each fan within its bounds. The plan for an effort takes the cheapest
+ * total at or above sum(weight) x effort, preferring the smallest such total
+ * and, per fan, the lowest duty cycle among equal costs. Runs once at
+ * startup; for n fans of weight w it takes about n x 100nw x 100 steps.
+ *
+ * @param fans Noise table and duty cycle range per fan
+ * @param min_duty_cycle Lowest duty cycle any fan is given when not all are equal
+ */
+DutyAllocator::DutyAllocator(const std::vector<FanNoiseTable>& fans, int min_duty_cycle)
+    : plans_(101) {
+    const size_t count = fans.size();
+    const double unreachable = std::numeric_limits<double>::infinity();
+
+    std::vector<int> weight(count);
+    int divisor = 0;
+    int largest = 1;
+    for (size_t fan = 0; fan < count; ++fan) {
+        weight[fan] = std::max(fans[fan].weight, 1);
+        divisor = gcd(divisor, weight[fan]);
+    }
+    for (size_t fan = 0; fan < count; ++fan) {
+        weight[fan] /= divisor;
+        largest = std::max(largest, weight[fan]);
+    }
+    int weight_sum = 0;
+    for (size_t fan = 0; fan < count; ++fan) {
+        if (largest > kMaxWeight) {
+            weight[fan] = std::max(1, static_cast<int>(std::lround(double(weight[fan]) * kMaxWeight / largest)));
+        }
+        weight_sum += weight[fan];
+    }
+    const int max_total = weight_sum * 100;
+
+    std::vector<int> low(count);
+    std::vector<int> high(count);
+    std::vector<std::array<double, 101>> power(count);
+    int equal_below = clamp(min_duty_cycle);
+    for (size_t fan = 0; fan < count; ++fan) {
+        low[fan] = std::max(clamp(min_duty_cycle), clamp(fans[fan].min_duty_cycle));
+        high[fan] = std::max(low[fan], clamp(fans[fan].max_duty_cycle));
+        equal_below = std::max(equal_below, low[fan]);
+        for (int duty = 0; duty <= 100; ++duty) {
+            power[fan][duty] = std::pow(10.0, fans[fan].noise_db[duty] / 10.0);
+        }
+    }
+
+    std::vector<std::vector<double>> cost(count + 1, std::vector<double>(max_total + 1, unreachable));
+    std::vector<std::vector<uint8_t>> choice(count, std::vector<uint8_t>(max_total + 1, 0));
+    cost[0][0] = 0.0;
+    int reached = 0;
+    for (size_t fan = 0; fan < count; ++fan) {
+        for (int total = 0; total <= reached; ++total) {
+            if (cost[fan][total] == unreachable) {
+                continue;
+            }
+            for (int duty = low[fan]; duty <= high[fan]; ++duty) {
+                int next = total + weight[fan] * duty;
+                double candidate = cost[fan][total] + power[fan][duty];
+                if (candidate < cost[fan + 1][next]) {
+                    cost[fan + 1][next] = candidate;
+                    choice[fan][next] = static_cast<uint8_t>(duty);
+                }
+            }
+        }
+        reached += weight[fan] * 100;
+    }
+
+    std::vector<int> levels(count);
+    for (int effort = 0; effort <= 100; ++effort) {
+        std::vector<uint8_t>& plan = plans_[effort];
+        plan.assign(count, static_cast<uint8_t>(effort));
+        for (size_t fan = 0; fan < count; ++fan) {
+            levels[fan] = fans[fan].noise_db[effort];
+        }
+        equal_noise_db_[effort] = sumNoiseDb(levels);
+        plan_noise_db_[effort] = equal_noise_db_[effort];
+        if (effort <= equal_below) {
+            continue;
+        }
+
+        int best_total = -1;
+        for (int total = weight_sum * effort; total <= max_total; ++total) {
+            if (cost[count][total] < unreachable && (best_total < 0 || cost[count][total] < cost[count][best_total])) {
+                best_total = total;
+            }
+        }
+        if (best_total < 0) {
+            continue;
+        }
+        for (size_t fan = count; fan-- > 0;) {
+            plan[fan] = choice[fan][best_total];
+            best_total -= weight[fan] * plan[fan];
+            levels[fan] = fans[fan].noise_db[plan[fan]];
+        }
+        plan_noise_db_[effort] = sumNoiseDb(levels);
+    }
+}
+
+} // namespace fan_control_system
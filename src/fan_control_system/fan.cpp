@@ -1,7 +1,8 @@
 #include "fan_control_system/fan.hpp"
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <chrono>
-#include <thread>
 #include <nlohmann/json.hpp>
 #include "common/utils.hpp"
 
@@ -9,6 +10,16 @@ using json = nlohmann::json;
 
 namespace fan_control_system {
 
+/**
+ * @brief Gets the status name of a fan health as published and returned over RPC
+ * 
+ * @param health Fan health
+ * @return "Good" or "Bad"
+ */
+const char* fanHealthName(FanHealth health) {
+    return health == FanHealth::BAD ? "Bad" : "Good";
+}
+
 /**
  * @brief Constructs a new Fan instance
  * 
@@ -34,10 +45,9 @@ Fan::Fan(const std::string& name, const std::string& model_name, uint8_t i2c_add
     , model_name_(model_name)
     , i2c_address_(i2c_address)
     , pwm_reg_(pwm_reg)
-    , status_("Good")
-    , current_pwm_count_(0)
-    , current_duty_cycle_(0)
+    , state_(packState(FanState()))
     , running_(false)
+    , monitor_timer_(0)
     , last_update_time_(std::chrono::system_clock::now())
     , mqtt_settings_(mqtt_settings)
     , log_level_(log_level)
@@ -45,10 +55,70 @@ Fan::Fan(const std::string& name, const std::string& model_name, uint8_t i2c_add
     , pwm_max_(pwm_max)
     , duty_cycle_min_(duty_cycle_min)
     , duty_cycle_max_(duty_cycle_max)
-    , noise_level_(0)
     , noise_profile_(noise_profile)
     , interface_("I2C")
 {
+    buildLookupTables();
+}
+
+/**
+ * @brief Packs a state snapshot into the 64-bit word stored in state_
+ * 
+ * Bits 0-31 hold the PWM count, 32-39 the duty cycle, 40-47 the noise level
+ * and 48-55 the health.
+ * 
+ * @param state State to pack
+ * @return Packed state
+ */
+uint64_t Fan::packState(const FanState& state) {
+    return static_cast<uint64_t>(state.pwm_count) |
+           static_cast<uint64_t>(state.duty_cycle) << 32 |
+           static_cast<uint64_t>(state.noise_level) << 40 |
+           static_cast<uint64_t>(state.health) << 48;
+}
+
+/**
+ * @brief Unpacks the 64-bit word stored in state_
+ * 
+ * @param packed Packed state
+ * @return State snapshot
+ */
+FanState Fan::unpackState(uint64_t packed) {
+    FanState state;
+    state.pwm_count = static_cast<uint32_t>(packed);
+    state.duty_cycle = static_cast<uint8_t>(packed >> 32);
+    state.noise_level = static_cast<uint8_t>(packed >> 40);
+    state.health = static_cast<FanHealth>(static_cast<uint8_t>(packed >> 48));
+    return state;
+}
+
+/**
+ * @brief Precomputes the duty cycle, PWM and noise conversion tables
+ * 
+ * Duty cycles are clamped to the model's duty cycle range and mapped linearly
+ * onto its PWM range, and PWM counts the other way round. The noise level of
+ * a duty cycle is that of the first noise profile point at or above it. With
+ * the tables in place, speed changes need no model lookup, interpolation or
+ * profile walk.
+ */
+void Fan::buildLookupTables() {
+    int duty_span = duty_cycle_max_ - duty_cycle_min_;
+    int pwm_span = pwm_max_ - pwm_min_;
+    for (int duty_cycle = 0; duty_cycle <= 100; ++duty_cycle) {
+        int clamped = std::max(duty_cycle_min_, std::min(duty_cycle, duty_cycle_max_));
+        double ratio = duty_span > 0 ? static_cast<double>(clamped - duty_cycle_min_) / duty_span : 0.0;
+        pwm_by_duty_[duty_cycle] = pwm_min_ + static_cast<int>(ratio * pwm_span);
+
+        auto profile = noise_profile_.lower_bound(duty_cycle);
+        noise_by_duty_[duty_cycle] = profile != noise_profile_.end() ? profile->second : 0;
+    }
+
+    duty_by_pwm_.assign(std::max(pwm_span, 0) + 1, 0);
+    for (int offset = 0; offset <= pwm_span; ++offset) {
+        double ratio = pwm_span > 0 ? static_cast<double>(offset) / pwm_span : 0.0;
+        int duty_cycle = duty_cycle_min_ + static_cast<int>(ratio * duty_span);
+        duty_by_pwm_[offset] = static_cast<uint8_t>(std::max(0, std::min(duty_cycle, 100)));
+    }
 }
 
 /**
@@ -77,7 +147,7 @@ bool Fan::initialize() {
     }
 
     // Initialize logger and alarm
-    logger_ = std::make_unique<common::Logger>(name_, log_level_, mqtt_client_);
+    logger_ = std::make_unique<common::Logger>(name_, log_level_, mqtt_client_, "FanSimulator");
     alarm_ = std::make_unique<common::Alarm>(name_, mqtt_client_);
 
     // Publish initial configuration
@@ -86,7 +156,7 @@ bool Fan::initialize() {
         {"model", model_name_},
         {"i2c_address", i2c_address_},
         {"pwm_reg", pwm_reg_},
-        {"status", status_},
+        {"status", getStatus()},
         {"timestamp", common::utils::formatTimestamp(std::chrono::system_clock::now())}
     };
     mqtt_client_->publish("fan/" + name_ + "/config", config_data.dump());
@@ -98,9 +168,13 @@ bool Fan::initialize() {
 /**
  * @brief Starts the fan monitoring
  * 
- * Starts a background thread to monitor fan status and publish updates.
- * The thread reads the current PWM count from the I2C register and publishes
- * status changes to MQTT.
+ * Schedules a 1 s timer on the shared timer wheel that reads the current PWM
+ * count from the I2C register and publishes status changes to MQTT. A changed
+ * count updates the duty cycle and noise level with it. The compare and the
+ * store happen in one state update, so the three values always belong to
+ * the same PWM count. The update is dropped if a write was recorded while the
+ * register was being read, and the timer does nothing without a register bank
+ * since the fan's own state is the only copy of the count.
  */
 void Fan::start() {
     if (running_) {
@@ -110,100 +184,209 @@ void Fan::start() {
     running_ = true;
     logger_->info("Fan started");
 
-    // Start status monitoring thread
-    std::thread([this]() {
-        logger_->debug("Fan monitoring thread started");
-        while (running_) {
-            // Read current duty cycle from I2C register
-            int pwm_count = readPwmCount();
-            if (pwm_count != current_pwm_count_) {
-                logger_->debug("Duty cycle changed from " + std::to_string(current_pwm_count_) + 
-                             "% to " + std::to_string(pwm_count) + "%");
-                current_pwm_count_ = pwm_count;
-                publishStatus();
+    // Status monitoring timer
+    monitor_timer_ = common::TimerWheel::getInstance().schedulePeriodic(std::chrono::seconds(1), [this]() {
+        // Without a register bank there is nothing besides our own state to compare against
+        if (!register_bank_) {
+            return;
+        }
+        // Read current duty cycle from I2C register
+        uint32_t seen_before = getState().pwm_count;
+        uint32_t pwm_count = readPwmCount();
+        int duty_cycle = pwmToDutyCycle(static_cast<int>(std::min<uint32_t>(pwm_count, INT_MAX)));
+        uint8_t noise_level = static_cast<uint8_t>(std::max(0, std::min(noiseLevelAt(duty_cycle), 255)));
+        uint32_t previous = 0;
+        bool changed = false;
+        updateState([&](FanState& state) {
+            previous = state.pwm_count;
+            // A write recorded since the read is newer than what was read; leave it alone
+            changed = state.pwm_count == seen_before && state.pwm_count != pwm_count;
+            if (changed) {
+                state.pwm_count = pwm_count;
+                state.duty_cycle = static_cast<uint8_t>(duty_cycle);
+                state.noise_level = noise_level;
             }
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+        });
+        if (changed) {
+            logger_->debug("PWM count changed from " + std::to_string(previous) + " to " +
+                           std::to_string(pwm_count) + " (" + std::to_string(duty_cycle) + "%)");
+            publishStatus();
         }
-        logger_->debug("Fan monitoring thread stopped");
-    }).detach();
+    });
 }
 
 /**
  * @brief Stops the fan monitoring
  * 
- * Stops the background monitoring thread and cleans up resources.
+ * Cancels the monitoring timer; a status check in progress finishes before
+ * this returns.
  */
 void Fan::stop() {
     if (!running_) {
         return;
     }
     running_ = false;
+    common::TimerWheel::getInstance().cancel(monitor_timer_);
+    monitor_timer_ = 0;
     logger_->info("Fan stopped");
 }
 
 /**
- * @brief Sets the fan speed using PWM count
+ * @brief Routes the fan's register accesses through a register bank
  * 
- * Sets the fan speed by writing the specified PWM count to the I2C register.
- * Also updates the duty cycle percentage and publishes the new status.
+ * Must be called before start(). The register is read once to check that it
+ * is accessible; its value is left alone and picked up by the status
+ * monitoring, like a controller that kept running across a restart.
  * 
- * @param duty_cycle Duty cycle percentage (0-100)
- * @param pwm_count PWM count value to write to the register
- * @return true if the operation was successful, false otherwise
+ * @param bank Opened register bank
+ * @param offset Byte offset of the fan's PWM register in a memory-mapped bank
+ * @return true if the register can be read, false otherwise
  */
-bool Fan::setPwmCount(int duty_cycle, int pwm_count) {
-    if (status_ == "Bad") {
-        logger_->warning("Cannot set duty cycle - fan is in bad state");
-        return false;
-    }
+bool Fan::attachRegisterBank(std::shared_ptr<RegisterBank> bank, uint32_t offset) {
+    register_bank_ = std::move(bank);
+    register_address_.i2c_address = i2c_address_;
+    register_address_.reg = pwm_reg_;
+    register_address_.offset = offset;
+    uint32_t value = 0;
+    return !register_bank_ || register_bank_->read32(register_address_, value);
+}
+
+/**
+ * @brief Gives the fan a simulated tachometer
+ * 
+ * @param model Rotor dynamics of the fan model
+ * @param settings Sampling and fault detection settings
+ */
+void Fan::attachTachometer(const TachModel& model, const TachSettings& settings) {
+    tach_ = std::make_unique<Tachometer>(model, settings);
+}
 
-    if (duty_cycle < 0 || duty_cycle > 100) {
-        logger_->warning("Invalid duty cycle value: " + std::to_string(duty_cycle));
+/**
+ * @brief Samples the tachometer at the current duty cycle
+ * 
+ * When the sample confirms a fault the fan is marked bad and a "tach_fault"
+ * alarm is raised, as if makeBad() had been called for the fan.
+ * 
+ * @param now Current steady clock time
+ * @param timestamp_ms Wall clock time of the sample
+ * @return true if the sample confirmed a fault
+ */
+bool Fan::sampleTachometer(std::chrono::steady_clock::time_point now, int64_t timestamp_ms) {
+    if (!tach_ || !tach_->sample(getDutyCycle(), now, timestamp_ms)) {
         return false;
     }
+    updateState([](FanState& state) { state.health = FanHealth::BAD; });
+    std::string message = "Tachometer reads " + std::to_string(tach_->getRpm()) + " RPM at " +
+                          std::to_string(getDutyCycle()) + "% duty cycle";
+    int64_t latency_ms = tach_->getDetectionLatencyMs();
+    if (latency_ms >= 0) {
+        message += " (" + std::string(tachFaultName(tach_->getFault())) + ", detected after " +
+                   std::to_string(latency_ms) + " ms)";
+    }
+    logger_->warning(message);
+    alarm_->raise("tach_fault", common::AlarmSeverity::ERROR, message);
+    publishStatus();
+    return true;
+}
 
-    logger_->debug("Setting duty cycle to " + std::to_string(duty_cycle) + "%");
-    if (!writePwmCount(pwm_count)) {
-        logger_->error("Failed to write pwm count to I2C register");
-        alarm_->raise(common::AlarmSeverity::HIGH, "Failed to write pwm count to I2C register");
+/**
+ * @brief Writes a duty cycle to a fan without a register bank
+ * 
+ * Writes the simulated register and updates the cached state, without
+ * logging, alarms or the MQTT status update, so that a caller writing
+ * several fans reaches the last register as early as possible. The caller
+ * reports the outcome with reportPwmWrite() and publishes the status
+ * afterwards.
+ * 
+ * @param duty_cycle Duty cycle percentage (0-100)
+ * @param pwm_count PWM count value to write to the register
+ * @return true if the operation was successful, false otherwise
+ */
+bool Fan::setPwmCountUrgent(int duty_cycle, int pwm_count) {
+    if (getHealth() == FanHealth::BAD || duty_cycle < 0 || duty_cycle > 100 || pwm_count < 0 ||
+        !writePwmCount(static_cast<uint32_t>(pwm_count))) {
         return false;
     }
+    recordPwmCount(duty_cycle, pwm_count);
+    return true;
+}
 
-    current_pwm_count_ = pwm_count;
-    current_duty_cycle_ = duty_cycle;
-    // Update noise level, is not exactly as duty_cycle, but it is a range of duty_cycle
-    // so we need to find the closest noise level
-    int closest_noise_level = 0;
-    for (const auto& pair : noise_profile_) {
-        if (pair.first >= duty_cycle) {
-            closest_noise_level = pair.second;
-            break;
-        }
+/**
+ * @brief Updates the cached duty cycle, PWM count and noise level after a register write
+ * 
+ * The three values are published together, so readers never see a PWM count
+ * with the duty cycle or noise level of a different write.
+ * 
+ * @param duty_cycle Duty cycle written (0-100)
+ * @param pwm_count PWM count written
+ */
+void Fan::recordPwmCount(int duty_cycle, int pwm_count) {
+    uint8_t noise_level = static_cast<uint8_t>(std::max(0, std::min(noiseLevelAt(duty_cycle), 255)));
+    updateState([=](FanState& state) {
+        state.pwm_count = static_cast<uint32_t>(pwm_count);
+        state.duty_cycle = static_cast<uint8_t>(duty_cycle);
+        state.noise_level = noise_level;
+    });
+}
+
+/**
+ * @brief Reports the outcome of a register write made on the fan's behalf
+ * 
+ * Raises the "i2c_write" alarm when the write failed and clears it once a
+ * write succeeds again. Clearing an alarm that is not raised costs a lookup.
+ * 
+ * @param written Whether the PWM count reached the register
+ */
+void Fan::reportPwmWrite(bool written) {
+    if (written) {
+        alarm_->clear("i2c_write", "PWM count written to I2C register");
+    } else {
+        alarm_->raise("i2c_write", common::AlarmSeverity::ERROR, "Failed to write pwm count to I2C register");
     }
-    noise_level_ = closest_noise_level;
-    logger_->debug("Noise level set to " + std::to_string(noise_level_) + " for duty cycle " + std::to_string(duty_cycle) + "%");
-    publishStatus();
-    logger_->info("Pwm count set to " + std::to_string(pwm_count) + " for duty cycle " + std::to_string(duty_cycle) + "%");
-    return true;
 }
 
 /**
  * @brief Marks the fan as bad
  * 
- * Sets the fan status to "Bad" and raises a high severity alarm.
- * Also publishes the status change to MQTT.
+ * The tachometer, if any, simulates the fan model's failure mode and
+ * reports the fan bad once its samples detect it.
  * 
  * @return true if the operation was successful, false otherwise
  */
 bool Fan::makeBad() {
-    if (status_ == "Bad") {
+    return makeBad(tach_ ? tach_->getModel().failure_mode : TachFault::STALL);
+}
+
+/**
+ * @brief Marks the fan as bad with a given simulated failure
+ * 
+ * With a tachometer the failure is only injected: the fan keeps its status
+ * until the tachometer samples detect the failure, which marks it bad and
+ * raises "tach_fault" (see sampleTachometer()). Without one the fan status
+ * is set to "Bad" at once, a high severity alarm is raised and the status
+ * change is published to MQTT.
+ * 
+ * @param fault Failure the tachometer simulates
+ * @return true if the operation was successful, false otherwise
+ */
+bool Fan::makeBad(TachFault fault) {
+    if (tach_) {
+        logger_->info("Simulating tachometer failure: " + std::string(tachFaultName(fault)));
+        tach_->injectFault(fault);
+        return true;
+    }
+    FanHealth previous = FanHealth::BAD;
+    updateState([&previous](FanState& state) {
+        previous = state.health;
+        state.health = FanHealth::BAD;
+    });
+    if (previous == FanHealth::BAD) {
         logger_->debug("Fan already in bad state");
         return true;
     }
     
-    status_ = "Bad";
     logger_->warning("Fan marked as bad");
-    alarm_->raise(common::AlarmSeverity::HIGH, "Fan marked as bad");
+    alarm_->raise("fan_bad", common::AlarmSeverity::ERROR, "Fan marked as bad");
     publishStatus();
     return true;
 }
@@ -211,55 +394,72 @@ bool Fan::makeBad() {
 /**
  * @brief Marks the fan as good
  * 
- * Sets the fan status to "Good" and publishes the status change to MQTT.
+ * Sets the fan status to "Good", clears the fan-bad alarm and publishes the
+ * status change to MQTT. A simulated tachometer failure is removed.
  * 
  * @return true if the operation was successful, false otherwise
  */
 bool Fan::makeGood() {
-    if (status_ == "Good") {
+    if (tach_ && tach_->isFaultDetected()) {
+        alarm_->clear("tach_fault", "Fan marked as good");
+    }
+    if (tach_) {
+        tach_->clearFault();
+    }
+    FanHealth previous = FanHealth::GOOD;
+    updateState([&previous](FanState& state) {
+        previous = state.health;
+        state.health = FanHealth::GOOD;
+    });
+    if (previous == FanHealth::GOOD) {
         logger_->debug("Fan already in good state");
         return true;
     }
     
-    status_ = "Good";
     logger_->info("Fan marked as good");
+    alarm_->clear("fan_bad", "Fan marked as good");
     publishStatus();
     return true;
 }
 
 /**
- * @brief Reads the current PWM count from the I2C register
+ * @brief Reads the current PWM count from the fan's register
  * 
- * In a real implementation, this would read from the actual I2C register.
- * Currently simulates the reading operation.
+ * Reads through the register bank when one is attached, so changes made to
+ * the register from outside are picked up by the status monitoring. Without a
+ * bank the reading is simulated from the cached count.
  * 
  * @return Current PWM count value
  */
-int Fan::readPwmCount() {
-    // Simulate reading from I2C register
-    // In a real implementation, this would read from the actual I2C register
+uint32_t Fan::readPwmCount() {
+    uint32_t pwm_count = 0;
+    if (register_bank_ && register_bank_->read32(register_address_, pwm_count)) {
+        return pwm_count;
+    }
     logger_->debug("Reading pwm count from I2C register 0x" + 
                   std::to_string(static_cast<int>(pwm_reg_)) + 
                   " at address 0x" + std::to_string(static_cast<int>(i2c_address_)));
-    return current_pwm_count_;
+    return getState().pwm_count;
 }
 
 /**
- * @brief Writes a PWM count to the I2C register
+ * @brief Writes a PWM count to the fan's register
  * 
- * In a real implementation, this would write to the actual I2C register.
- * Currently simulates the writing operation.
+ * With a register bank attached this is a single 32-bit register write (one
+ * store for the memory-mapped backend). Without a bank the write is only
+ * simulated.
  * 
  * @param pwm_count PWM count value to write
  * @return true if the operation was successful, false otherwise
  */
-bool Fan::writePwmCount(int pwm_count) {
-    // Simulate writing to I2C register
-    // In a real implementation, this would write to the actual I2C register
-    if (status_ == "Bad") {
+bool Fan::writePwmCount(uint32_t pwm_count) {
+    if (getHealth() == FanHealth::BAD) {
         logger_->warning("Cannot write to I2C register - fan is in bad state");
         return false;
     }
+    if (register_bank_) {
+        return register_bank_->write32(register_address_, pwm_count);
+    }
 
     logger_->debug("Writing pwm count " + std::to_string(pwm_count) + 
                   "% to I2C register 0x" + std::to_string(static_cast<int>(pwm_reg_)) + 
@@ -276,12 +476,13 @@ bool Fan::writePwmCount(int pwm_count) {
 void Fan::publishStatus() {
     if (!mqtt_client_) return;
 
+    FanState state = getState();
     json status_data = {
         {"name", name_},
         {"model", model_name_},
-        {"status", status_},
-        {"pwm_count", current_pwm_count_},
-        {"duty_cycle", current_duty_cycle_},
+        {"status", fanHealthName(state.health)},
+        {"pwm_count", state.pwm_count},
+        {"duty_cycle", state.duty_cycle},
         {"i2c_address", i2c_address_},
         {"pwm_reg", pwm_reg_},
         {"timestamp", common::utils::formatTimestamp(std::chrono::system_clock::now())}
@@ -134,6 +134,17 @@ bool FanControlSystem::initialize_components() {
         alarm_manager_ = std::make_unique<fan_control_system::AlarmManager>(config_, mqtt_settings_);
         std::cout << "Alarm manager initialized" << std::endl;
 
+        // Cooling actions run inline on alarm delivery, ahead of the control loop
+        auto fan_simulator = fan_simulator_;
+        alarm_manager_->register_fast_action("MaxFanSpeed",
+            [fan_simulator](const std::string& alarm_source, const std::string&) {
+                fan_simulator->max_fan_speed(alarm_source);
+            });
+        alarm_manager_->register_fast_action("IncreaseFanSpeed",
+            [fan_simulator](const std::string& alarm_source, const std::string&) {
+                fan_simulator->increase_fan_speed(alarm_source);
+            });
+
         // Initialize RPC server
         rpc_server_ = std::make_unique<fan_control_system::FanControlSystemServer>(*this);
         std::cout << "RPC server initialized" << std::endl;
@@ -2,9 +2,15 @@
 #include "fan_control_system/fan_simulator.hpp"
 #include "fan_control_system/temp_monitor_and_cooling.hpp"
 #include "fan_control_system/alarm_manager.hpp"
+#include "fan_control_system/alarm_broadcaster.hpp"
+#include "fan_control_system/log_manager.hpp"
 #include <iostream>
 #include "common/config.hpp"
+#include "common/flight_recorder.hpp"
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <map>
 #include "common/utils.hpp"
 #include <grpcpp/grpcpp.h>
 
@@ -28,17 +34,27 @@ grpc::Status FanControlSystemServiceImpl::GetFanStatus(grpc::ServerContext* cont
             auto* fan_status = response->add_fans();
             fan_status->set_name(fan_pair.second->getName());
             fan_status->set_model(fan_pair.second->getModelName());
-            fan_status->set_is_online(fan_pair.second->getStatus() != "Bad");
-            fan_status->set_current_duty_cycle(fan_pair.second->getDutyCycle());
-            fan_status->set_current_pwm(fan_pair.second->getPWMCount());
-            fan_status->set_noise_level_db(fan_pair.second->getNoiseLevel());
-            fan_status->set_status(fan_pair.second->getStatus());
+            // One snapshot so the reported fields belong to the same update
+            const FanState state = fan_pair.second->getState();
+            fan_status->set_is_online(state.health != FanHealth::BAD);
+            fan_status->set_current_duty_cycle(state.duty_cycle);
+            fan_status->set_current_pwm(static_cast<int>(state.pwm_count));
+            fan_status->set_noise_level_db(state.noise_level);
+            fan_status->set_status(fanHealthName(state.health));
             fan_status->set_interface(fan_pair.second->getInterface());
             fan_status->set_i2c_address(fan_pair.second->getI2CAddress());
             fan_status->set_pwm_min(fan_pair.second->getPWMMin());
             fan_status->set_pwm_max(fan_pair.second->getPWMMax());
             fan_status->set_duty_cycle_min(fan_pair.second->getDutyCycleMin());
             fan_status->set_duty_cycle_max(fan_pair.second->getDutyCycleMax());
+            const ActuatorFanStats actuator = fan_simulator->get_actuator_stats(fan_pair.first);
+            fan_status->set_commands_submitted(actuator.submitted);
+            fan_status->set_commands_coalesced(actuator.coalesced);
+            fan_status->set_register_writes(actuator.register_writes);
+            const Tachometer* tach = fan_pair.second->getTachometer();
+            fan_status->set_rpm(fan_pair.second->getRpm());
+            fan_status->set_tach_fault(tachFaultName(tach ? tach->getFault() : TachFault::NONE));
+            fan_status->set_tach_fault_detected(tach && tach->isFaultDetected());
         }
     } else {
         // Return status of specific fan
@@ -49,17 +65,27 @@ grpc::Status FanControlSystemServiceImpl::GetFanStatus(grpc::ServerContext* cont
         auto* fan_status = response->add_fans();
         fan_status->set_name(fan->getName());
         fan_status->set_model(fan->getModelName());
-        fan_status->set_is_online(fan->getStatus() != "Bad");
-        fan_status->set_current_duty_cycle(fan->getDutyCycle());
-        fan_status->set_current_pwm(fan->getPWMCount());
-        fan_status->set_noise_level_db(fan->getNoiseLevel());
-        fan_status->set_status(fan->getStatus());
+        // One snapshot so the reported fields belong to the same update
+        const FanState state = fan->getState();
+        fan_status->set_is_online(state.health != FanHealth::BAD);
+        fan_status->set_current_duty_cycle(state.duty_cycle);
+        fan_status->set_current_pwm(static_cast<int>(state.pwm_count));
+        fan_status->set_noise_level_db(state.noise_level);
+        fan_status->set_status(fanHealthName(state.health));
         fan_status->set_interface(fan->getInterface());
         fan_status->set_i2c_address(fan->getI2CAddress());
         fan_status->set_pwm_min(fan->getPWMMin());
         fan_status->set_pwm_max(fan->getPWMMax());
         fan_status->set_duty_cycle_min(fan->getDutyCycleMin());
         fan_status->set_duty_cycle_max(fan->getDutyCycleMax());
+        const ActuatorFanStats actuator = fan_simulator->get_actuator_stats(fan->getName());
+        fan_status->set_commands_submitted(actuator.submitted);
+        fan_status->set_commands_coalesced(actuator.coalesced);
+        fan_status->set_register_writes(actuator.register_writes);
+        const Tachometer* tach = fan->getTachometer();
+        fan_status->set_rpm(fan->getRpm());
+        fan_status->set_tach_fault(tachFaultName(tach ? tach->getFault() : TachFault::NONE));
+        fan_status->set_tach_fault_detected(tach && tach->isFaultDetected());
     }
     return grpc::Status::OK;
 }
@@ -73,28 +99,31 @@ grpc::Status FanControlSystemServiceImpl::SetFanSpeed(grpc::ServerContext* conte
     }
     
     if (request->fan_name().empty()) {
-        int current_duty_cycle = 0;
+        std::map<std::string, int> previous_duty_cycles;
         for (const auto& fan_pair : fan_simulator->get_fans()) {
-            current_duty_cycle = fan_pair.second->getDutyCycle();
-            // We just need to get one fan to get the current duty cycle
-            break;
+            previous_duty_cycles[fan_pair.first] = fan_pair.second->getDutyCycle();
         }
-        // Set speed for all fans
-        if (!fan_simulator->set_fan_speed(request->duty_cycle())) {
+        // Set speed for all fans and wait for the register writes
+        std::map<std::string, bool> written;
+        if (!fan_simulator->set_all_fan_speeds(request->duty_cycle(), written) && written.empty()) {
             return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to set fan speed for all fans");
         }
         
         // Add results for each fan
+        bool all_written = true;
         for (const auto& fan_pair : fan_simulator->get_fans()) {
+            bool fan_written = written[fan_pair.first];
+            all_written = all_written && fan_written;
             auto* result = response->add_results();
             result->set_fan_name(fan_pair.first);
-            result->set_success(true);
-            result->set_previous_duty_cycle(current_duty_cycle);
-            result->set_new_duty_cycle(request->duty_cycle());
+            result->set_success(fan_written);
+            result->set_previous_duty_cycle(previous_duty_cycles[fan_pair.first]);
+            result->set_new_duty_cycle(fan_written ? request->duty_cycle() : fan_pair.second->getDutyCycle());
         }
         
-        response->set_success(true);
-        response->set_message("Fan speed set successfully for all fans");
+        response->set_success(all_written);
+        response->set_message(all_written ? "Fan speed set successfully for all fans"
+                                          : "Fan speed could not be written to every fan");
     } else {
         const auto fan_speed = fan_simulator->get_fan_speed(request->fan_name());
         if (fan_speed == -1) {
@@ -126,7 +155,7 @@ grpc::Status FanControlSystemServiceImpl::MakeFanBad(grpc::ServerContext* contex
     if (!fan_simulator) {
         return grpc::Status(grpc::StatusCode::INTERNAL, "Fan simulator not available");
     }
-    if (!fan_simulator->make_fan_bad(request->fan_name())) {
+    if (!fan_simulator->make_fan_bad(request->fan_name(), request->failure_mode())) {
         return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to make fan bad");
     }
     response->set_success(true);
@@ -180,6 +209,81 @@ grpc::Status FanControlSystemServiceImpl::GetFanNoiseLevel(grpc::ServerContext*
     return grpc::Status::OK;
 }
 
+grpc::Status FanControlSystemServiceImpl::GetFanRpmHistory(grpc::ServerContext* context,
+                                                          const FanRpmHistoryRequest* request,
+                                                          FanRpmHistoryResponse* response) {
+    const auto& fan_simulator = system_.get_fan_simulator();
+    if (!fan_simulator) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Fan simulator not available");
+    }
+    auto fan = fan_simulator->get_fan(request->fan_name());
+    if (!fan) {
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Fan not found: " + request->fan_name());
+    }
+    const Tachometer* tach = fan->getTachometer();
+    std::vector<TachSample> samples;
+    if (!tach || !fan_simulator->get_rpm_history(request->fan_name(),
+                                                 static_cast<size_t>(std::max(0, request->max_samples())), samples)) {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Tachometers are disabled");
+    }
+    response->set_fan_name(fan->getName());
+    response->set_sample_interval_ms(static_cast<int32_t>(fan_simulator->get_tach_settings().sample_interval.count()));
+    response->set_current_rpm(tach->getRpm());
+    response->set_tach_fault(tachFaultName(tach->getFault()));
+    response->set_fault_detected(tach->isFaultDetected());
+    response->set_detection_latency_ms(tach->getDetectionLatencyMs());
+    for (const auto& sample : samples) {
+        auto* entry = response->add_samples();
+        entry->set_timestamp_ms(sample.timestamp_ms);
+        entry->set_rpm(static_cast<int32_t>(sample.rpm));
+        entry->set_expected_rpm(static_cast<int32_t>(sample.expected_rpm));
+        entry->set_duty_cycle(sample.duty_cycle);
+    }
+    return grpc::Status::OK;
+}
+
+// Helper function to fill a ProtoNoiseExposure
+static void fillNoiseExposure(const std::string& name, const NoiseExposure& exposure, ProtoNoiseExposure* proto) {
+    auto fill_window = [](const NoiseExposureWindow& window, ProtoExposureWindow* entry) {
+        entry->set_leq_db(window.leq_db);
+        entry->set_dose_percent(window.dose_percent);
+        entry->set_covered_s(window.covered_s);
+    };
+    proto->set_name(name);
+    proto->set_level_db(exposure.level_db);
+    proto->set_changes(exposure.changes);
+    fill_window(exposure.minute, proto->mutable_last_minute());
+    fill_window(exposure.hour, proto->mutable_last_hour());
+    fill_window(exposure.shift, proto->mutable_shift());
+}
+
+grpc::Status FanControlSystemServiceImpl::GetNoiseExposure(grpc::ServerContext* context,
+                                                          const NoiseExposureRequest* request,
+                                                          NoiseExposureResponse* response) {
+    const auto& fan_simulator = system_.get_fan_simulator();
+    if (!fan_simulator) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Fan simulator not available");
+    }
+    const auto& settings = fan_simulator->get_noise_exposure_settings();
+    response->set_criterion_level_db(settings.criterion_level_db);
+    response->set_criterion_hours(settings.criterion_duration.count() / 60.0);
+    response->set_shift_hours(settings.shift.count() / 60.0);
+    fillNoiseExposure("combined", fan_simulator->get_combined_noise_exposure(), response->mutable_combined());
+    for (const auto& fan : fan_simulator->get_fans()) {
+        if (!request->fan_name().empty() && fan.first != request->fan_name()) {
+            continue;
+        }
+        NoiseExposure exposure;
+        if (fan_simulator->get_noise_exposure(fan.first, exposure)) {
+            fillNoiseExposure(fan.first, exposure, response->add_fans());
+        }
+    }
+    if (!request->fan_name().empty() && response->fans_size() == 0) {
+        return grpc::Status(grpc::StatusCode::NOT_FOUND, "Fan not found: " + request->fan_name());
+    }
+    return grpc::Status::OK;
+}
+
 // Temperature Monitor operations
 grpc::Status FanControlSystemServiceImpl::GetTemperatureHistory(grpc::ServerContext* context,
                                                                const TemperatureHistoryRequest* request,
@@ -252,6 +356,20 @@ grpc::Status FanControlSystemServiceImpl::GetCoolingStatus(grpc::ServerContext*
     response->set_average_temperature(cooling_status.average_temperature);
     response->set_current_fan_speed(cooling_status.current_fan_speed);
     response->set_cooling_mode(cooling_status.cooling_mode);
+    const auto& fan_simulator = system_.get_fan_simulator();
+    if (fan_simulator) {
+        auto shaper_stats = fan_simulator->get_shaper_stats();
+        auto* shaper = response->mutable_shaper();
+        shaper->set_enabled(fan_simulator->is_actuation_shaped());
+        shaper->set_requests(shaper_stats.requests);
+        shaper->set_writes(shaper_stats.writes);
+        shaper->set_avoided_unchanged(shaper_stats.avoided_unchanged);
+        shaper->set_avoided_hysteresis(shaper_stats.avoided_hysteresis);
+        shaper->set_deferred_dwell(shaper_stats.deferred_dwell);
+        shaper->set_slew_limited(shaper_stats.slew_limited);
+        response->set_fan_allocation(fanAllocationModeName(fan_simulator->get_allocation_mode()));
+        response->set_total_noise_db(fan_simulator->get_total_noise_db());
+    }
     return grpc::Status::OK;
 }
 
@@ -399,6 +517,181 @@ grpc::Status FanControlSystemServiceImpl::GetAlarmStatistics(grpc::ServerContext
     return grpc::Status::OK;
 }
 
+grpc::Status FanControlSystemServiceImpl::GetActionQueueStats(grpc::ServerContext* context,
+                                                            const ActionQueueStatsRequest* request,
+                                                            ActionQueueStatsResponse* response) {
+    const auto& alarm_manager = system_.get_alarm_manager();
+    if (!alarm_manager) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Alarm manager not available");
+    }
+
+    ActionExecutorStats stats = alarm_manager->get_action_executor_stats();
+    response->set_pending(static_cast<int32_t>(stats.pending));
+    response->set_high_water(static_cast<int32_t>(stats.high_water));
+    response->set_running(static_cast<int32_t>(stats.running));
+    response->set_workers(static_cast<int32_t>(stats.workers));
+    response->set_submitted(static_cast<int64_t>(stats.submitted));
+    response->set_coalesced(static_cast<int64_t>(stats.coalesced));
+    response->set_dropped(static_cast<int64_t>(stats.dropped));
+    response->set_executed(static_cast<int64_t>(stats.executed));
+    response->set_failed(static_cast<int64_t>(stats.failed));
+    response->set_timed_out(static_cast<int64_t>(stats.timed_out));
+    response->set_max_wait_ms(stats.max_wait_ms);
+    return grpc::Status::OK;
+}
+
+grpc::Status FanControlSystemServiceImpl::GetIncidents(grpc::ServerContext* context,
+                                                     const IncidentsRequest* request,
+                                                     IncidentsResponse* response) {
+    const auto& alarm_manager = system_.get_alarm_manager();
+    if (!alarm_manager) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Alarm manager not available");
+    }
+
+    auto to_timestamp = [](int64_t time_ms) {
+        return common::utils::formatTimestampMs(
+            std::chrono::system_clock::time_point(std::chrono::milliseconds(time_ms)));
+    };
+    size_t max_incidents = request->max_incidents() > 0 ? static_cast<size_t>(request->max_incidents()) : 0;
+    for (const auto& incident : alarm_manager->get_incidents(max_incidents)) {
+        auto* proto_incident = response->add_incidents();
+        proto_incident->set_id(incident.id);
+        proto_incident->set_rule(incident.rule);
+        proto_incident->set_key(incident.key);
+        proto_incident->set_root_source(incident.root_source);
+        proto_incident->set_root_message(incident.root_message);
+        proto_incident->set_severity(static_cast<ProtoAlarmSeverity>(incident.severity));
+        proto_incident->set_first_timestamp(to_timestamp(incident.first_time_ms));
+        proto_incident->set_latest_timestamp(to_timestamp(incident.latest_time_ms));
+        proto_incident->set_alarm_count(incident.alarm_count);
+        proto_incident->set_suppressed_actions(incident.suppressed_actions);
+        for (const auto& member : incident.members) {
+            (*proto_incident->mutable_members())[member.first] = member.second;
+        }
+        proto_incident->set_open(incident.open);
+    }
+    return grpc::Status::OK;
+}
+
+grpc::Status FanControlSystemServiceImpl::WatchAlarms(grpc::ServerContext* context,
+                                                    const WatchAlarmsRequest* request,
+                                                    grpc::ServerWriter<ProtoAlarmEvent>* writer) {
+    const auto& alarm_manager = system_.get_alarm_manager();
+    if (!alarm_manager) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Alarm manager not available");
+    }
+
+    auto subscription = alarm_manager->watch_alarms(request->alarm_name(),
+                                                    convertProtoSeverity(request->min_severity()));
+    if (!subscription) {
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED, "Too many alarm watchers");
+    }
+
+    // Wake up periodically to notice client cancellation while idle
+    AlarmEvent event;
+    ProtoAlarmEvent proto_event;
+    while (!context->IsCancelled()) {
+        if (!subscription->next(event, std::chrono::milliseconds(500))) {
+            if (subscription->closed()) {
+                break;
+            }
+            continue;
+        }
+
+        proto_event.set_type(static_cast<ProtoAlarmEventType>(event.type));
+        proto_event.set_sequence(event.sequence);
+        proto_event.set_alarm_name(event.source);
+        proto_event.set_alarm_id(event.alarm_id);
+        proto_event.set_message(event.message);
+        proto_event.set_severity(static_cast<ProtoAlarmSeverity>(event.severity));
+        proto_event.set_timestamp(event.timestamp);
+        proto_event.set_occurrence_count(event.occurrence_count);
+        proto_event.set_cleared_entries(event.cleared_entries);
+        proto_event.set_dropped_events(subscription->dropped());
+        if (!writer->Write(proto_event)) {
+            break;
+        }
+    }
+
+    alarm_manager->unwatch_alarms(subscription);
+    return grpc::Status::OK;
+}
+
+// Logging operations
+grpc::Status FanControlSystemServiceImpl::SetLogLevel(grpc::ServerContext* context,
+                                                    const SetLogLevelRequest* request,
+                                                    SetLogLevelResponse* response) {
+    auto* log_manager = system_.get_log_manager();
+    if (!log_manager) {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Log manager not available");
+    }
+
+    const std::string& name = request->logger_name();
+    bool all = name.empty() || name == "all";
+
+    if (!request->level().empty()) {
+        common::LogLevel level;
+        if (!common::Logger::parseLevel(request->level(), level)) {
+            response->set_success(false);
+            response->set_message("Invalid log level: " + request->level());
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid log level");
+        }
+
+        if (name == "LogFile") {
+            log_manager->set_file_log_level(level);
+            response->set_message("Log file level set to " + request->level());
+        } else {
+            size_t changed = common::Logger::setLevelByName(name, level);
+            if (changed == 0) {
+                response->set_success(false);
+                response->set_message("Logger not found: " + name);
+                return grpc::Status(grpc::StatusCode::NOT_FOUND, "Logger not found");
+            }
+            // The file filter must not hide messages a logger was just asked to emit
+            if (all || level < log_manager->get_file_log_level()) {
+                log_manager->set_file_log_level(level);
+            }
+            response->set_message("Log level set to " + request->level() + " for " +
+                                  std::to_string(changed) + " logger(s)");
+        }
+    }
+
+    for (const auto& logger_level : common::Logger::listLevels()) {
+        auto* proto_level = response->add_loggers();
+        proto_level->set_name(logger_level.first);
+        proto_level->set_level(logger_level.second);
+    }
+    response->set_file_level(common::Logger::levelToString(log_manager->get_file_log_level()));
+    response->set_success(true);
+    return grpc::Status::OK;
+}
+
+grpc::Status FanControlSystemServiceImpl::DumpFlightRecorder(grpc::ServerContext* context,
+                                                     const DumpFlightRecorderRequest* request,
+                                                     DumpFlightRecorderResponse* response) {
+    // Keep the reason usable as part of a file name
+    std::string reason = request->reason().empty() ? "rpc" : request->reason();
+    for (auto& c : reason) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') {
+            c = '_';
+        }
+    }
+
+    std::string path;
+    size_t records = 0;
+    if (!common::FlightRecorder::getInstance().dump(reason.c_str(), true, &path, &records)) {
+        response->set_success(false);
+        response->set_message("Flight recorder is disabled or the dump failed");
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Flight recorder dump failed");
+    }
+
+    response->set_success(true);
+    response->set_message("Flight recorder dumped");
+    response->set_file_path(path);
+    response->set_record_count(static_cast<int32_t>(records));
+    return grpc::Status::OK;
+}
+
 // FanControlSystemServer implementation
 FanControlSystemServer::FanControlSystemServer(FanControlSystem& system)
     : RPCServer("FanControlSystem", 
@@ -2,7 +2,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include "common/utils.hpp"
 
 using json = nlohmann::json;
 
@@ -20,7 +22,8 @@ namespace fan_control_system {
  * @throw std::runtime_error if initialization fails
  */
 FanSimulator::FanSimulator(const YAML::Node& config, const common::MQTTClient::Settings& mqtt_settings)
-    : config_(config), mqtt_settings_(mqtt_settings), running_(false), is_it_loud_(false) {
+    : config_(config), mqtt_settings_(mqtt_settings), running_(false), ramp_timer_(0), tach_timer_(0),
+      is_it_loud_(false), loud_timer_(0) {
     name_ = "FanSimulator";
     // Initialize MQTT client and logger first
     mqtt_client_ = std::make_shared<common::MQTTClient>(name_, mqtt_settings_);
@@ -37,6 +40,26 @@ FanSimulator::FanSimulator(const YAML::Node& config, const common::MQTTClient::S
     if (!load_fan_models() || !create_fans()) {
         throw std::runtime_error("Failed to initialize fan simulator");
     }
+
+    for (const auto& fan : fans_) {
+        fan_index_[fan.first] = fan_slots_.size();
+        fan_slots_.push_back(fan.second.get());
+    }
+    dosimeter_ = std::make_unique<NoiseDosimeter>(fan_slots_.size(),
+                                                  NoiseExposureSettings::fromConfig(config_["NoiseExposure"]));
+    actuator_ = std::make_unique<ActuatorQueue>(fan_slots_.size(), actuator_tick_,
+                                                [this](std::vector<ActuatorCommand>& commands) { apply_commands(commands); });
+    const YAML::Node actuator = config_["Actuator"];
+    shaper_ = std::make_unique<ActuationShaper>(
+        fan_slots_.size(), ActuationShaperSettings::fromConfig(actuator ? actuator["Shaper"] : YAML::Node()));
+    if (allocation_mode_ == FanAllocationMode::NOISE_OPTIMIZED) {
+        std::lock_guard<std::mutex> lock(allocator_mutex_);
+        allocator_bad_.assign(fan_slots_.size(), false);
+        for (size_t i = 0; i < fan_slots_.size(); ++i) {
+            allocator_bad_[i] = fan_slots_[i]->getHealth() == FanHealth::BAD;
+        }
+        build_allocator();
+    }
 }
 
 /**
@@ -51,7 +74,10 @@ FanSimulator::~FanSimulator() {
 /**
  * @brief Starts the fan simulator
  * 
- * Initializes all fans and starts the main monitoring thread.
+ * Initializes all fans, starts the noise exposure accounting from their
+ * current speeds and starts the actuator thread. With the actuation shaper
+ * enabled, it starts from the fans' current speeds and its ramp steps are
+ * scheduled on the shared timer wheel.
  * 
  * @return true if startup was successful, false otherwise
  */
@@ -66,8 +92,31 @@ bool FanSimulator::start() {
         return false;
     }
 
+    std::vector<int> levels;
+    levels.reserve(fan_slots_.size());
+    for (const Fan* fan : fan_slots_) {
+        levels.push_back(fan->noiseLevelAt(fan->getDutyCycle()));
+    }
+    dosimeter_->start(levels, std::chrono::steady_clock::now());
+    account_noise({});
+
     running_ = true;
-    main_thread_ = std::thread(&FanSimulator::main_thread_function, this);
+    actuator_->start();
+    if (shaper_->settings().enabled) {
+        {
+            std::lock_guard<std::mutex> lock(shaper_mutex_);
+            auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < fan_slots_.size(); ++i) {
+                shaper_->sync(i, fan_slots_[i]->getDutyCycle(), now);
+            }
+        }
+        ramp_timer_ = common::TimerWheel::getInstance().schedulePeriodic(shaper_->settings().ramp_interval,
+                                                                        [this]() { step_shaper(); });
+    }
+    if (tach_settings_.enabled) {
+        tach_timer_ = common::TimerWheel::getInstance().schedulePeriodic(tach_settings_.sample_interval,
+                                                                        [this]() { sample_tachometers(); });
+    }
     logger_->info("Fan Simulator started successfully");
     return true;
 }
@@ -75,7 +124,8 @@ bool FanSimulator::start() {
 /**
  * @brief Stops the fan simulator
  * 
- * Stops the main monitoring thread and all fan instances.
+ * Cancels the timers, stops the actuator thread (discarding commands not
+ * yet written) and stops all fan instances.
  */
 void FanSimulator::stop() {
     if (!running_) {
@@ -84,9 +134,16 @@ void FanSimulator::stop() {
 
     logger_->info("Stopping Fan Simulator...");
     running_ = false;
-    if (main_thread_.joinable()) {
-        main_thread_.join();
+    if (ramp_timer_ != 0) {
+        common::TimerWheel::getInstance().cancel(ramp_timer_);
+        ramp_timer_ = 0;
+    }
+    if (tach_timer_ != 0) {
+        common::TimerWheel::getInstance().cancel(tach_timer_);
+        tach_timer_ = 0;
     }
+    actuator_->stop();
+    common::TimerWheel::getInstance().cancel(loud_timer_.exchange(0));
 
     // Stop all fans
     for (auto& fan : fans_) {
@@ -96,55 +153,192 @@ void FanSimulator::stop() {
 }
 
 /**
- * @brief Gets the noise level for a fan model at a given duty cycle
+ * @brief Sets the speed for all fans
+ * 
+ * Queues the duty cycle for every fan; the actuator thread writes the
+ * registers on its next tick together with any other pending commands.
  * 
- * @param model Name of the fan model
- * @param duty_cycle Current duty cycle percentage
- * @return Noise level in decibels, or 0 if model not found
+ * With the actuation shaper enabled an AUTO speed becomes the fans' shaper
+ * target instead: only the first ramp step, if any, is queued now and the
+ * ramp timer queues the rest. While an emergency floor is active the speed
+ * is queued as is, so the shaper knows the speed the fans are held at.
+ * 
+ * In the noise-optimized allocation mode an AUTO speed is the cooling
+ * effort: each fan gets its duty cycle from the precomputed plan for it,
+ * see allocate_speeds().
+ * 
+ * @param duty_cycle Target duty cycle percentage
+ * @param source Origin of the command
+ * @return true if the command was accepted, false if the duty cycle is invalid
  */
-int FanSimulator::get_noise_level(const std::string& model, int duty_cycle) const {
-    auto it = fan_models_.find(model);
-    if (it == fan_models_.end()) {
-        return 0;
+bool FanSimulator::set_fan_speed(int duty_cycle, CommandSource source) {
+    if (duty_cycle < 0 || duty_cycle > 100) {
+        logger_->warning("Invalid duty cycle value: " + std::to_string(duty_cycle));
+        return false;
     }
-    const auto& fan_model = it->second;
-    for (const auto& profile : fan_model.noise_profile) {
-        if (duty_cycle >= profile.first) {
-            return profile.second;
+    std::vector<uint8_t> plan;
+    const bool planned = source == CommandSource::AUTO && allocate_speeds(duty_cycle, plan);
+    if (source == CommandSource::AUTO && shaper_->settings().enabled && get_speed_floor() == 0) {
+        std::lock_guard<std::mutex> lock(shaper_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < fan_slots_.size(); ++i) {
+            shaper_->set_target(i, planned ? plan[i] : duty_cycle, now);
+        }
+        std::vector<ActuatorCommand> commands;
+        shaper_->step(now, commands);
+        if (!commands.empty()) {
+            actuator_->submit(commands);
         }
+        logger_->debug("Fan speed target " + std::to_string(duty_cycle) + "% set for all fans, " +
+                       std::to_string(commands.size()) + " fans stepped");
+        return true;
     }
-    return 0;
+    if (planned) {
+        std::vector<ActuatorCommand> commands(fan_slots_.size());
+        for (size_t i = 0; i < commands.size(); ++i) {
+            commands[i].fan = i;
+            commands[i].source = source;
+            commands[i].duty_cycle = plan[i];
+        }
+        submit_unshaped(commands);
+        logger_->debug("Fan speed effort " + std::to_string(duty_cycle) + "% queued as per-fan speeds");
+        return true;
+    }
+    submit_all(duty_cycle, source);
+    logger_->debug("Fan speed " + std::to_string(duty_cycle) + "% queued for all fans (" +
+                   commandSourceName(source) + ")");
+    return true;
 }
 
 /**
- * @brief Sets the speed for all fans
+ * @brief Spreads a cooling effort over the fans in the noise-optimized mode
  * 
- * Converts the duty cycle to PWM count and sets it for each fan.
+ * The plan only covers the healthy fans, since bad fans are not written.
+ * When a fan changes health the plans are solved again for the fans that
+ * are still healthy, which takes well under a millisecond; bad fans keep
+ * the effort itself as their duty cycle.
  * 
- * @param duty_cycle Target duty cycle percentage
- * @return true if all fans were set successfully, false otherwise
+ * @param effort Duty cycle computed by the control loop
+ * @param plan Receives the duty cycle per fan slot
+ * @return true if a plan was made, false in the EQUAL mode
  */
-bool FanSimulator::set_fan_speed(int duty_cycle) {
-    for (auto& fan : fans_) {
-        logger_->debug("Setting fan speed to " + std::to_string(duty_cycle) + "%");
-        //convert duty cycle to pwm
-        int pwm_count = duty_cycle_to_pwm(fan.second->getModelName(), duty_cycle);
-        bool result = fan.second->setPwmCount(duty_cycle, pwm_count);
-        if (!result) {
-            logger_->error("Failed to set fan speed for " + fan.first);
+bool FanSimulator::allocate_speeds(int effort, std::vector<uint8_t>& plan) {
+    if (allocation_mode_ != FanAllocationMode::NOISE_OPTIMIZED) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(allocator_mutex_);
+    bool changed = false;
+    for (size_t i = 0; i < fan_slots_.size(); ++i) {
+        bool bad = fan_slots_[i]->getHealth() == FanHealth::BAD;
+        if (bad != allocator_bad_[i]) {
+            allocator_bad_[i] = bad;
+            changed = true;
         }
     }
+    if (changed) {
+        build_allocator();
+    }
+
+    plan.assign(fan_slots_.size(), static_cast<uint8_t>(effort));
+    const std::vector<uint8_t>& healthy = allocator_->allocate(effort);
+    for (size_t k = 0; k < healthy.size(); ++k) {
+        plan[allocator_fans_[k]] = healthy[k];
+    }
     return true;
 }
 
+/**
+ * @brief Solves the allocation plans over the fans not marked bad in allocator_bad_
+ * 
+ * Each fan's duty cycle is weighted by the airflow of its model, MaxRPM
+ * times the number of fans. Called with allocator_mutex_ held.
+ */
+void FanSimulator::build_allocator() {
+    std::vector<FanNoiseTable> tables;
+    allocator_fans_.clear();
+    for (size_t i = 0; i < fan_slots_.size(); ++i) {
+        if (allocator_bad_[i]) {
+            continue;
+        }
+        FanNoiseTable table;
+        for (int duty = 0; duty <= 100; ++duty) {
+            table.noise_db[duty] = fan_slots_[i]->noiseLevelAt(duty);
+        }
+        table.min_duty_cycle = fan_slots_[i]->getDutyCycleMin();
+        table.max_duty_cycle = fan_slots_[i]->getDutyCycleMax();
+        auto model = fan_models_.find(fan_slots_[i]->getModelName());
+        if (model != fan_models_.end()) {
+            table.weight = std::max(model->second.tach.max_rpm, 1) * std::max(model->second.number_of_fans, 1);
+        }
+        tables.push_back(table);
+        allocator_fans_.push_back(i);
+    }
+    allocator_ = std::make_unique<DutyAllocator>(tables, allocation_min_duty_);
+    logger_->info("Noise-optimized fan allocation over " + std::to_string(tables.size()) + " of " +
+                  std::to_string(fan_slots_.size()) + " fans: " + std::to_string(allocator_->equalNoiseDb(100)) +
+                  " dB at full effort, " + std::to_string(allocator_->planNoiseDb(50)) + " dB instead of " +
+                  std::to_string(allocator_->equalNoiseDb(50)) + " dB at 50%");
+}
+
+/**
+ * @brief Sets the speed for every fan as a manual override and waits for the writes
+ * 
+ * Used by the SetFanSpeed RPC, which reports the outcome per fan. Bad fans
+ * are skipped by write_fans() and come back as not written.
+ * 
+ * @param duty_cycle Target duty cycle percentage
+ * @param written Receives for every fan name whether its register was written
+ * @return false if the duty cycle is invalid or the writes were not processed in time
+ */
+bool FanSimulator::set_all_fan_speeds(int duty_cycle, std::map<std::string, bool>& written) {
+    written.clear();
+    if (duty_cycle < 0 || duty_cycle > 100) {
+        logger_->warning("Invalid duty cycle value: " + std::to_string(duty_cycle));
+        return false;
+    }
+    std::vector<ActuatorCommand> commands(fan_slots_.size());
+    for (size_t i = 0; i < commands.size(); ++i) {
+        commands[i].fan = i;
+        commands[i].source = CommandSource::MANUAL;
+        commands[i].duty_cycle = duty_cycle;
+    }
+    bool processed = submit_and_wait(commands);
+    for (const auto& command : commands) {
+        written[fan_slots_[command.fan]->getName()] = command.written;
+    }
+    return processed;
+}
+
+/**
+ * @brief Sets the speed for a specific fan as a manual override
+ * 
+ * Waits until the actuator has processed the command, so the result tells
+ * whether the register was actually written.
+ * 
+ * @param fan_name Name of the fan
+ * @param duty_cycle Target duty cycle percentage
+ * @return true if the register was written, false otherwise
+ */
 bool FanSimulator::set_fan_speed(const std::string& fan_name, int duty_cycle) {
-    auto it = fans_.find(fan_name);
-    if (it == fans_.end()) {
+    auto it = fan_index_.find(fan_name);
+    if (it == fan_index_.end()) {
         logger_->warning("Attempted to set speed for non-existent fan: " + fan_name);
         return false;
     }
-    int pwm_count = duty_cycle_to_pwm(it->second->getModelName(), duty_cycle);
-    return it->second->setPwmCount(duty_cycle, pwm_count);
+    if (duty_cycle < 0 || duty_cycle > 100) {
+        logger_->warning("Invalid duty cycle value: " + std::to_string(duty_cycle));
+        return false;
+    }
+    if (fan_slots_[it->second]->getHealth() == FanHealth::BAD) {
+        logger_->warning("Cannot set duty cycle - fan " + fan_name + " is in bad state");
+        return false;
+    }
+    ActuatorCommand command;
+    command.fan = it->second;
+    command.source = CommandSource::MANUAL;
+    command.duty_cycle = duty_cycle;
+    std::vector<ActuatorCommand> commands{command};
+    return submit_and_wait(commands) && commands[0].written;
 }
 
 /**
@@ -184,17 +378,23 @@ std::shared_ptr<Fan> FanSimulator::get_fan(const std::string& name) {
  * @brief Marks a fan as bad
  * 
  * @param name Name of the fan to mark as bad
+ * @param failure_mode Failure the tachometer simulates, empty for the fan model's failure mode
  * @return true if the operation was successful, false otherwise
  */
-bool FanSimulator::make_fan_bad(const std::string& name) {
+bool FanSimulator::make_fan_bad(const std::string& name, const std::string& failure_mode) {
     auto it = fans_.find(name);
     if (it == fans_.end()) {
         logger_->warning("Attempted to make non-existent fan bad: " + name);
         return false;
     }
+    TachFault fault = TachFault::NONE;
+    if (!failure_mode.empty() && (!parseTachFault(failure_mode, fault) || fault == TachFault::NONE)) {
+        logger_->warning("Unknown fan failure mode: " + failure_mode);
+        return false;
+    }
 
-    logger_->info("Making fan bad: " + name);
-    bool result = it->second->makeBad();
+    logger_->info("Making fan bad: " + name + (failure_mode.empty() ? "" : " (" + failure_mode + ")"));
+    bool result = fault == TachFault::NONE ? it->second->makeBad() : it->second->makeBad(fault);
     if (!result) {
         logger_->error("Failed to make fan bad: " + name);
     }
@@ -248,7 +448,9 @@ bool FanSimulator::initialize() {
  * @brief Loads fan models from configuration
  * 
  * Parses the YAML configuration to load fan models with their properties
- * including PWM ranges, duty cycle ranges, and noise profiles.
+ * including PWM ranges, duty cycle ranges, and noise profiles. A model whose
+ * PWM range is reversed or negative, or whose duty cycle range is reversed or
+ * outside 0-100, fails the load.
  * 
  * @return true if all models were loaded successfully, false otherwise
  */
@@ -266,12 +468,26 @@ bool FanSimulator::load_fan_models() {
             fan_model.interface = model.second["Interface"].as<std::string>();
             fan_model.pwm_reg = model.second["PWM_REG"].as<uint8_t>();
 
+            // The conversion tables in Fan are indexed by these ranges
+            if (fan_model.pwm_min < 0 || fan_model.pwm_max < fan_model.pwm_min) {
+                std::cerr << "Invalid PWMRange " << fan_model.pwm_min << "-" << fan_model.pwm_max
+                          << " for fan model " << fan_model.name << std::endl;
+                return false;
+            }
+            if (fan_model.duty_cycle_min < 0 || fan_model.duty_cycle_max > 100 ||
+                fan_model.duty_cycle_max < fan_model.duty_cycle_min) {
+                std::cerr << "Invalid DutyCycleRange " << fan_model.duty_cycle_min << "-" << fan_model.duty_cycle_max
+                          << " for fan model " << fan_model.name << std::endl;
+                return false;
+            }
+
             // Load noise profile
             for (const auto& profile : model.second["NoiseProfile"]) {
                 int duty_cycle = profile["DutyCycle"].as<int>();
                 int noise_level = profile["NoiseLevel_dB"].as<int>();
                 fan_model.noise_profile[duty_cycle] = noise_level;
             }
+            fan_model.tach = TachModel::fromConfig(model.second["Tach"]);
 
             fan_models_[fan_model.name] = fan_model;
             logger_->debug("Loaded fan model: " + fan_model.name);
@@ -296,10 +512,60 @@ bool FanSimulator::create_fans() {
         const auto& controllers = config_["FanControllers"];
         const auto max_fan_controllers = config_["MaxFanControllers"].as<int>();
         fans_too_loud_threshold_ = config_["FansTooLoudAlarm"].as<int>();
+
+        // Emergency cooling settings are optional
+        const auto& emergency = config_["EmergencyCooling"];
+        if (emergency) {
+            if (emergency["HoldMs"]) emergency_hold_ = std::chrono::milliseconds(emergency["HoldMs"].as<int>());
+            if (emergency["IncreaseStepPercent"]) emergency_step_ = emergency["IncreaseStepPercent"].as<int>();
+        }
+
+        // Actuator settings are optional
+        const auto& actuator = config_["Actuator"];
+        if (actuator && actuator["TickMs"]) {
+            actuator_tick_ = std::chrono::milliseconds(actuator["TickMs"].as<int>());
+        }
+
+        // Allocation is optional; without it all fans run at the control loop speed
+        const auto& allocation = config_["FanAllocation"];
+        if (allocation) {
+            if (allocation["Mode"]) {
+                std::string mode = allocation["Mode"].as<std::string>();
+                if (!parseFanAllocationMode(mode, allocation_mode_)) {
+                    logger_->warning("Unknown fan allocation mode " + mode + ", using Equal");
+                }
+            }
+            if (allocation["MinDutyPercent"]) allocation_min_duty_ = allocation["MinDutyPercent"].as<int>();
+        }
+
+        // Tachometers are optional; without them fan failures are only reported by MakeFanBad
+        tach_settings_ = TachSettings::fromConfig(config_["Tachometer"]);
+        if (tach_settings_.enabled) {
+            auto confirm_ms = tach_settings_.sample_interval * tach_settings_.fault_confirm_samples;
+            const auto& temp_monitor = config_["TemperatureMonitor"];
+            if (temp_monitor && temp_monitor["UpdateIntervalMs"] &&
+                confirm_ms.count() > temp_monitor["UpdateIntervalMs"].as<int>()) {
+                logger_->warning("Tachometer fault detection takes " + std::to_string(confirm_ms.count()) +
+                                 " ms, longer than one control period");
+            }
+        }
+
+        // Register bank is optional; without it register accesses are only simulated
+        const auto& register_config = config_["RegisterBank"];
+        if (register_config) {
+            register_bank_ = RegisterBank::create(register_config);
+            if (!register_bank_ || !register_bank_->open()) {
+                logger_->error("Failed to open fan register bank");
+                return false;
+            }
+            logger_->info("Fan registers on " + register_bank_->describe());
+        }
+
         if (controllers.size() > max_fan_controllers) {
             logger_->error("Max fan controllers exceeded: " + std::to_string(controllers.size()) + " > " + std::to_string(max_fan_controllers));
         }
         int fan_count = 0;
+        std::map<uint32_t, std::string> register_owners;
         for (const auto& controller : controllers) {
             const auto& name = controller.first.as<std::string>();
             const auto& model_name = controller.second["Model"].as<std::string>();
@@ -316,6 +582,27 @@ bool FanSimulator::create_fans() {
                                            , model_it->second.pwm_min, model_it->second.pwm_max
                                            , model_it->second.duty_cycle_min, model_it->second.duty_cycle_max
                                            , model_it->second.noise_profile);
+            if (register_bank_) {
+                // Default layout: one 32-bit register per fan in configuration order
+                uint32_t offset = controller.second["RegisterOffset"] ? controller.second["RegisterOffset"].as<uint32_t>()
+                                                                      : static_cast<uint32_t>(fan_count) * 4;
+                // Two fans sharing register bytes would overwrite each other's speed
+                for (const auto& owner : register_owners) {
+                    if (owner.first < offset + 4 && offset < owner.first + 4) {
+                        logger_->error("PWM register of " + name + " at offset " + std::to_string(offset) +
+                                       " overlaps the one of " + owner.second + " at offset " + std::to_string(owner.first));
+                        return false;
+                    }
+                }
+                register_owners[offset] = name;
+                if (!fan->attachRegisterBank(register_bank_, offset)) {
+                    logger_->error("Cannot access PWM register of " + name + " at offset " + std::to_string(offset));
+                    return false;
+                }
+            }
+            if (tach_settings_.enabled) {
+                fan->attachTachometer(model_it->second.tach, tach_settings_);
+            }
             fans_[name] = fan;
             logger_->debug("Created fan instance: " + name + " (Model: " + model_name + ")");
             if (fan_count >= max_fan_controllers) {
@@ -332,89 +619,204 @@ bool FanSimulator::create_fans() {
 }
 
 /**
- * @brief Converts duty cycle to PWM count for a fan model
+ * @brief Accounts written speed changes for noise exposure and the "too_loud" alarm
  * 
- * @param model Name of the fan model
- * @param duty_cycle Duty cycle percentage
- * @return Corresponding PWM count value
+ * Called by the register writer after every batch, so nothing polls the
+ * fans. Fans above MODERATE noise make the system loud; the transition to
+ * loud arms a one-shot timer that raises "too_loud" after FansTooLoudAlarm
+ * minutes, and the transition back cancels it and clears the alarm. The
+ * timer resets its id once it has fired; cancel() waits for a running
+ * callback, so that reset never hides a newer timer.
+ * 
+ * @param writes Fan speeds that were applied; only written ones are accounted
  */
-int FanSimulator::duty_cycle_to_pwm(const std::string& model, int duty_cycle) const {
-    auto it = fan_models_.find(model);
-    if (it == fan_models_.end()) {
-        return -1;
+void FanSimulator::account_noise(const std::vector<FanWrite>& writes) {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& write : writes) {
+        if (write.written) {
+            dosimeter_->record(write.slot, write.fan->noiseLevelAt(write.duty_cycle), now);
+        }
     }
 
-    const auto& fan_model = it->second;
-    duty_cycle = std::max(fan_model.duty_cycle_min, std::min(duty_cycle, fan_model.duty_cycle_max));
-    
-    // Linear interpolation
-    double ratio = static_cast<double>(duty_cycle - fan_model.duty_cycle_min) /
-                  (fan_model.duty_cycle_max - fan_model.duty_cycle_min);
-    return fan_model.pwm_min + static_cast<int>(ratio * (fan_model.pwm_max - fan_model.pwm_min));
+    bool noise_condition = false;
+    for (const Fan* fan : fan_slots_) {
+        if (fan->noiseLevelAt(fan->getDutyCycle()) > static_cast<int>(NoiseLevel::MODERATE)) {
+            noise_condition = true;
+            break;
+        }
+    }
+    if (noise_condition == is_it_loud_) {
+        return;
+    }
+    is_it_loud_ = noise_condition;
+    if (noise_condition) {
+        loud_timer_ = common::TimerWheel::getInstance().scheduleOnce(
+            std::chrono::minutes(fans_too_loud_threshold_), [this]() {
+                loud_timer_ = 0;
+                logger_->warning("Fans are too loud for " + std::to_string(fans_too_loud_threshold_) + " minutes");
+                alarm_->raise("too_loud", common::AlarmSeverity::ERROR, "Fans are too loud");
+            });
+        return;
+    }
+    common::TimerWheel::getInstance().cancel(loud_timer_.exchange(0));
+    alarm_->clear("too_loud", "Fan noise back to acceptable level");
 }
 
 /**
- * @brief Converts PWM count to duty cycle for a fan model
+ * @brief Samples every fan's tachometer
  * 
- * @param model Name of the fan model
- * @param pwm PWM count value
- * @return Corresponding duty cycle percentage
+ * Runs on the timer wheel every Tachometer.SampleIntervalMs. A fan whose
+ * samples confirm a fault marks itself bad and raises its "tach_fault" alarm.
  */
-int FanSimulator::pwm_to_duty_cycle(const std::string& model, int pwm) const {
-    auto it = fan_models_.find(model);
-    if (it == fan_models_.end()) {
-        return -1;
+void FanSimulator::sample_tachometers() {
+    auto now = std::chrono::steady_clock::now();
+    int64_t timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (Fan* fan : fan_slots_) {
+        if (fan->sampleTachometer(now, timestamp_ms)) {
+            logger_->error("Fan failure detected from tachometer feedback: " + fan->getName());
+        }
     }
+}
 
-    const auto& fan_model = it->second;
-    pwm = std::max(fan_model.pwm_min, std::min(pwm, fan_model.pwm_max));
-    
-    // Linear interpolation
-    double ratio = static_cast<double>(pwm - fan_model.pwm_min) /
-                  (fan_model.pwm_max - fan_model.pwm_min);
-    return fan_model.duty_cycle_min + static_cast<int>(ratio * (fan_model.duty_cycle_max - fan_model.duty_cycle_min));
+/**
+ * @brief Gets the most recent tachometer samples of a fan
+ * 
+ * @param fan_name Name of the fan
+ * @param max_samples Maximum number of samples, 0 for all kept
+ * @param samples Samples, oldest first
+ * @return true if the fan exists and has a tachometer, false otherwise
+ */
+bool FanSimulator::get_rpm_history(const std::string& fan_name, size_t max_samples,
+                                   std::vector<TachSample>& samples) const {
+    auto it = fans_.find(fan_name);
+    if (it == fans_.end() || !it->second->getTachometer()) {
+        return false;
+    }
+    samples = it->second->getTachometer()->getHistory(max_samples);
+    return true;
 }
 
-void FanSimulator::check_noise_condition() {
-    // Check for noise conditions
-    bool noise_condition = false;
-    for (auto& fan : fans_) {
-        int noise_level = get_noise_level(fan.second->getModelName(), fan.second->getDutyCycle());
-        if (noise_level > static_cast<int>(NoiseLevel::MODERATE)) {
-            noise_condition = true;
-        }
+/**
+ * @brief Sets the PWM count of a specific fan as a manual override
+ * 
+ * @param fan_name Name of the fan
+ * @param pwm_count PWM count to write
+ * @return true if the command was queued, false otherwise
+ */
+bool FanSimulator::set_fan_pwm(const std::string& fan_name, int pwm_count) {
+    auto it = fan_index_.find(fan_name);
+    if (it == fan_index_.end()) {
+        logger_->warning("Attempted to set PWM for non-existent fan: " + fan_name);
+        return false;
     }
-    if (noise_condition && !is_it_loud_) {
-        last_loud_noise_start_time_ = std::chrono::system_clock::now();
-        is_it_loud_ = true;
-    } else if (!noise_condition && is_it_loud_) {
-        is_it_loud_ = false;
+    if (pwm_count < 0) {
+        logger_->warning("Invalid pwm count value: " + std::to_string(pwm_count));
+        return false;
+    }
+    Fan* fan = fan_slots_[it->second];
+    if (fan->getHealth() == FanHealth::BAD) {
+        logger_->warning("Cannot set PWM - fan " + fan_name + " is in bad state");
+        return false;
     }
-    if (is_it_loud_ && std::chrono::system_clock::now() - last_loud_noise_start_time_ > std::chrono::minutes(fans_too_loud_threshold_)) {
-        logger_->warning("Fans are too loud for " + std::to_string(fans_too_loud_threshold_) + " minutes");
-        alarm_->raise(common::AlarmSeverity::HIGH, "Fans are too loud");
-        is_it_loud_ = false; //reset the flag to avoid raising the alarm again for the same noise condition
+    ActuatorCommand command;
+    command.fan = it->second;
+    command.source = CommandSource::MANUAL;
+    command.duty_cycle = fan->pwmToDutyCycle(pwm_count);
+    command.pwm_count = pwm_count;
+    std::vector<ActuatorCommand> commands{command};
+    return submit_and_wait(commands) && commands[0].written;
+}
+
+/**
+ * @brief Writes all queued speed commands now instead of on the next actuator tick
+ * 
+ * @return true if every command submitted so far has been processed
+ */
+bool FanSimulator::flush_actuation() {
+    return actuator_->flush();
+}
+
+/**
+ * @brief Gets the command and register write counters of a fan
+ * 
+ * @param fan_name Name of the fan
+ * @return Counters, all zero if the fan is unknown
+ */
+ActuatorFanStats FanSimulator::get_actuator_stats(const std::string& fan_name) const {
+    auto it = fan_index_.find(fan_name);
+    return it != fan_index_.end() ? actuator_->get_stats(it->second) : ActuatorFanStats();
+}
+
+/**
+ * @brief Gets the counters of the actuation shaper
+ * 
+ * @return Counters summed over all fans, all zero if the shaper is disabled
+ */
+ActuationShaperStats FanSimulator::get_shaper_stats() const {
+    std::lock_guard<std::mutex> lock(shaper_mutex_);
+    return shaper_->stats();
+}
+
+/**
+ * @brief Gets the speed the actuation shaper has the fans at
+ * 
+ * Averages the last duty cycle the shaper stepped or synced each fan to,
+ * which is where the fans are headed once the actuator has written them.
+ * 
+ * @return Mean duty cycle over the fans with a known speed, -1 if there are none
+ */
+int FanSimulator::get_shaped_speed() const {
+    std::lock_guard<std::mutex> lock(shaper_mutex_);
+    int sum = 0;
+    int known = 0;
+    for (size_t i = 0; i < fan_slots_.size(); ++i) {
+        int output = shaper_->output(i);
+        if (output >= 0) {
+            sum += output;
+            ++known;
+        }
     }
+    return known > 0 ? (sum + known / 2) / known : -1;
 }
 
-void FanSimulator::main_thread_function() {
-    logger_->info("Fan Simulator main thread started");
-    while (running_) {
-        check_noise_condition();
-        // Process fan speed updates and send MQTT messages
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+/**
+ * @brief Gets the combined noise of all fans at their current speeds
+ * 
+ * @return Noise level in dB, fan levels summed in the power domain
+ */
+double FanSimulator::get_total_noise_db() const {
+    std::vector<int> levels;
+    levels.reserve(fan_slots_.size());
+    for (const Fan* fan : fan_slots_) {
+        levels.push_back(fan->noiseLevelAt(fan->getDutyCycle()));
     }
-    logger_->info("Fan Simulator main thread stopped");
+    return sumNoiseDb(levels);
 }
 
-bool FanSimulator::set_fan_pwm(const std::string& fan_name, int pwm_count) {
-    auto it = fans_.find(fan_name);
-    if (it == fans_.end()) {
-        logger_->warning("Attempted to set PWM for non-existent fan: " + fan_name);
+/**
+ * @brief Gets the noise exposure of a fan
+ * 
+ * @param fan_name Name of the fan
+ * @param exposure Current level and rolling windows
+ * @return true if the fan exists, false otherwise
+ */
+bool FanSimulator::get_noise_exposure(const std::string& fan_name, NoiseExposure& exposure) const {
+    auto it = fan_index_.find(fan_name);
+    if (it == fan_index_.end()) {
         return false;
     }
-    int duty_cycle = pwm_to_duty_cycle(it->second->getModelName(), pwm_count);
-    return it->second->setPwmCount(duty_cycle, pwm_count);
+    exposure = dosimeter_->fanExposure(it->second, std::chrono::steady_clock::now());
+    return true;
+}
+
+/**
+ * @brief Gets the noise exposure of all fans combined
+ * 
+ * @return Current level and rolling windows
+ */
+NoiseExposure FanSimulator::get_combined_noise_exposure() const {
+    return dosimeter_->combinedExposure(std::chrono::steady_clock::now());
 }
 
 int FanSimulator::get_fan_noise_level(const std::string& fan_name) const {
@@ -450,4 +852,344 @@ std::string FanSimulator::get_fan_noise_category(const std::string& fan_name) co
     }
 }
 
-} // namespace fan_control_system 
\ No newline at end of file
+/**
+ * @brief Drives every fan to its maximum duty cycle immediately
+ * 
+ * Registered as the MaxFanSpeed alarm action. Bypasses the temperature
+ * monitor's control tick: the registers are written from the calling thread
+ * and the speed is then held as a floor for the configured hold time.
+ * 
+ * @param reason Reason logged with the change
+ * @return true if all fans were written successfully, false otherwise
+ */
+bool FanSimulator::max_fan_speed(const std::string& reason) {
+    return apply_speed_floor(100, reason);
+}
+
+/**
+ * @brief Raises every fan by the configured step immediately
+ * 
+ * Registered as the IncreaseFanSpeed alarm action. The step is applied to the
+ * fastest fan so that all fans end up at least at that speed plus the step.
+ * 
+ * @param reason Reason logged with the change
+ * @return true if all fans were written successfully, false otherwise
+ */
+bool FanSimulator::increase_fan_speed(const std::string& reason) {
+    int fastest = 0;
+    for (const auto& fan : fans_) {
+        fastest = std::max(fastest, fan.second->getDutyCycle());
+    }
+    return apply_speed_floor(std::min(100, fastest + emergency_step_), reason);
+}
+
+/**
+ * @brief Removes the emergency speed floor
+ */
+void FanSimulator::clear_speed_floor() {
+    speed_floor_ = 0;
+    speed_floor_until_ms_ = 0;
+}
+
+/**
+ * @brief Gets the emergency speed floor
+ * 
+ * @return Active floor duty cycle, 0 if none or expired
+ */
+int FanSimulator::get_speed_floor() const {
+    int floor = speed_floor_.load();
+    if (floor == 0) {
+        return 0;
+    }
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return now_ms < speed_floor_until_ms_.load() ? floor : 0;
+}
+
+/**
+ * @brief Raises the emergency speed floor and writes it to every slower fan
+ * 
+ * The floor only ever rises while it is active; each call extends the hold
+ * time. Fans already at or above the floor are left untouched. The writes
+ * are submitted as EMERGENCY commands, which the actuator queue writes on
+ * this thread before submit() returns, together with anything else pending.
+ * Ramps of the actuation shaper are cancelled, so no ramp step is queued
+ * below the floor.
+ * 
+ * @param duty_cycle New floor duty cycle
+ * @param reason Reason logged with the change
+ * @return true if all fans were written successfully, false otherwise
+ */
+bool FanSimulator::apply_speed_floor(int duty_cycle, const std::string& reason) {
+    int floor = std::max(duty_cycle, get_speed_floor());
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    speed_floor_until_ms_ = now_ms + emergency_hold_.count();
+    speed_floor_ = floor;
+
+    std::vector<ActuatorCommand> commands;
+    commands.reserve(fan_slots_.size());
+    for (size_t i = 0; i < fan_slots_.size(); ++i) {
+        if (fan_slots_[i]->getDutyCycle() >= floor) {
+            continue;
+        }
+        ActuatorCommand command;
+        command.fan = i;
+        command.source = CommandSource::EMERGENCY;
+        command.duty_cycle = floor;
+        commands.push_back(command);
+    }
+
+    if (shaper_->settings().enabled) {
+        std::lock_guard<std::mutex> lock(shaper_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < fan_slots_.size(); ++i) {
+            shaper_->sync(i, std::max(floor, fan_slots_[i]->getDutyCycle()), now);
+        }
+    }
+
+    bool all_written = true;
+    if (!commands.empty()) {
+        uint64_t ticket = actuator_->submit(commands);
+        all_written = actuator_->wait_applied(ticket, std::chrono::milliseconds(1000));
+        for (const auto& command : commands) {
+            if (fan_slots_[command.fan]->getDutyCycle() < floor) {
+                logger_->error("Failed to apply emergency fan speed to " + fan_slots_[command.fan]->getName());
+                all_written = false;
+            }
+        }
+    }
+    logger_->warning("Emergency fan speed " + std::to_string(floor) + "% held for " +
+                     std::to_string(emergency_hold_.count()) + " ms (alarm: " + reason + ")");
+    return all_written;
+}
+
+/**
+ * @brief Writes a batch of queued commands
+ * 
+ * Called by the actuator queue, one batch at a time. Duty cycles below an
+ * active emergency floor are raised to it, all commands are written with
+ * write_fans(), the changes are accounted for noise exposure and one
+ * combined status is published. Each fan then raises or clears its
+ * "i2c_write" alarm from the outcome of its register write, and every
+ * written fan publishes its own status.
+ * 
+ * @param commands Commands taken from the queue; their written flags are updated
+ */
+void FanSimulator::apply_commands(std::vector<ActuatorCommand>& commands) {
+    int floor = get_speed_floor();
+    std::vector<FanWrite> writes;
+    writes.reserve(commands.size());
+    for (const auto& command : commands) {
+        Fan* fan = fan_slots_[command.fan];
+        int duty_cycle = command.duty_cycle;
+        int pwm_count = command.pwm_count >= 0 ? command.pwm_count : fan->dutyCycleToPwm(duty_cycle);
+        if (duty_cycle < floor) {
+            duty_cycle = floor;
+            pwm_count = fan->dutyCycleToPwm(floor);
+        }
+        writes.push_back({command.fan, fan, duty_cycle, pwm_count});
+    }
+
+    int64_t skew_ns = write_fans(writes);
+    account_noise(writes);
+    publish_fans_status(writes, skew_ns);
+    for (size_t i = 0; i < writes.size(); ++i) {
+        commands[i].written = writes[i].written;
+        if (writes[i].attempted) {
+            writes[i].fan->reportPwmWrite(writes[i].written);
+        }
+        if (writes[i].written) {
+            writes[i].fan->publishStatus();
+        } else {
+            logger_->error("Failed to set fan speed for " + writes[i].fan->getName());
+        }
+    }
+    logger_->info("Fan speeds written to " + std::to_string(writes.size()) + " fans (write skew " +
+                  std::to_string(skew_ns / 1000) + " us)");
+}
+
+/**
+ * @brief Queues a duty cycle for every fan
+ * 
+ * @param duty_cycle Duty cycle to apply
+ * @param source Origin of the command
+ * @return Queue ticket, 0 if nothing was queued
+ */
+uint64_t FanSimulator::submit_all(int duty_cycle, CommandSource source) {
+    std::vector<ActuatorCommand> commands(fan_slots_.size());
+    for (size_t i = 0; i < commands.size(); ++i) {
+        commands[i].fan = i;
+        commands[i].source = source;
+        commands[i].duty_cycle = duty_cycle;
+    }
+    return submit_unshaped(commands);
+}
+
+/**
+ * @brief Queues commands past the shaper and records their speeds in it
+ * 
+ * The shaper then ramps on from the speed the fans are actually set to
+ * (raised to an active emergency floor) and drops the targets it had.
+ * 
+ * @param commands Commands to queue
+ * @param report Keep the outcome of each command for ActuatorQueue::wait_applied()
+ * @return Queue ticket, 0 if a fan index is invalid
+ */
+uint64_t FanSimulator::submit_unshaped(const std::vector<ActuatorCommand>& commands, bool report) {
+    if (!shaper_->settings().enabled) {
+        return actuator_->submit(commands, report);
+    }
+    std::lock_guard<std::mutex> lock(shaper_mutex_);
+    auto now = std::chrono::steady_clock::now();
+    int floor = get_speed_floor();
+    for (const auto& command : commands) {
+        shaper_->sync(command.fan, std::max(command.duty_cycle, floor), now);
+    }
+    return actuator_->submit(commands, report);
+}
+
+/**
+ * @brief Queues manual commands past the shaper and waits until they are processed
+ * 
+ * A command superseded by a higher-priority one, or skipped because its fan
+ * is bad, comes back with its written flag cleared.
+ * 
+ * @param commands Commands to queue; their written flags are updated
+ * @return true if the commands were processed within a second, false otherwise
+ */
+bool FanSimulator::submit_and_wait(std::vector<ActuatorCommand>& commands) {
+    uint64_t ticket = submit_unshaped(commands, true);
+    if (ticket == 0) {
+        return false;
+    }
+    return actuator_->wait_applied(ticket, std::chrono::milliseconds(1000), &commands);
+}
+
+/**
+ * @brief Queues the next ramp steps of the shaper
+ * 
+ * Runs on the timer wheel every Actuator.Shaper.RampIntervalMs. Holding the
+ * shaper mutex while submitting keeps ramp steps and new targets in order.
+ */
+void FanSimulator::step_shaper() {
+    std::lock_guard<std::mutex> lock(shaper_mutex_);
+    if (!shaper_->pending()) {
+        return;
+    }
+    std::vector<ActuatorCommand> commands;
+    shaper_->step(std::chrono::steady_clock::now(), commands);
+    if (!commands.empty()) {
+        actuator_->submit(commands);
+    }
+}
+
+/**
+ * @brief Writes a set of fan speeds with as little skew between fans as possible
+ * 
+ * All register values are prepared before the first write. Fans are grouped
+ * by register bank, i.e. by bus, and each group is written with one
+ * RegisterBank::write_batch() call; fans without a bank use the simulated
+ * write. The cached fan state is updated after the last register was
+ * written, and nothing is logged or published in between.
+ * 
+ * @param writes Fan speeds to apply; their written flags are updated
+ * @return Time from the first to the last register write in nanoseconds
+ */
+int64_t FanSimulator::write_fans(std::vector<FanWrite>& writes) {
+    std::map<RegisterBank*, std::vector<size_t>> by_bank;
+    std::vector<size_t> simulated;
+    for (size_t i = 0; i < writes.size(); ++i) {
+        writes[i].attempted = false;
+        writes[i].written = false;
+        if (writes[i].fan->getHealth() == FanHealth::BAD || writes[i].pwm_count < 0) {
+            continue;
+        }
+        writes[i].attempted = true;
+        RegisterBank* bank = writes[i].fan->getRegisterBank().get();
+        if (bank) {
+            by_bank[bank].push_back(i);
+        } else {
+            simulated.push_back(i);
+        }
+    }
+    std::vector<std::vector<RegisterWrite>> transactions;
+    transactions.reserve(by_bank.size());
+    for (const auto& group : by_bank) {
+        transactions.emplace_back();
+        for (size_t index : group.second) {
+            RegisterWrite write;
+            write.address = writes[index].fan->getRegisterAddress();
+            write.value = static_cast<uint32_t>(writes[index].pwm_count);
+            transactions.back().push_back(write);
+        }
+    }
+
+    auto first = std::chrono::steady_clock::now();
+    size_t transaction = 0;
+    for (const auto& group : by_bank) {
+        group.first->write_batch(transactions[transaction++]);
+    }
+    for (size_t index : simulated) {
+        writes[index].written = writes[index].fan->setPwmCountUrgent(writes[index].duty_cycle, writes[index].pwm_count);
+    }
+    auto last = std::chrono::steady_clock::now();
+
+    transaction = 0;
+    for (const auto& group : by_bank) {
+        const auto& registers = transactions[transaction++];
+        for (size_t i = 0; i < group.second.size(); ++i) {
+            FanWrite& write = writes[group.second[i]];
+            write.written = registers[i].written;
+            if (write.written) {
+                write.fan->recordPwmCount(write.duty_cycle, write.pwm_count);
+            }
+        }
+    }
+
+    int64_t skew_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(last - first).count();
+    last_write_skew_ns_ = skew_ns;
+    return skew_ns;
+}
+
+/**
+ * @brief Publishes the outcome of a batched speed change as one status message
+ * 
+ * Published on "fan_simulator/status" with the new state of every written
+ * fan, the fans that failed, the write skew of the batch and the combined
+ * noise level, last-minute Leq and shift dose.
+ * 
+ * @param writes Fan speeds that were applied
+ * @param skew_ns Time from the first to the last register write in nanoseconds
+ */
+void FanSimulator::publish_fans_status(const std::vector<FanWrite>& writes, int64_t skew_ns) {
+    json fans = json::array();
+    json failed = json::array();
+    for (const auto& write : writes) {
+        if (!write.written) {
+            failed.push_back(write.fan->getName());
+            continue;
+        }
+        fans.push_back({
+            {"name", write.fan->getName()},
+            {"model", write.fan->getModelName()},
+            {"status", write.fan->getStatus()},
+            {"pwm_count", write.pwm_count},
+            {"duty_cycle", write.duty_cycle},
+            {"noise_level", write.fan->getNoiseLevel()}
+        });
+    }
+    NoiseExposure exposure = dosimeter_->combinedExposure(std::chrono::steady_clock::now());
+    json status_data = {
+        {"fans", fans},
+        {"failed", failed},
+        {"write_skew_us", skew_ns / 1000.0},
+        {"noise_db", exposure.level_db},
+        {"noise_leq_1min_db", exposure.minute.leq_db},
+        {"noise_dose_shift_percent", exposure.shift.dose_percent},
+        {"timestamp", common::utils::formatTimestamp(std::chrono::system_clock::now())}
+    };
+    mqtt_client_->publish("fan_simulator/status", status_data.dump());
+}
+
+} // namespace fan_control_system
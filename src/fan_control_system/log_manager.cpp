@@ -1,4 +1,5 @@
 #include "fan_control_system/log_manager.hpp"
+#include <cstring>
 #include <iostream>
 #include <stdexcept>
 #include <experimental/filesystem>
@@ -20,11 +21,16 @@ namespace fan_control_system {
  * @param mqtt_settings MQTT client settings for publishing logs
  */
 LogManager::LogManager(const YAML::Node& config, const common::MQTTClient::Settings& mqtt_settings)
-    : config_(config), mqtt_settings_(mqtt_settings), current_log_size_(0) {
+    : config_(config), mqtt_settings_(mqtt_settings), current_log_size_(0), reported_drops_(0) {
     log_file_path_ = config_["Logging"]["FilePath"].as<std::string>();
     log_file_base_name_ = config_["Logging"]["FileName"].as<std::string>();
     max_log_size_bytes_ = static_cast<size_t>(config_["Logging"]["MaxFileSizeMB"].as<double>() * 1024 * 1024);
     max_log_files_ = config_["Logging"]["MaxFiles"].as<size_t>();
+    size_t queue_capacity = 4096;
+    if (config_["Logging"]["QueueCapacity"]) {
+        queue_capacity = config_["Logging"]["QueueCapacity"].as<size_t>();
+    }
+    log_queue_ = std::make_unique<common::MPSCRing<LogEntry>>(queue_capacity);
     name_ = "LogManager";
 }
 
@@ -72,7 +78,10 @@ void LogManager::stop() {
     }
 
     running_ = false;
-    queue_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        queue_cv_.notify_all();
+    }
     if (main_thread_.joinable()) {
         main_thread_.join();
     }
@@ -82,11 +91,72 @@ void LogManager::stop() {
  * @brief Adds a log entry to the processing queue
  * 
  * @param entry Log entry to be processed and written to the log file
+ * @return true if the entry was queued, false if the queue was full
+ */
+bool LogManager::add_log(const LogEntry& entry) {
+    return add_log(LogEntry(entry));
+}
+
+/**
+ * @brief Moves a log entry into the processing queue
+ * 
+ * Never blocks: if the queue is full the entry is dropped and counted.
+ * The writer thread is only signalled when it is actually asleep.
+ * 
+ * @param entry Log entry to be processed and written to the log file
+ * @return true if the entry was queued, false if the queue was full
  */
-void LogManager::add_log(const LogEntry& entry) {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    log_queue_.push(entry);
-    queue_cv_.notify_one();
+bool LogManager::add_log(LogEntry&& entry) {
+    if (!log_queue_->tryPush(std::move(entry))) {
+        return false;
+    }
+    notify_consumer();
+    return true;
+}
+
+/**
+ * @brief Gets the current log queue counters
+ * 
+ * @return Snapshot of queue capacity, depth, high-water mark and counters
+ */
+LogQueueStats LogManager::get_queue_stats() const {
+    LogQueueStats stats;
+    stats.capacity = log_queue_->capacity();
+    stats.depth = log_queue_->size();
+    stats.high_water = log_queue_->highWater();
+    stats.enqueued = log_queue_->enqueued();
+    stats.dropped = log_queue_->dropped();
+    return stats;
+}
+
+/**
+ * @brief Sets the minimum level written to the log file
+ * 
+ * Takes effect for the next message received; safe to call from any thread.
+ * 
+ * @param level New file log level
+ */
+void LogManager::set_file_log_level(common::LogLevel level) {
+    log_level_.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the minimum level written to the log file
+ * 
+ * @return Current file log level
+ */
+common::LogLevel LogManager::get_file_log_level() const {
+    return log_level_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Wakes the writer thread if it is waiting for entries
+ */
+void LogManager::notify_consumer() {
+    if (consumer_waiting_.load()) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        queue_cv_.notify_one();
+    }
 }
 
 /**
@@ -109,23 +179,16 @@ bool LogManager::initialize() {
     logger_ = std::make_unique<common::Logger>(name_, log_level, mqtt_client_);
     logger_->info("Log Manager initialized successfully");
 
-    // Subscribe to log topics
+    // Subscribe to log topics and to file level requests of other processes
     mqtt_client_->subscribe("logs/#", 0);
+    mqtt_client_->subscribe(common::Logger::fileLevelTopic(), 0);
     mqtt_client_->set_message_callback(&LogManager::mqtt_message_callback, this);
 
     // Get log level from config
     std::string log_level_str = config_["Logging"]["Level"].as<std::string>();
-    if (log_level_str == "DEBUG") {
-        log_level_ = common::LogLevel::DEBUG;
-    } else if (log_level_str == "INFO") {
-        log_level_ = common::LogLevel::INFO;
-    } else if (log_level_str == "WARNING") {
-        log_level_ = common::LogLevel::WARNING;
-    } else if (log_level_str == "ERROR") {
-        log_level_ = common::LogLevel::ERROR;
-    } else {
-        log_level_ = common::LogLevel::INFO;
-    }
+    common::LogLevel file_level = common::LogLevel::INFO;
+    common::Logger::parseLevel(log_level_str, file_level);
+    set_file_log_level(file_level);
 
     return true;
 }
@@ -225,7 +288,8 @@ bool LogManager::rotate_log_file() {
 /**
  * @brief Writes a log entry to the log file
  * 
- * Formats the log entry as JSON and writes it to the file.
+ * Formats the log entry as JSON and writes it to the file. The file size is
+ * tracked from the bytes written; flushing is left to the batch drain.
  * Rotates the log file if the size limit is reached.
  * 
  * @param entry Log entry to be written
@@ -240,17 +304,10 @@ void LogManager::write_log_entry(const LogEntry& entry) {
 
     std::string log_line = log_json.dump() + "\n";
     log_file_ << log_line;
-    log_file_.flush();
+    current_log_size_ += log_line.size();
 
-    // Get the actual file size from the filesystem
-    fs::path full_path = fs::path(log_file_path_) / log_file_base_name_;
-    if (fs::exists(full_path)) {
-        current_log_size_ = fs::file_size(full_path);
-    } else {
-        current_log_size_ = 0;
-    }
-    
     if (current_log_size_ >= max_log_size_bytes_) {
+        log_file_.flush();
         rotate_log_file();
     }
 }
@@ -259,7 +316,8 @@ void LogManager::write_log_entry(const LogEntry& entry) {
  * @brief Callback function for MQTT messages
  * 
  * Processes incoming log messages from MQTT and adds them to the log queue
- * if they meet the configured log level.
+ * if they meet the configured log level. File level requests are passed to
+ * apply_file_level_request().
  * 
  * @param mosq Mosquitto instance
  * @param obj User data (LogManager instance)
@@ -273,13 +331,19 @@ void LogManager::mqtt_message_callback(
         return;
     }
 
+    if (std::strcmp(msg->topic, common::Logger::fileLevelTopic()) == 0) {
+        manager->apply_file_level_request(
+            msg->payloadlen > 0 ? std::string(static_cast<const char*>(msg->payload), msg->payloadlen) : std::string());
+        return;
+    }
+
     try {
         auto json = nlohmann::json::parse(static_cast<const char*>(msg->payload));
         
         // Convert numeric level to string
         std::string level_str;
         int level_num = json["level"].get<int>();
-        if (level_num < static_cast<int>(manager->log_level_)) {
+        if (level_num < static_cast<int>(manager->get_file_log_level())) {
             // If the level is less than the log level configured, don't process the message or log to log file.
             return;
         }
@@ -307,35 +371,83 @@ void LogManager::mqtt_message_callback(
             level_str,  // Use the converted string level
             json["source"],
             json["message"],
-            json  // Use entire JSON as metadata
+            std::move(json)  // Use entire JSON as metadata
         };
-        manager->add_log(entry);
+        manager->add_log(std::move(entry));
     } catch (const std::exception& e) {
         std::cerr << "Error processing MQTT message: " << e.what() << std::endl;
     }
 }
 
+/**
+ * @brief Lowers the file level when another process asks for it
+ * 
+ * Other processes publish the lowest level their loggers were set to on
+ * common::Logger::fileLevelTopic(), since this process owns the log file.
+ * The file level is only ever lowered here, so such a request cannot hide
+ * messages of this process.
+ * 
+ * @param level_name Requested level name, empty for no request
+ */
+void LogManager::apply_file_level_request(const std::string& level_name) {
+    common::LogLevel level;
+    if (level_name.empty() || !common::Logger::parseLevel(level_name, level)) {
+        return;
+    }
+    if (level < get_file_log_level()) {
+        set_file_log_level(level);
+        logger_->info("Log file level lowered to " + level_name + " on request of another process");
+    }
+}
+
+/**
+ * @brief Writes every queued entry and flushes the log file once
+ * 
+ * Reports newly dropped entries so that queue overflow is visible in the logs.
+ * 
+ * @return Number of entries written
+ */
+size_t LogManager::drain_queue() {
+    size_t written = log_queue_->drain([this](LogEntry& entry) {
+        write_log_entry(entry);
+        entry = LogEntry();
+    });
+    if (written > 0) {
+        log_file_.flush();
+    }
+
+    uint64_t dropped = log_queue_->dropped();
+    if (dropped != reported_drops_) {
+        logger_->warning("Log queue full, dropped " + std::to_string(dropped - reported_drops_) +
+                         " entries (total " + std::to_string(dropped) + ")");
+        reported_drops_ = dropped;
+    }
+    return written;
+}
+
 /**
  * @brief Main thread function for the log manager
  * 
- * Processes log entries from the queue and writes them to the log file.
- * Handles log file rotation when size limits are reached.
+ * Drains all available log entries in one pass and writes them to the log file.
+ * Sleeps on the condition variable only when the queue is empty; the wait is
+ * bounded so a wakeup racing with the sleep is picked up on the next pass.
  */
 void LogManager::main_thread_function() {
     while (running_) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        queue_cv_.wait(lock, [this] { return !log_queue_.empty() || !running_; });
-
-        while (!log_queue_.empty()) {
-            LogEntry entry = log_queue_.front();
-            log_queue_.pop();
-            lock.unlock();
-
-            write_log_entry(entry);
+        if (drain_queue() > 0) {
+            continue;
+        }
 
-            lock.lock();
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        consumer_waiting_.store(true);
+        if (running_ && log_queue_->size() == 0) {
+            queue_cv_.wait_for(lock, std::chrono::milliseconds(50));
         }
+        consumer_waiting_.store(false, std::memory_order_relaxed);
     }
+
+    // Write out anything that arrived during shutdown
+    drain_queue();
 }
 
 } // namespace fan_control_system 
\ No newline at end of file
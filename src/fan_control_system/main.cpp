@@ -1,27 +1,36 @@
 #include "fan_control_system/fan_control_system.hpp"
+#include "common/config.hpp"
+#include "common/flight_recorder.hpp"
+#include "common/timer_wheel.hpp"
 #include <iostream>
 #include <csignal>
 #include <cstdlib>
+#include <thread>
 
 /**
  * @brief Global pointer to the fan control system instance
  */
 std::unique_ptr<FanControlSystem> g_system;
 
+/**
+ * @brief Shutdown signal received, 0 while running
+ */
+volatile sig_atomic_t g_shutdown_signal = 0;
+
 /**
  * @brief Signal handler for graceful shutdown
  * 
- * Handles SIGINT and SIGTERM signals by stopping the fan control system
- * and exiting the program.
+ * Handles SIGINT and SIGTERM signals by recording the signal; the main loop
+ * then stops the fan control system and the timer wheel, which is not
+ * async-signal-safe. On SIGTERM the flight recorder is dumped first.
  * 
  * @param signal The signal number that triggered the handler
  */
 void signal_handler(int signal) {
-    if (g_system) {
-        std::cout << "Received signal " << signal << ", shutting down..." << std::endl;
-        g_system->stop();
+    if (signal == SIGTERM) {
+        common::FlightRecorder::getInstance().dumpFromSignal("SIGTERM");
     }
-    exit(signal);
+    g_shutdown_signal = signal;
 }
 
 /**
@@ -58,6 +67,12 @@ int main(int argc, char* argv[]) {
     try {
         // Create and start the fan control system
         g_system = std::make_unique<FanControlSystem>(config_file);
+
+        // Keep recent log and alarm records in memory for post-mortem dumps
+        auto& recorder = common::FlightRecorder::getInstance();
+        recorder.configure("fan_control_system", common::Config::getInstance().getConfig());
+        recorder.installCrashHandlers();
+
         if (!g_system->start()) {
             std::cerr << "Failed to start fan control system" << std::endl;
             return 1;
@@ -66,10 +81,15 @@ int main(int argc, char* argv[]) {
         std::cout << "Fan control system started successfully" << std::endl;
 
         // Wait for shutdown signal
-        while (g_system->is_running()) {
+        while (g_system->is_running() && !g_shutdown_signal) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
 
+        if (g_shutdown_signal) {
+            std::cout << "Received signal " << g_shutdown_signal << ", shutting down..." << std::endl;
+        }
+        g_system->stop();
+        common::TimerWheel::getInstance().stop();
         return 0;
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
@@ -0,0 +1,243 @@
+#include "fan_control_system/noise_dosimeter.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace fan_control_system {
+
+namespace {
+
+const std::chrono::seconds kSecond(1);
+const std::chrono::seconds kMinute(60);
+
+/**
+ * @brief Converts a level to power
+ */
+double toPower(double level_db) {
+    return std::pow(10.0, level_db / 10.0);
+}
+
+/**
+ * @brief Converts a power to a level
+ */
+double toLevel(double power) {
+    return power > 0.0 ? 10.0 * std::log10(power) : 0.0;
+}
+
+} // namespace
+
+/**
+ * @brief Reads the settings from the NoiseExposure configuration section
+ *
+ * Keys: CriterionLevel_dB, CriterionHours and ShiftHours. All are optional.
+ *
+ * @param config NoiseExposure configuration node, may be undefined
+ * @return Settings, defaults for missing keys
+ */
+NoiseExposureSettings NoiseExposureSettings::fromConfig(const YAML::Node& config) {
+    NoiseExposureSettings settings;
+    if (!config) {
+        return settings;
+    }
+    if (config["CriterionLevel_dB"]) settings.criterion_level_db = config["CriterionLevel_dB"].as<double>();
+    if (config["CriterionHours"]) {
+        settings.criterion_duration = std::chrono::minutes(std::lround(config["CriterionHours"].as<double>() * 60));
+    }
+    if (config["ShiftHours"]) settings.shift = std::chrono::minutes(std::lround(config["ShiftHours"].as<double>() * 60));
+    settings.criterion_duration = std::max(settings.criterion_duration, std::chrono::minutes(1));
+    settings.shift = std::max(settings.shift, std::chrono::minutes(1));
+    return settings;
+}
+
+/**
+ * @brief Constructs the dosimeter with all fans silent
+ *
+ * Allocates all boundary rings up front; record() never allocates.
+ *
+ * @param fan_count Number of fans, addressed by index
+ * @param settings Dose criterion and shift length
+ */
+NoiseDosimeter::NoiseDosimeter(size_t fan_count, const NoiseExposureSettings& settings)
+    : settings_(settings),
+      dose_energy_(toPower(settings.criterion_level_db) *
+                   std::chrono::duration<double>(settings.criterion_duration).count()),
+      origin_(std::chrono::steady_clock::now()),
+      fans_(fan_count) {
+    size_t minutes = static_cast<size_t>(std::max<int64_t>(60, settings.shift.count())) + 1;
+    for (auto& channel : fans_) {
+        channel.seconds.energy.resize(61);
+        channel.minutes.energy.resize(minutes);
+    }
+    combined_.seconds.energy.resize(61);
+    combined_.minutes.energy.resize(minutes);
+    start(std::vector<int>(fan_count, 0), origin_);
+}
+
+/**
+ * @brief Starts the accounting from the fans' current levels, dropping earlier exposure
+ *
+ * @param levels_db Level per fan; missing fans are taken as 0 dB
+ * @param now Current time
+ */
+void NoiseDosimeter::start(const std::vector<int>& levels_db, std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    origin_ = now;
+    double total = 0.0;
+    for (size_t fan = 0; fan < fans_.size(); ++fan) {
+        Channel& channel = fans_[fan];
+        channel.power = toPower(fan < levels_db.size() ? levels_db[fan] : 0);
+        total += channel.power;
+    }
+    combined_.power = total;
+    auto reset = [this, now](Channel& channel) {
+        channel.energy = 0.0;
+        channel.updated = now;
+        channel.changes = 0;
+        channel.seconds.last = -1;
+        channel.minutes.last = -1;
+        advance(channel, now);
+    };
+    for (auto& channel : fans_) {
+        reset(channel);
+    }
+    reset(combined_);
+}
+
+/**
+ * @brief Records the new level of a fan
+ *
+ * Closes the fan's and the combination's constant-level segments at now
+ * and continues them at the new power. Costs O(fans) plus one write per
+ * boundary passed since the previous change.
+ *
+ * @param fan Fan index, ignored if invalid
+ * @param level_db Level from now on
+ * @param now Time of the change
+ */
+void NoiseDosimeter::record(size_t fan, int level_db, std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fan >= fans_.size()) {
+        return;
+    }
+    Channel& channel = fans_[fan];
+    double power = toPower(level_db);
+    if (power == channel.power) {
+        return;
+    }
+    advance(channel, now);
+    advance(combined_, now);
+    channel.power = power;
+    ++channel.changes;
+    double total = 0.0;
+    for (const auto& other : fans_) {
+        total += other.power;
+    }
+    combined_.power = total;
+    ++combined_.changes;
+}
+
+/**
+ * @brief Gets the exposure of one fan
+ *
+ * @param fan Fan index
+ * @param now Current time
+ * @return Current level and windows, all zero for an invalid index
+ */
+NoiseExposure NoiseDosimeter::fanExposure(size_t fan, std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fan < fans_.size() ? exposure(fans_[fan], now) : NoiseExposure();
+}
+
+/**
+ * @brief Gets the exposure of all fans combined
+ *
+ * @param now Current time
+ * @return Current level and windows
+ */
+NoiseExposure NoiseDosimeter::combinedExposure(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return exposure(combined_, now);
+}
+
+/**
+ * @brief Brings a channel's energy and boundaries up to now
+ *
+ * Times before the channel's last update are taken as the last update.
+ *
+ * @param channel Channel to advance
+ * @param now Current time
+ */
+void NoiseDosimeter::advance(Channel& channel, std::chrono::steady_clock::time_point now) const {
+    now = std::max(now, channel.updated);
+    fill(channel, channel.seconds, kSecond, now);
+    fill(channel, channel.minutes, kMinute, now);
+    channel.energy += channel.power * std::chrono::duration<double>(now - channel.updated).count();
+    channel.updated = now;
+}
+
+/**
+ * @brief Fills in the boundaries of one resolution passed up to now
+ *
+ * The level was constant since the channel's last update, so the energy at
+ * each boundary follows from the energy then. After a long quiet time only
+ * the boundaries the ring still holds are written.
+ *
+ * @param channel Channel whose energy to use
+ * @param boundaries Boundaries to fill in
+ * @param resolution Time between two boundaries
+ * @param now Current time, not before the channel's last update
+ */
+void NoiseDosimeter::fill(const Channel& channel, Boundaries& boundaries, std::chrono::seconds resolution,
+                          std::chrono::steady_clock::time_point now) const {
+    int64_t newest = (now - origin_) / resolution;
+    int64_t size = static_cast<int64_t>(boundaries.energy.size());
+    for (int64_t k = std::max(boundaries.last + 1, newest - size + 1); k <= newest; ++k) {
+        double elapsed_s = std::chrono::duration<double>(origin_ + k * resolution - channel.updated).count();
+        boundaries.energy[k % size] = channel.energy + channel.power * elapsed_s;
+    }
+    boundaries.last = std::max(boundaries.last, newest);
+}
+
+/**
+ * @brief Computes a window ending now from the boundaries of one resolution
+ *
+ * @param channel Channel, advanced to now
+ * @param boundaries Boundaries of the channel, filled in up to now
+ * @param resolution Time between two boundaries
+ * @param length Window length in boundaries, less than the ring size
+ * @param now Current time
+ * @return Leq and dose from the oldest boundary at most length boundaries back to now
+ */
+NoiseExposureWindow NoiseDosimeter::window(const Channel& channel, const Boundaries& boundaries,
+                                           std::chrono::seconds resolution, int64_t length,
+                                           std::chrono::steady_clock::time_point now) const {
+    NoiseExposureWindow result;
+    bool on_boundary = now == origin_ + boundaries.last * resolution;
+    int64_t first = std::max<int64_t>(0, boundaries.last - length + (on_boundary ? 0 : 1));
+    int64_t size = static_cast<int64_t>(boundaries.energy.size());
+    result.covered_s = std::chrono::duration<double>(now - (origin_ + first * resolution)).count();
+    double energy = channel.energy - boundaries.energy[first % size];
+    result.leq_db = result.covered_s > 0.0 ? toLevel(energy / result.covered_s) : toLevel(channel.power);
+    result.dose_percent = 100.0 * energy / dose_energy_;
+    return result;
+}
+
+/**
+ * @brief Brings a channel up to now and computes all its windows
+ *
+ * @param channel Channel to report
+ * @param now Current time
+ * @return Current level and windows
+ */
+NoiseExposure NoiseDosimeter::exposure(Channel& channel, std::chrono::steady_clock::time_point now) {
+    advance(channel, now);
+    now = channel.updated;
+    NoiseExposure result;
+    result.level_db = toLevel(channel.power);
+    result.changes = channel.changes;
+    result.minute = window(channel, channel.seconds, kSecond, 60, now);
+    result.hour = window(channel, channel.minutes, kMinute, 60, now);
+    result.shift = window(channel, channel.minutes, kMinute, settings_.shift.count(), now);
+    return result;
+}
+
+} // namespace fan_control_system
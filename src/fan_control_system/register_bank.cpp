@@ -0,0 +1,414 @@
+#include "fan_control_system/register_bank.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fan_control_system {
+
+/**
+ * @brief Creates the backend selected in the RegisterBank configuration section
+ *
+ * Backend "Memory" (the default) uses SizeBytes (default 4096); backend
+ * "Mmap" uses Path (default /dev/shm/fan_control_registers) and SizeBytes;
+ * backend "I2C" uses Device (default /dev/i2c-1).
+ *
+ * @param config RegisterBank configuration node
+ * @return Backend, not yet opened; nullptr if the backend name is unknown
+ */
+std::shared_ptr<RegisterBank> RegisterBank::create(const YAML::Node& config) {
+    std::string backend = config["Backend"] ? config["Backend"].as<std::string>() : "Memory";
+    if (backend == "Memory") {
+        size_t size = config["SizeBytes"] ? config["SizeBytes"].as<size_t>() : 4096;
+        return std::make_shared<MemoryRegisterBank>(size);
+    }
+    if (backend == "Mmap") {
+        std::string path = config["Path"] ? config["Path"].as<std::string>() : "/dev/shm/fan_control_registers";
+        size_t size = config["SizeBytes"] ? config["SizeBytes"].as<size_t>() : 4096;
+        return std::make_shared<MmapRegisterBank>(path, size);
+    }
+    if (backend == "I2C") {
+        std::string device = config["Device"] ? config["Device"].as<std::string>() : "/dev/i2c-1";
+        return std::make_shared<I2CRegisterBank>(device);
+    }
+    std::cerr << "Unknown register bank backend: " << backend << std::endl;
+    return nullptr;
+}
+
+/**
+ * @brief Writes several registers one after another
+ *
+ * @param writes Writes to apply; their written flags are updated
+ * @return Number of registers written
+ */
+size_t RegisterBank::write_batch(std::vector<RegisterWrite>& writes) {
+    size_t written = 0;
+    for (auto& write : writes) {
+        write.written = write32(write.address, write.value);
+        written += write.written ? 1 : 0;
+    }
+    return written;
+}
+
+/**
+ * @brief Constructs the bank
+ *
+ * @param size_bytes Size of the bank in bytes
+ */
+MemoryRegisterBank::MemoryRegisterBank(size_t size_bytes)
+    : size_bytes_(size_bytes) {
+}
+
+/**
+ * @brief Allocates the registers, all zero
+ *
+ * @return true if the bank holds at least one register, false otherwise
+ */
+bool MemoryRegisterBank::open() {
+    if (size_bytes_ < sizeof(uint32_t)) {
+        std::cerr << "Register bank size too small: " << size_bytes_ << std::endl;
+        return false;
+    }
+    if (registers_.empty()) {
+        registers_.assign(size_bytes_ / sizeof(uint32_t), 0);
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a 32-bit register with a single release store
+ *
+ * @param address Register location, only the offset is used
+ * @param value Value to write
+ * @return true if the value was written, false if the bank is closed or the offset invalid
+ */
+bool MemoryRegisterBank::write32(const RegisterAddress& address, uint32_t value) {
+    uint32_t* reg = register_at(address.offset);
+    if (!reg) {
+        return false;
+    }
+    __atomic_store_n(reg, value, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Reads a 32-bit register with a single acquire load
+ *
+ * @param address Register location, only the offset is used
+ * @param value Value read
+ * @return true if the value was read, false if the bank is closed or the offset invalid
+ */
+bool MemoryRegisterBank::read32(const RegisterAddress& address, uint32_t& value) {
+    uint32_t* reg = register_at(address.offset);
+    if (!reg) {
+        return false;
+    }
+    value = __atomic_load_n(reg, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+/**
+ * @brief Gets a description of the backend for logs
+ *
+ * @return Backend name and size
+ */
+std::string MemoryRegisterBank::describe() const {
+    return "memory (" + std::to_string(size_bytes_) + " bytes)";
+}
+
+/**
+ * @brief Gets the register at a byte offset
+ *
+ * @param offset Byte offset in the bank
+ * @return Register, nullptr if the bank is closed, the offset unaligned or outside the bank
+ */
+uint32_t* MemoryRegisterBank::register_at(uint32_t offset) {
+    if (offset % sizeof(uint32_t) != 0 || offset / sizeof(uint32_t) >= registers_.size()) {
+        return nullptr;
+    }
+    return &registers_[offset / sizeof(uint32_t)];
+}
+
+/**
+ * @brief Constructs the bank
+ *
+ * @param path File backing the registers
+ * @param size_bytes Size of the bank in bytes
+ */
+MmapRegisterBank::MmapRegisterBank(const std::string& path, size_t size_bytes)
+    : path_(path), size_bytes_(size_bytes) {
+}
+
+/**
+ * @brief Unmaps the file
+ */
+MmapRegisterBank::~MmapRegisterBank() {
+    if (base_) {
+        munmap(base_, size_bytes_);
+    }
+}
+
+/**
+ * @brief Maps the register file, creating and sizing it if needed
+ *
+ * An existing file keeps its contents, so the registers survive a restart
+ * like the hardware they stand in for.
+ *
+ * @return true if the file is mapped, false otherwise
+ */
+bool MmapRegisterBank::open() {
+    if (base_) {
+        return true;
+    }
+    if (size_bytes_ < sizeof(uint32_t)) {
+        std::cerr << "Register bank size too small: " << size_bytes_ << std::endl;
+        return false;
+    }
+    int fd = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "Failed to open register file " << path_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (static_cast<size_t>(st.st_size) < size_bytes_ && ftruncate(fd, size_bytes_) != 0)) {
+        std::cerr << "Failed to size register file " << path_ << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, size_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Failed to map register file " << path_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    base_ = static_cast<uint32_t*>(mapping);
+    return true;
+}
+
+/**
+ * @brief Writes a 32-bit register with a single release store
+ *
+ * @param address Register location, only the offset is used
+ * @param value Value to write
+ * @return true if the value was written, false if the bank is closed or the offset invalid
+ */
+bool MmapRegisterBank::write32(const RegisterAddress& address, uint32_t value) {
+    uint32_t* reg = register_at(address.offset);
+    if (!reg) {
+        return false;
+    }
+    __atomic_store_n(reg, value, __ATOMIC_RELEASE);
+    return true;
+}
+
+/**
+ * @brief Reads a 32-bit register with a single acquire load
+ *
+ * @param address Register location, only the offset is used
+ * @param value Value read
+ * @return true if the value was read, false if the bank is closed or the offset invalid
+ */
+bool MmapRegisterBank::read32(const RegisterAddress& address, uint32_t& value) {
+    uint32_t* reg = register_at(address.offset);
+    if (!reg) {
+        return false;
+    }
+    value = __atomic_load_n(reg, __ATOMIC_ACQUIRE);
+    return true;
+}
+
+/**
+ * @brief Gets a description of the backend for logs
+ *
+ * @return Backend name and file
+ */
+std::string MmapRegisterBank::describe() const {
+    return "mmap " + path_ + " (" + std::to_string(size_bytes_) + " bytes)";
+}
+
+/**
+ * @brief Gets the register at a byte offset
+ *
+ * @param offset Byte offset in the bank
+ * @return Register, nullptr if the bank is closed, the offset unaligned or outside the bank
+ */
+uint32_t* MmapRegisterBank::register_at(uint32_t offset) const {
+    if (!base_ || offset % sizeof(uint32_t) != 0 || offset + sizeof(uint32_t) > size_bytes_) {
+        return nullptr;
+    }
+    return base_ + offset / sizeof(uint32_t);
+}
+
+/**
+ * @brief Constructs the bank
+ *
+ * @param device I2C bus device, e.g. /dev/i2c-1
+ */
+I2CRegisterBank::I2CRegisterBank(const std::string& device)
+    : device_(device) {
+}
+
+/**
+ * @brief Closes the bus device
+ */
+I2CRegisterBank::~I2CRegisterBank() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+/**
+ * @brief Opens the bus device
+ *
+ * @return true if the device is open, false otherwise
+ */
+bool I2CRegisterBank::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        return true;
+    }
+    fd_ = ::open(device_.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open I2C bus " << device_ << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes a 32-bit register
+ *
+ * @param address Register location, the I2C address and register number are used
+ * @param value Value to write
+ * @return true if the transfer succeeded, false otherwise
+ */
+bool I2CRegisterBank::write32(const RegisterAddress& address, uint32_t value) {
+    uint8_t buffer[5] = {address.reg,
+                         static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+                         static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24)};
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!select_device(address.i2c_address)) {
+        return false;
+    }
+    return ::write(fd_, buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer));
+}
+
+/**
+ * @brief Reads a 32-bit register
+ *
+ * @param address Register location, the I2C address and register number are used
+ * @param value Value read
+ * @return true if the transfer succeeded, false otherwise
+ */
+bool I2CRegisterBank::read32(const RegisterAddress& address, uint32_t& value) {
+    uint8_t buffer[4];
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!select_device(address.i2c_address) ||
+        ::write(fd_, &address.reg, 1) != 1 ||
+        ::read(fd_, buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer))) {
+        return false;
+    }
+    value = static_cast<uint32_t>(buffer[0]) | static_cast<uint32_t>(buffer[1]) << 8 |
+            static_cast<uint32_t>(buffer[2]) << 16 | static_cast<uint32_t>(buffer[3]) << 24;
+    return true;
+}
+
+/**
+ * @brief Writes several registers in one combined I2C transfer
+ *
+ * The writes are ordered by controller address and register and sent with a
+ * single I2C_RDWR ioctl (one message per register, split only at the
+ * kernel's per-call message limit), so all controllers on the bus are
+ * updated back to back instead of one system call each.
+ *
+ * @param writes Writes to apply; their written flags are updated
+ * @return Number of registers written
+ */
+size_t I2CRegisterBank::write_batch(std::vector<RegisterWrite>& writes) {
+    std::vector<RegisterWrite*> ordered;
+    ordered.reserve(writes.size());
+    for (auto& write : writes) {
+        write.written = false;
+        ordered.push_back(&write);
+    }
+    std::stable_sort(ordered.begin(), ordered.end(), [](const RegisterWrite* a, const RegisterWrite* b) {
+        return a->address.i2c_address != b->address.i2c_address ? a->address.i2c_address < b->address.i2c_address
+                                                                 : a->address.reg < b->address.reg;
+    });
+
+    std::vector<uint8_t> buffers(ordered.size() * 5);
+    std::vector<struct i2c_msg> messages(ordered.size());
+    for (size_t i = 0; i < ordered.size(); ++i) {
+        uint8_t* buffer = &buffers[i * 5];
+        uint32_t value = ordered[i]->value;
+        buffer[0] = ordered[i]->address.reg;
+        buffer[1] = static_cast<uint8_t>(value);
+        buffer[2] = static_cast<uint8_t>(value >> 8);
+        buffer[3] = static_cast<uint8_t>(value >> 16);
+        buffer[4] = static_cast<uint8_t>(value >> 24);
+        messages[i].addr = ordered[i]->address.i2c_address;
+        messages[i].flags = 0;
+        messages[i].len = 5;
+        messages[i].buf = buffer;
+    }
+
+    size_t written = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        return 0;
+    }
+    for (size_t first = 0; first < messages.size(); first += I2C_RDWR_IOCTL_MAX_MSGS) {
+        size_t count = std::min<size_t>(I2C_RDWR_IOCTL_MAX_MSGS, messages.size() - first);
+        struct i2c_rdwr_ioctl_data transfer;
+        transfer.msgs = &messages[first];
+        transfer.nmsgs = static_cast<uint32_t>(count);
+        if (ioctl(fd_, I2C_RDWR, &transfer) < 0) {
+            continue;
+        }
+        for (size_t i = first; i < first + count; ++i) {
+            ordered[i]->written = true;
+        }
+        written += count;
+    }
+    return written;
+}
+
+/**
+ * @brief Gets a description of the backend for logs
+ *
+ * @return Backend name and bus device
+ */
+std::string I2CRegisterBank::describe() const {
+    return "i2c " + device_;
+}
+
+/**
+ * @brief Addresses the controller for the following transfer
+ *
+ * The address is only changed when it differs from the last transfer.
+ *
+ * @param i2c_address I2C address of the fan controller
+ * @return true if the controller is addressed, false if the bus is closed or the ioctl failed
+ */
+bool I2CRegisterBank::select_device(uint8_t i2c_address) {
+    if (fd_ < 0) {
+        return false;
+    }
+    if (selected_address_ != i2c_address) {
+        if (ioctl(fd_, I2C_SLAVE, static_cast<long>(i2c_address)) < 0) {
+            selected_address_ = -1;
+            return false;
+        }
+        selected_address_ = i2c_address;
+    }
+    return true;
+}
+
+} // namespace fan_control_system
@@ -0,0 +1,277 @@
+#include "fan_control_system/tachometer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace fan_control_system {
+
+/**
+ * @brief Gets the name of a tachometer fault for logs, config and RPC
+ *
+ * @param fault Tachometer fault
+ * @return "None", "Stall", "Degraded" or "NoSignal"
+ */
+const char* tachFaultName(TachFault fault) {
+    switch (fault) {
+        case TachFault::STALL: return "Stall";
+        case TachFault::DEGRADED: return "Degraded";
+        case TachFault::NO_SIGNAL: return "NoSignal";
+        default: return "None";
+    }
+}
+
+/**
+ * @brief Parses a tachometer fault name as returned by tachFaultName()
+ *
+ * @param name Fault name
+ * @param fault Parsed fault
+ * @return true if the name is known, false otherwise
+ */
+bool parseTachFault(const std::string& name, TachFault& fault) {
+    for (TachFault candidate : {TachFault::NONE, TachFault::STALL, TachFault::DEGRADED, TachFault::NO_SIGNAL}) {
+        if (name == tachFaultName(candidate)) {
+            fault = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the model from a fan model's Tach configuration section
+ *
+ * Keys: MaxRPM, StallDutyPercent, SpinUpMs, SpinDownMs, DegradedRatio and
+ * FailureMode (Stall, Degraded or NoSignal). All are optional.
+ *
+ * @param config Tach configuration node, may be undefined
+ * @return Model, defaults for missing keys
+ */
+TachModel TachModel::fromConfig(const YAML::Node& config) {
+    TachModel model;
+    if (!config) {
+        return model;
+    }
+    if (config["MaxRPM"]) model.max_rpm = config["MaxRPM"].as<int>();
+    if (config["StallDutyPercent"]) model.stall_duty_percent = config["StallDutyPercent"].as<int>();
+    if (config["SpinUpMs"]) model.spin_up_time = std::chrono::milliseconds(config["SpinUpMs"].as<int>());
+    if (config["SpinDownMs"]) model.spin_down_time = std::chrono::milliseconds(config["SpinDownMs"].as<int>());
+    if (config["DegradedRatio"]) model.degraded_ratio = config["DegradedRatio"].as<double>();
+    if (config["FailureMode"]) {
+        std::string name = config["FailureMode"].as<std::string>();
+        if (!parseTachFault(name, model.failure_mode) || model.failure_mode == TachFault::NONE) {
+            std::cerr << "Unknown tachometer failure mode " << name << ", using Stall" << std::endl;
+            model.failure_mode = TachFault::STALL;
+        }
+    }
+    return model;
+}
+
+/**
+ * @brief Reads the settings from the Tachometer configuration section
+ *
+ * Keys: Enabled (default true), SampleIntervalMs, HistorySize,
+ * FaultTolerancePercent, FaultMinRPM and FaultConfirmSamples.
+ *
+ * @param config Tachometer configuration node, may be undefined
+ * @return Settings, disabled if the section is missing
+ */
+TachSettings TachSettings::fromConfig(const YAML::Node& config) {
+    TachSettings settings;
+    if (!config) {
+        return settings;
+    }
+    settings.enabled = config["Enabled"] ? config["Enabled"].as<bool>() : true;
+    if (config["SampleIntervalMs"]) settings.sample_interval = std::chrono::milliseconds(config["SampleIntervalMs"].as<int>());
+    if (config["HistorySize"]) settings.history_size = config["HistorySize"].as<size_t>();
+    if (config["FaultTolerancePercent"]) settings.fault_tolerance_percent = config["FaultTolerancePercent"].as<int>();
+    if (config["FaultMinRPM"]) settings.fault_min_rpm = config["FaultMinRPM"].as<int>();
+    if (config["FaultConfirmSamples"]) settings.fault_confirm_samples = config["FaultConfirmSamples"].as<int>();
+    settings.sample_interval = std::max(settings.sample_interval, std::chrono::milliseconds(1));
+    settings.history_size = std::max<size_t>(settings.history_size, 1);
+    settings.fault_confirm_samples = std::max(settings.fault_confirm_samples, 1);
+    return settings;
+}
+
+/**
+ * @brief Constructs the tachometer with the rotor at rest
+ *
+ * @param model Rotor dynamics of the fan model
+ * @param settings Sampling and fault detection settings
+ */
+Tachometer::Tachometer(const TachModel& model, const TachSettings& settings)
+    : model_(model), settings_(settings), ring_(settings.history_size) {
+}
+
+/**
+ * @brief Advances the rotor model to now and records a sample
+ *
+ * @param duty_cycle Commanded duty cycle
+ * @param now Current steady clock time
+ * @param timestamp_ms Wall clock time of the sample
+ * @return true if this sample confirmed a fault
+ */
+bool Tachometer::sample(int duty_cycle, std::chrono::steady_clock::time_point now, int64_t timestamp_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double dt_s = sampled_ ? std::chrono::duration<double>(now - last_sample_).count() : 0.0;
+    last_sample_ = now;
+    sampled_ = true;
+
+    double target = targetRpm(duty_cycle);
+    expected_rpm_ = approach(expected_rpm_, target, dt_s);
+    switch (fault_) {
+        case TachFault::STALL:
+            rotor_rpm_ = 0.0;
+            break;
+        case TachFault::DEGRADED:
+            rotor_rpm_ = approach(rotor_rpm_, target * model_.degraded_ratio, dt_s);
+            break;
+        default:
+            rotor_rpm_ = approach(rotor_rpm_, target, dt_s);
+            break;
+    }
+    uint32_t rpm = fault_ == TachFault::NO_SIGNAL ? 0 : static_cast<uint32_t>(std::lround(rotor_rpm_));
+
+    TachSample& entry = ring_[next_];
+    entry.timestamp_ms = timestamp_ms;
+    entry.rpm = rpm;
+    entry.expected_rpm = static_cast<uint32_t>(std::lround(expected_rpm_));
+    entry.duty_cycle = static_cast<uint8_t>(std::max(0, std::min(duty_cycle, 100)));
+    next_ = (next_ + 1) % ring_.size();
+    count_ = std::min(count_ + 1, ring_.size());
+
+    bool short_of_expected = expected_rpm_ >= settings_.fault_min_rpm &&
+                             rpm < expected_rpm_ * (100 - settings_.fault_tolerance_percent) / 100.0;
+    short_samples_ = short_of_expected ? short_samples_ + 1 : 0;
+    if (detected_ || short_samples_ < settings_.fault_confirm_samples) {
+        return false;
+    }
+    detected_ = true;
+    if (fault_ != TachFault::NONE) {
+        detection_latency_ms_ = std::chrono::duration_cast<std::chrono::milliseconds>(now - fault_time_).count();
+    }
+    return true;
+}
+
+/**
+ * @brief Injects a simulated failure
+ *
+ * @param fault Failure to simulate
+ */
+void Tachometer::injectFault(TachFault fault) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fault_ == fault) {
+        return;
+    }
+    fault_ = fault;
+    fault_time_ = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Removes a simulated failure and resets the fault detection
+ *
+ * A stalled rotor spins up again from rest; the fault-free model restarts
+ * from the rotor speed so the spin-up is not taken for a new fault.
+ */
+void Tachometer::clearFault() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fault_ = TachFault::NONE;
+    expected_rpm_ = rotor_rpm_;
+    detected_ = false;
+    detection_latency_ms_ = -1;
+    short_samples_ = 0;
+}
+
+/**
+ * @brief Gets the injected failure
+ *
+ * @return Simulated failure, NONE if the fan is healthy
+ */
+TachFault Tachometer::getFault() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fault_;
+}
+
+/**
+ * @brief Gets whether the samples confirmed a fault
+ *
+ * @return true from the confirming sample until clearFault()
+ */
+bool Tachometer::isFaultDetected() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return detected_;
+}
+
+/**
+ * @brief Gets the time from the injected failure to its detection
+ *
+ * @return Detection latency in milliseconds, -1 if no injected failure was detected
+ */
+int64_t Tachometer::getDetectionLatencyMs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return detection_latency_ms_;
+}
+
+/**
+ * @brief Gets the last measured speed
+ *
+ * @return Speed in RPM, 0 before the first sample
+ */
+int Tachometer::getRpm() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0) {
+        return 0;
+    }
+    return static_cast<int>(ring_[(next_ + ring_.size() - 1) % ring_.size()].rpm);
+}
+
+/**
+ * @brief Gets the most recent samples
+ *
+ * @param max_samples Maximum number of samples, 0 for all kept
+ * @return Samples, oldest first
+ */
+std::vector<TachSample> Tachometer::getHistory(size_t max_samples) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = max_samples > 0 ? std::min(max_samples, count_) : count_;
+    std::vector<TachSample> history;
+    history.reserve(count);
+    size_t first = (next_ + ring_.size() - count) % ring_.size();
+    for (size_t i = 0; i < count; ++i) {
+        history.push_back(ring_[(first + i) % ring_.size()]);
+    }
+    return history;
+}
+
+/**
+ * @brief Gets the steady speed of a healthy rotor at a duty cycle
+ *
+ * @param duty_cycle Commanded duty cycle
+ * @return Speed in RPM, 0 below the stall duty cycle
+ */
+double Tachometer::targetRpm(int duty_cycle) const {
+    if (duty_cycle <= 0 || duty_cycle < model_.stall_duty_percent) {
+        return 0.0;
+    }
+    return model_.max_rpm * std::min(duty_cycle, 100) / 100.0;
+}
+
+/**
+ * @brief Moves a speed towards a target over a time step with the first-order dynamics
+ *
+ * Uses the exact step response, so the result does not depend on how the
+ * time is split into samples.
+ *
+ * @param rpm Current speed
+ * @param target Steady speed
+ * @param dt_s Time step in seconds
+ * @return Speed after the time step
+ */
+double Tachometer::approach(double rpm, double target, double dt_s) const {
+    double tau_s = std::chrono::duration<double>(target > rpm ? model_.spin_up_time : model_.spin_down_time).count();
+    if (tau_s <= 0.0) {
+        return target;
+    }
+    return target + (rpm - target) * std::exp(-dt_s / tau_s);
+}
+
+} // namespace fan_control_system
@@ -56,7 +56,8 @@ TempMonitorAndCooling::~TempMonitorAndCooling() {
 /**
  * @brief Starts the temperature monitor
  * 
- * Initializes temperature thresholds and fan speed settings, starts the main monitoring thread.
+ * Initializes temperature thresholds and fan speed settings, schedules the fan speed update
+ * on the shared timer wheel every UpdateIntervalMs.
  * 
  * @return true if startup was successful, false otherwise
  */
@@ -72,7 +73,8 @@ bool TempMonitorAndCooling::start() {
     }
 
     running_ = true;
-    main_thread_ = std::thread(&TempMonitorAndCooling::main_thread_function, this);
+    update_timer_ = common::TimerWheel::getInstance().schedulePeriodic(std::chrono::milliseconds(update_interval_ms_),
+                                                                       [this]() { update_fan_speed(); });
     logger_->info("Temperature Monitor started successfully");
     return true;
 }
@@ -80,7 +82,7 @@ bool TempMonitorAndCooling::start() {
 /**
  * @brief Stops the temperature monitor
  * 
- * Stops the main monitoring thread and cleans up resources.
+ * Cancels the fan speed update; an update in progress finishes before this returns.
  */
 void TempMonitorAndCooling::stop() {
     if (!running_) {
@@ -89,9 +91,8 @@ void TempMonitorAndCooling::stop() {
 
     logger_->info("Stopping Temperature Monitor...");
     running_ = false;
-    if (main_thread_.joinable()) {
-        main_thread_.join();
-    }
+    common::TimerWheel::getInstance().cancel(update_timer_);
+    update_timer_ = 0;
     logger_->info("Temperature Monitor stopped");
 }
 
@@ -380,9 +381,10 @@ CoolingStatus TempMonitorAndCooling::calculate_fan_speed() const {
         
         if (std_dev > std_dev_threshold_) {
             logger_->debug("MCU " + mcu.first + " has high standard deviation: " + std::to_string(std_dev));
-            alarm_->raise(common::AlarmSeverity::HIGH, "MCU " + mcu.first + " has high standard deviation: " + std::to_string(std_dev) + "°C, mean: " + std::to_string(mean) + "°C, hence skipping");
+            alarm_->raise("stddev." + mcu.first, common::AlarmSeverity::ERROR, "MCU " + mcu.first + " has high standard deviation: " + std::to_string(std_dev) + "°C, mean: " + std::to_string(mean) + "°C, hence skipping");
             continue;
         }
+        alarm_->clear("stddev." + mcu.first, "MCU " + mcu.first + " standard deviation back to normal");
         max_temp = std::max(max_temp, mean);
     }
 
@@ -464,21 +466,47 @@ void TempMonitorAndCooling::set_thresholds(double temp_threshold_low, double tem
 void TempMonitorAndCooling::update_fan_speed() {
     // Calculate and set new fan speed
     CoolingStatus new_status = calculate_fan_speed();
+    // While an alarm action holds the fans at an emergency speed the mode is EMERGENCY;
+    // once the hold expires the computed speed is re-applied even if it did not change
+    bool floor_active = fan_simulator_ && fan_simulator_->get_speed_floor() > 0;
+    bool floor_released = emergency_floor_active_ && !floor_active;
+    emergency_floor_active_ = floor_active;
+    if (floor_active) {
+        new_status.cooling_mode = "EMERGENCY";
+    }
+
     // Check if current fan speed is different by 10% from the new fan speed, then only update the fan speed
-    // or the temperature is different by 5°C, then only update the fan speed
-    if (std::abs(cooling_status_.current_fan_speed - new_status.current_fan_speed) > 10 || 
+    // or the temperature is different by 5°C, then only update the fan speed.
+    // A shaped fan simulator applies its own hysteresis, so it gets every change.
+    int speed_band = fan_simulator_ && fan_simulator_->is_actuation_shaped() ? 0 : 10;
+    // The reported speed is the shaper's output, which lags or drops the requested speed
+    bool shaped = fan_simulator_ && fan_simulator_->is_actuation_shaped();
+    if (floor_released ||
+        std::abs(requested_fan_speed_ - new_status.current_fan_speed) > speed_band || 
         std::abs(cooling_status_.average_temperature - new_status.average_temperature) > 5.0) {
+        requested_fan_speed_ = new_status.current_fan_speed;
         cooling_status_.current_fan_speed = new_status.current_fan_speed;
         cooling_status_.average_temperature = new_status.average_temperature;
-        cooling_status_.cooling_mode = "MANUAL";
+        cooling_status_.cooling_mode = new_status.cooling_mode;
     } else {
+        cooling_status_.cooling_mode = new_status.cooling_mode;
+        if (shaped) {
+            int shaped_speed = fan_simulator_->get_shaped_speed();
+            cooling_status_.current_fan_speed = shaped_speed >= 0 ? shaped_speed : requested_fan_speed_;
+        }
         logger_->debug("No need to update fan speed or temperature");
         return;
     }
 
     if (fan_simulator_) {
         if (fan_simulator_->set_fan_speed(new_status.current_fan_speed)) {
-            logger_->info("Updated fan speed to " + std::to_string(new_status.current_fan_speed) + "%");
+            int shaped_speed = shaped ? fan_simulator_->get_shaped_speed() : -1;
+            if (shaped_speed >= 0) {
+                cooling_status_.current_fan_speed = shaped_speed;
+            }
+            logger_->info("Updated fan speed to " + std::to_string(cooling_status_.current_fan_speed) + "%" +
+                          (cooling_status_.current_fan_speed != new_status.current_fan_speed
+                               ? " (target " + std::to_string(new_status.current_fan_speed) + "%)" : ""));
         } else {
             logger_->error("Failed to update fan speed");
         }
@@ -490,24 +518,10 @@ void TempMonitorAndCooling::update_fan_speed() {
     json temp_data = {
         {"cooling_mode", new_status.cooling_mode},
         {"average_temperature", new_status.average_temperature},
-        {"current_fan_speed", new_status.current_fan_speed},
+        {"current_fan_speed", cooling_status_.current_fan_speed},
         {"timestamp", common::utils::formatTimestamp(std::chrono::system_clock::now())}
     };
     mqtt_client_->publish("temp_monitor/cooling_status", temp_data.dump());
 }
 
-/**
- * @brief Main thread function for the temperature monitor
- * 
- * Runs in a loop while the monitor is active, handling any background tasks.
- */
-void TempMonitorAndCooling::main_thread_function() {
-    logger_->info("Temperature Monitor main thread started");
-    while (running_) {
-        update_fan_speed();
-        std::this_thread::sleep_for(std::chrono::milliseconds(update_interval_ms_));
-    }
-    logger_->info("Temperature Monitor main thread stopped");
-}
-
 } // namespace fan_control_system 
\ No newline at end of file
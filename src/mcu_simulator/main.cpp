@@ -1,4 +1,7 @@
 #include "mcu_simulator/mcu_simulator.hpp"
+#include "common/config.hpp"
+#include "common/flight_recorder.hpp"
+#include "common/timer_wheel.hpp"
 #include <iostream>
 #include <csignal>
 #include <thread>
@@ -13,10 +16,14 @@ volatile bool running = true;
  * 
  * Handles SIGINT and SIGTERM signals to gracefully shut down the MCU simulator.
  * Sets the running flag to false, which causes the main loop to exit.
+ * On SIGTERM the flight recorder is dumped first.
  * 
  * @param signal_number The signal number that was received
  */
-void signalHandler(int) {
+void signalHandler(int signal_number) {
+    if (signal_number == SIGTERM) {
+        common::FlightRecorder::getInstance().dumpFromSignal("SIGTERM");
+    }
     running = false;
 }
 
@@ -60,6 +67,14 @@ int main(int argc, char* argv[]) {
     signal(SIGTERM, mcu_simulator::signalHandler);
 
     try {
+        // Keep recent log and alarm records in memory for post-mortem dumps
+        auto& config = common::Config::getInstance();
+        if (config.load(config_file)) {
+            auto& recorder = common::FlightRecorder::getInstance();
+            recorder.configure("mcu_simulator", config.getConfig());
+            recorder.installCrashHandlers();
+        }
+
         // Create and initialize MCU simulator
         mcu_simulator::MCUSimulator simulator(config_file);
         if (!simulator.initialize()) {
@@ -78,6 +93,7 @@ int main(int argc, char* argv[]) {
 
         // Stop the simulator
         simulator.stop();
+        common::TimerWheel::getInstance().stop();
         std::cout << "MCU Simulator stopped." << std::endl;
 
         return 0;
@@ -5,7 +5,6 @@
 #include "common/logger.hpp"
 #include "common/alarm.hpp"
 #include "common/utils.hpp"
-#include <thread>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <iomanip>
@@ -37,6 +36,7 @@ MCU::MCU(const std::string& name, int num_sensors,
     const YAML::Node& sensor_config, const std::string& config_file)
     : name_(name)
     , running_(false)
+    , publish_timer_(0)
     , last_read_time_(std::chrono::system_clock::now())
     , sensor_readings_(num_sensors)
     , temp_settings_(temp_settings)
@@ -110,7 +110,7 @@ bool MCU::initialize() {
     }
 
     // Initialize logger and alarm
-    logger_ = std::make_unique<common::Logger>(name_, log_level, mqtt_client_);
+    logger_ = std::make_unique<common::Logger>(name_, log_level, mqtt_client_, "MCUSimulator");
     alarm_ = std::make_unique<common::Alarm>(name_, mqtt_client_);
 
     logger_->info("MCU initialized successfully");
@@ -120,7 +120,7 @@ bool MCU::initialize() {
 /**
  * @brief Starts the MCU's temperature monitoring
  * 
- * Starts a background thread that continuously reads temperatures
+ * Schedules a 1 s timer on the shared timer wheel that reads temperatures
  * from all sensors and publishes them via MQTT at appropriate intervals.
  */
 void MCU::start() {
@@ -128,24 +128,24 @@ void MCU::start() {
     running_ = true;
     logger_->info("MCU started");
 
-    // Start temperature reading thread
-    std::thread([this]() {
-        while (running_) {
-            readAndPublishTemperatures();
-            checkAlarm();
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-    }).detach();
+    // Temperature reading timer
+    publish_timer_ = common::TimerWheel::getInstance().schedulePeriodic(std::chrono::seconds(1), [this]() {
+        readAndPublishTemperatures();
+        checkAlarm();
+    });
 }
 
 /**
  * @brief Stops the MCU's temperature monitoring
  * 
- * Stops the background thread and cleans up resources.
+ * Cancels the reading timer; a reading in progress finishes before this
+ * returns.
  */
 void MCU::stop() {
     if (!running_) return;
     running_ = false;
+    common::TimerWheel::getInstance().cancel(publish_timer_);
+    publish_timer_ = 0;
     logger_->info("MCU stopped");
 }
 
@@ -159,12 +159,12 @@ void MCU::checkAlarm() {
     }
     if (bad_sensors > sensors_.size() / 2) {
         logger_->error("MCU " + name_ + " has more than half of its sensors bad");
-        alarm_->raise(common::AlarmSeverity::CRITICAL, "MCU " + name_ + " has more than half of its sensors bad");
+        alarm_->raise("sensors_bad", common::AlarmSeverity::CRITICAL, "MCU " + name_ + " has more than half of its sensors bad");
         alarm_raised_ = true;
     }
     // Check if the alarm has been raised and sensors are good, clear the alarm
     else if (alarm_raised_) {
-        alarm_->clear("MCU " + name_ + " is back to normal");
+        alarm_->clear("sensors_bad", "MCU " + name_ + " is back to normal");
         alarm_raised_ = false;
     }
 }
@@ -185,7 +185,12 @@ bool MCU::makeSensorBad(int sensor_id, bool is_bad) {
     }
     sensors_[sensor_id - 1]->setStatus(is_bad);
     logger_->info("Sensor " + std::to_string(sensor_id) + " marked as bad");
-    alarm_->raise(common::AlarmSeverity::MEDIUM, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " marked as bad");
+    std::string alarm_id = "sensor" + std::to_string(sensor_id) + ".bad";
+    if (is_bad) {
+        alarm_->raise(alarm_id, common::AlarmSeverity::WARNING, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " marked as bad");
+    } else {
+        alarm_->clear(alarm_id, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " marked as good");
+    }
     return true;
 }
 
@@ -205,7 +210,12 @@ bool MCU::makeSensorNoisy(int sensor_id, bool is_noisy) {
     }
     sensors_[sensor_id - 1]->setNoisy(is_noisy);
     logger_->info("Sensor " + std::to_string(sensor_id) + " set to noisy mode");
-    alarm_->raise(common::AlarmSeverity::LOW, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " set to noisy mode");
+    std::string alarm_id = "sensor" + std::to_string(sensor_id) + ".noisy";
+    if (is_noisy) {
+        alarm_->raise(alarm_id, common::AlarmSeverity::INFO, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " set to noisy mode");
+    } else {
+        alarm_->clear(alarm_id, "MCU " + name_ + " Sensor " + std::to_string(sensor_id) + " noisy mode cleared");
+    }
     return true;
 }
 
@@ -291,7 +301,7 @@ std::chrono::seconds MCU::calculatePublishInterval(float temperature) const {
 /**
  * @brief Reads temperatures from all sensors and publishes them
  * 
- * This function is called periodically by the background thread. It:
+ * This function is called periodically by the reading timer. It:
  * 1. Reads temperatures from all sensors
  * 2. Updates reading history
  * 3. Checks for erratic readings and bad temperatures
@@ -328,7 +338,7 @@ void MCU::readAndPublishTemperatures() {
                 status = "Bad";
             }
             logger_->warning("Sensor " + std::to_string(i + 1) + " showing erratic readings");
-            alarm_->raise(common::AlarmSeverity::HIGH, 
+            alarm_->raise("sensor" + std::to_string(i + 1) + ".erratic", common::AlarmSeverity::ERROR,
                 "MCU " + name_ + " Sensor " + std::to_string(i + 1) + " showing erratic readings");
             should_publish = true;
             sensors_[i]->raiseAlarm();
@@ -342,7 +352,7 @@ void MCU::readAndPublishTemperatures() {
             std::ostringstream temp_stream;
             temp_stream << std::fixed << std::setprecision(2) << temp;
             logger_->error("Sensor " + std::to_string(i + 1) + " temperature below threshold: " + temp_stream.str());
-            alarm_->raise(common::AlarmSeverity::CRITICAL, 
+            alarm_->raise("sensor" + std::to_string(i + 1) + ".below_threshold", common::AlarmSeverity::CRITICAL,
                 "MCU " + name_ + " Sensor " + std::to_string(i + 1) + " temperature below threshold: " + temp_stream.str());
             should_publish = true;
             sensors_[i]->raiseAlarm();
@@ -350,7 +360,9 @@ void MCU::readAndPublishTemperatures() {
 
         // Check if the alarm has been raised and sensors are good, clear the alarm
         if (sensors_[i]->getAlarmRaised() && sensors_[i]->getStatus() == "Good") {
-            alarm_->clear("MCU " + name_ + " Sensor " + std::to_string(i + 1) + " is back to normal");
+            std::string sensor_prefix = "sensor" + std::to_string(i + 1);
+            alarm_->clear(sensor_prefix + ".erratic", "MCU " + name_ + " Sensor " + std::to_string(i + 1) + " is back to normal");
+            alarm_->clear(sensor_prefix + ".below_threshold", "MCU " + name_ + " Sensor " + std::to_string(i + 1) + " is back to normal");
             sensors_[i]->clearAlarm();
         }
 
@@ -393,9 +405,10 @@ void MCU::readAndPublishTemperatures() {
 
         if (!mqtt_client_->publish(topic, payload)) {
             logger_->error("Failed to publish temperature data");
-            alarm_->raise(common::AlarmSeverity::MEDIUM, "MCU " + name_ + " Failed to publish temperature data");
+            alarm_->raise("publish_failed", common::AlarmSeverity::WARNING, "MCU " + name_ + " Failed to publish temperature data");
         } else {
             logger_->debug("Published temperature data for " + name_);
+            alarm_->clear("publish_failed", "MCU " + name_ + " Temperature data published again");
         }
         last_read_time_ = now;
     }
@@ -423,10 +436,10 @@ void MCU::setFaulty(bool is_faulty) {
     is_faulty_ = is_faulty;
     if (is_faulty_) {
         logger_->error("MCU " + name_ + " set to faulty state");
-        alarm_->raise(common::AlarmSeverity::HIGH, "MCU " + name_ + " set to faulty state");
+        alarm_->raise("faulty", common::AlarmSeverity::ERROR, "MCU " + name_ + " set to faulty state");
     } else {
         logger_->info("MCU " + name_ + " set to normal state");
-        alarm_->clear("MCU " + name_ + " is back to normal");
+        alarm_->clear("faulty", "MCU " + name_ + " is back to normal");
     }
 }
 
@@ -65,6 +65,9 @@ bool MCUSimulator::initialize() {
             return false;
         }
 
+        // Drop a file level request left by an earlier run; the loggers start from their configured levels
+        mqtt_client_->publish(common::Logger::fileLevelTopic(), "", true);
+
         // Initialize logger and alarm for simulator
         logger_ = std::make_unique<common::Logger>(name_, log_level, mqtt_client_);
         alarm_ = std::make_unique<common::Alarm>(name_, mqtt_client_);
@@ -79,7 +82,7 @@ bool MCUSimulator::initialize() {
         // Validate and raise alarm if number of MCUs exceeds the maximum, however use first max number of MCUs
         if (mcu_config.size() > max_mcus) {
             logger_->error("Number of MCUs: " + std::to_string(mcu_config.size()) + " exceeds the maximum of " + std::to_string(max_mcus));
-            alarm_->raise(common::AlarmSeverity::HIGH, "Number of MCUs: " + std::to_string(mcu_config.size()) + " exceeds the maximum of " + std::to_string(max_mcus));
+            alarm_->raise("max_mcus", common::AlarmSeverity::ERROR, "Number of MCUs: " + std::to_string(mcu_config.size()) + " exceeds the maximum of " + std::to_string(max_mcus));
         }
         size_t mcu_count = 0;
         // Create MCUs based on configuration
@@ -96,7 +99,7 @@ bool MCUSimulator::initialize() {
             // Validate and raise alarm if number of sensors exceeds the maximum, however use first max number of sensors
             if (num_sensors > max_sensors_per_mcu) {
                 logger_->error("MCU " + mcu_name + " has " + std::to_string(num_sensors) + " sensors, but the maximum is " + std::to_string(max_sensors_per_mcu) + " using first " + std::to_string(max_sensors_per_mcu) + " sensors");
-                alarm_->raise(common::AlarmSeverity::HIGH, "MCU " + mcu_name + " has " + std::to_string(num_sensors) + " sensors, but the maximum is " + std::to_string(max_sensors_per_mcu) + " using first " + std::to_string(max_sensors_per_mcu) + " sensors");
+                alarm_->raise("max_sensors." + mcu_name, common::AlarmSeverity::ERROR, "MCU " + mcu_name + " has " + std::to_string(num_sensors) + " sensors, but the maximum is " + std::to_string(max_sensors_per_mcu) + " using first " + std::to_string(max_sensors_per_mcu) + " sensors");
             }
             num_sensors = std::min(num_sensors, max_sensors_per_mcu);
 
@@ -109,7 +112,7 @@ bool MCUSimulator::initialize() {
             auto mcu = std::make_unique<MCU>(mcu_name, num_sensors, temp_settings, mqtt_settings, mcu_data, config_file_);
             if (!mcu->initialize()) {
                 logger_->error("Failed to initialize MCU " + mcu_name);
-                alarm_->raise(common::AlarmSeverity::HIGH, "MCU initialization failed: " + mcu_name);
+                alarm_->raise("init_failed." + mcu_name, common::AlarmSeverity::ERROR, "MCU initialization failed: " + mcu_name);
                 return false;
             }
 
@@ -151,7 +154,7 @@ void MCUSimulator::start() {
             logger_->info("RPC server started successfully");
         } else {
             logger_->error("Failed to start RPC server");
-            alarm_->raise(common::AlarmSeverity::HIGH, "Failed to start RPC server");
+            alarm_->raise("rpc_server", common::AlarmSeverity::ERROR, "Failed to start RPC server");
         }
     }
 
@@ -230,4 +233,20 @@ MCU::TemperatureSettings MCUSimulator::loadTemperatureSettings(const YAML::Node&
     }
     return settings;
 }
+
+/**
+ * @brief Asks the owner of the log file to write messages down to a level
+ * 
+ * The log file is written by the fan control system's log manager, which
+ * filters what this process publishes. The request is published retained,
+ * so a log manager that starts later still picks it up.
+ * 
+ * @param level Lowest level the loggers of this process were set to
+ * @return true if the request was published, false otherwise
+ */
+bool MCUSimulator::requestFileLogLevel(common::LogLevel level) {
+    return mqtt_client_ && mqtt_client_->publish(common::Logger::fileLevelTopic(),
+                                                 common::Logger::levelToString(level), true);
+}
+
 } // namespace mcu_simulator 
\ No newline at end of file
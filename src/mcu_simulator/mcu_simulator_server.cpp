@@ -2,6 +2,8 @@
 #include "mcu_simulator/temperature_sensor.hpp"
 #include "common/config.hpp"
 #include "common/logger.hpp"
+#include "common/flight_recorder.hpp"
+#include <cctype>
 #include <iostream>
 
 namespace mcu_simulator {
@@ -305,6 +307,89 @@ grpc::Status MCUSimulatorServiceImpl::SetSensorNoise(grpc::ServerContext* contex
     }
 }
 
+/**
+ * @brief Handles SetLogLevel RPC requests
+ * 
+ * Changes the level of every logger with the requested name, or of all
+ * loggers in the process when the name is empty or "all". An empty level
+ * only lists the current levels. The log file is written by the fan control
+ * system, so the level is also forwarded there; it lowers its file level if
+ * that would hide the messages now emitted.
+ * 
+ * @param context gRPC server context
+ * @param request Log level request containing logger name and level
+ * @param response Response containing the level of every logger
+ * @return gRPC status indicating success or failure
+ */
+grpc::Status MCUSimulatorServiceImpl::SetLogLevel(grpc::ServerContext* context,
+                                                const SetLogLevelRequest* request,
+                                                SetLogLevelResponse* response) {
+    if (!request->level().empty()) {
+        common::LogLevel level;
+        if (!common::Logger::parseLevel(request->level(), level)) {
+            response->set_success(false);
+            response->set_message("Invalid log level: " + request->level());
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid log level");
+        }
+
+        size_t changed = common::Logger::setLevelByName(request->logger_name(), level);
+        if (changed == 0) {
+            response->set_success(false);
+            response->set_message("Logger not found: " + request->logger_name());
+            return grpc::Status(grpc::StatusCode::NOT_FOUND, "Logger not found");
+        }
+        bool forwarded = simulator_.requestFileLogLevel(level);
+        response->set_message("Log level set to " + request->level() + " for " +
+                              std::to_string(changed) + " logger(s)" +
+                              (forwarded ? "; log file level request sent to the fan control system"
+                                         : "; log file level request could not be sent, the log file may filter these messages"));
+    }
+
+    for (const auto& logger_level : common::Logger::listLevels()) {
+        auto* proto_level = response->add_loggers();
+        proto_level->set_name(logger_level.first);
+        proto_level->set_level(logger_level.second);
+    }
+    response->set_success(true);
+    return grpc::Status::OK;
+}
+
+/**
+ * @brief Handles DumpFlightRecorder RPC requests
+ * 
+ * Writes the in-memory flight recorder of the MCU simulator process to a file.
+ * 
+ * @param context gRPC server context
+ * @param request Dump request containing an optional reason
+ * @param response Response containing the dump file path and record count
+ * @return gRPC status indicating success or failure
+ */
+grpc::Status MCUSimulatorServiceImpl::DumpFlightRecorder(grpc::ServerContext* context,
+                                                 const DumpFlightRecorderRequest* request,
+                                                 DumpFlightRecorderResponse* response) {
+    // Keep the reason usable as part of a file name
+    std::string reason = request->reason().empty() ? "rpc" : request->reason();
+    for (auto& c : reason) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') {
+            c = '_';
+        }
+    }
+
+    std::string path;
+    size_t records = 0;
+    if (!common::FlightRecorder::getInstance().dump(reason.c_str(), true, &path, &records)) {
+        response->set_success(false);
+        response->set_message("Flight recorder is disabled or the dump failed");
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Flight recorder dump failed");
+    }
+
+    response->set_success(true);
+    response->set_message("Flight recorder dumped");
+    response->set_file_path(path);
+    response->set_record_count(static_cast<int32_t>(records));
+    return grpc::Status::OK;
+}
+
 // MCUSimulatorServer implementation
 MCUSimulatorServer::MCUSimulatorServer(MCUSimulator& simulator)
     : RPCServer("MCUSimulator", 